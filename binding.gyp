@@ -18,12 +18,32 @@
       'type': 'loadable_module',
       'sources': [
         'src/node_libcurl.cc',
+        'src/BufferPool.cc',
+        'src/BufferSource.cc',
+        'src/ByteBuffer.cc',
         'src/Easy.cc',
         'src/Share.cc',
         'src/Multi.cc',
         'src/Curl.cc',
+        'src/CurlConstantIndex.cc',
         'src/CurlHttpPost.cc',
+        'src/CurlMime.cc',
         'src/CurlVersionInfo.cc',
+        'src/Digest.cc',
+        'src/FileMapping.cc',
+        'src/FileSink.cc',
+        'src/FileSource.cc',
+        'src/HeaderList.cc',
+        'src/IsolateData.cc',
+        'src/OptionTemplate.cc',
+        'src/RingSink.cc',
+        'src/TextDecoding.cc',
+        'src/ThreadedMulti.cc',
+        'src/UploadQueue.cc',
+        'src/ViewContents.cc',
+        'src/HeaderParser.cc',
+        'src/JsonParseWorker.cc',
+        'src/JsonParser.cc',
       ],
       'include_dirs' : [
         "<!(node -e \"require('nan')\")",
@@ -6,6 +6,7 @@
  */
 import path from 'path'
 import { EventEmitter } from 'events'
+import { Readable } from 'stream'
 import { StringDecoder } from 'string_decoder'
 import assert from 'assert'
 
@@ -17,12 +18,15 @@ import binary from 'node-pre-gyp'
 import {
   NodeLibcurlNativeBinding,
   EasyNativeBinding,
+  CurlMimePart,
   FileInfo,
   HttpPostField,
 } from './types'
 
 import { Easy } from './Easy'
+import { HeaderList } from './HeaderList'
 import { Multi } from './Multi'
+import { OptionTemplate } from './OptionTemplate'
 import { Share } from './Share'
 import { mergeChunks } from './mergeChunks'
 import { parseHeaders, HeaderInfo } from './parseHeaders'
@@ -31,6 +35,8 @@ import {
   ProgressCallbackOptions,
   StringListOptions,
   CurlOptionName,
+  CurlOptionCamelCaseMap,
+  CurlOptionValueType,
   SpecificOptions,
 } from './generated/CurlOption'
 import { CurlInfoName } from './generated/CurlInfo'
@@ -40,7 +46,12 @@ import { CurlFeature } from './enum/CurlFeature'
 import { CurlGlobalInit } from './enum/CurlGlobalInit'
 import { CurlGssApi } from './enum/CurlGssApi'
 import { CurlPause } from './enum/CurlPause'
+import { CurlReadFunc } from './enum/CurlReadFunc'
 import { CurlSslOpt } from './enum/CurlSslOpt'
+import { EasyDigest } from './enum/EasyDigest'
+import { EasyHeaderMode } from './enum/EasyHeaderMode'
+import { EasyTextEncoding } from './enum/EasyTextEncoding'
+import { EasyWriteMode } from './enum/EasyWriteMode'
 
 const bindingPath = binary.find(
   path.resolve(path.join(__dirname, './../package.json')),
@@ -65,23 +76,87 @@ const decoder = new StringDecoder('utf8')
 const multiHandle = new Multi()
 const curlInstanceMap = new WeakMap<EasyNativeBinding, Curl>()
 
-multiHandle.onMessage((error, handle, errorCode) => {
-  multiHandle.removeHandle(handle)
+// the finished handles are removed by the addon, and delivered together
+multiHandle.onMessages((handles, errorCodes, errors) => {
+  for (let i = 0; i < handles.length; i++) {
+    const curlInstance = curlInstanceMap.get(handles[i])
 
-  const curlInstance = curlInstanceMap.get(handle)
+    // closed by the listeners of a handle that came before it
+    if (!curlInstance) {
+      continue
+    }
 
-  assert(
-    curlInstance,
-    'Could not retrieve curl instance from easy handle on onMessage callback',
-  )
+    const error = errors && errors[i]
 
-  if (error) {
-    curlInstance!.onError(error, errorCode)
-  } else {
-    curlInstance!.onEnd()
+    if (error) {
+      curlInstance.onError(error, errorCodes[i])
+    } else {
+      curlInstance.onEnd()
+    }
   }
 })
 
+// reads a stream used by a MIMEPOST part, the transfer is paused while it has no data
+const createStreamReader = (handle: EasyNativeBinding, stream: Readable) => {
+  let pending: Buffer | null = null
+  let isEnded = false
+  let hasFailed = false
+  let isPaused = false
+
+  const resume = () => {
+    if (isPaused) {
+      isPaused = false
+      // a receive pause set by the user must be kept
+      handle.pause(handle.pauseState & ~CurlPause.Send)
+    }
+  }
+  const onEnd = () => {
+    isEnded = true
+    resume()
+  }
+  const onError = () => {
+    hasFailed = true
+    resume()
+  }
+
+  stream.on('readable', resume)
+  stream.once('end', onEnd)
+  stream.once('error', onError)
+
+  const read = (data: Buffer) => {
+    if (hasFailed) {
+      return CurlReadFunc.Abort
+    }
+
+    if (!pending) {
+      const chunk: Buffer | string | null = stream.read()
+      pending = typeof chunk === 'string' ? Buffer.from(chunk) : chunk
+    }
+
+    if (!pending) {
+      if (isEnded) {
+        return 0
+      }
+
+      isPaused = true
+      return CurlReadFunc.Pause
+    }
+
+    const length = pending.copy(data)
+    pending = length < pending.length ? pending.slice(length) : null
+
+    return length
+  }
+
+  const cleanup = () => {
+    stream.removeListener('readable', resume)
+    stream.removeListener('end', onEnd)
+    stream.removeListener('error', onError)
+  }
+
+  return { read, cleanup }
+}
+
 /**
  * Wrapper around {@link Easy} class with a more *nodejs-friendly* interface.
  *
@@ -202,6 +277,16 @@ class Curl extends EventEmitter {
 
   protected features: CurlFeature
 
+  /**
+   * Removes the listeners added to the stream set with `setUploadStream`
+   */
+  protected uploadStreamCleanup: (() => void) | null
+
+  /**
+   * Removes the listeners added to the streams of the `MIMEPOST` parts
+   */
+  protected mimePostStreamsCleanup: (() => void) | null
+
   /**
    * Whether this instance is running or not (called perform())
    */
@@ -233,6 +318,9 @@ class Curl extends EventEmitter {
 
     this.features = 0
 
+    this.uploadStreamCleanup = null
+    this.mimePostStreamsCleanup = null
+
     this.isRunning = false
 
     curlInstanceMap.set(handle, this)
@@ -286,15 +374,32 @@ class Curl extends EventEmitter {
       !(this.features & CurlFeature.NoHeaderParsing) && isHeaderStorageEnabled
     const isDataParsingEnabled =
       !(this.features & CurlFeature.NoDataParsing) && isDataStorageEnabled
+    const isNativeDataStorageEnabled =
+      !!(this.features & CurlFeature.NativeDataStorage) && isDataStorageEnabled
+    const isNativeHeaderParsingEnabled =
+      !!(this.features & CurlFeature.NativeHeaderParsing) &&
+      isHeaderParsingEnabled
+    const isNativeJsonParsingEnabled =
+      !!(this.features & CurlFeature.NativeJsonParsing) && isDataParsingEnabled
 
     this.isRunning = false
 
-    const dataRaw = isDataStorageEnabled
+    // data parsed natively is only taken from the handle later on
+    const isDataParsedNatively =
+      isNativeJsonParsingEnabled ||
+      (isNativeDataStorageEnabled && isDataParsingEnabled)
+
+    const dataRaw = isDataParsedNatively
+      ? Buffer.alloc(0)
+      : isNativeDataStorageEnabled
+      ? this.handle.takeCollectedData()
+      : isDataStorageEnabled
       ? mergeChunks(this.chunks, this.chunksLength)
       : Buffer.alloc(0)
-    const headersRaw = isHeaderStorageEnabled
-      ? mergeChunks(this.headerChunks, this.headerChunksLength)
-      : Buffer.alloc(0)
+    const headersRaw =
+      isHeaderStorageEnabled && !isNativeHeaderParsingEnabled
+        ? mergeChunks(this.headerChunks, this.headerChunksLength)
+        : Buffer.alloc(0)
 
     this.chunks = []
     this.chunksLength = 0
@@ -302,8 +407,9 @@ class Curl extends EventEmitter {
     this.headerChunks = []
     this.headerChunksLength = 0
 
-    const data = isDataParsingEnabled ? decoder.write(dataRaw) : dataRaw
-    const headers = isHeaderParsingEnabled
+    const headers = isNativeHeaderParsingEnabled
+      ? this.handle.takeParsedHeaders()
+      : isHeaderParsingEnabled
       ? parseHeaders(decoder.write(headersRaw))
       : headersRaw
 
@@ -312,9 +418,29 @@ class Curl extends EventEmitter {
     if (code !== CurlCode.CURLE_OK) {
       const error = new Error('Could not get status code of request')
       this.emit('error', error, code, this)
-    } else {
-      this.emit('end', status, data, headers, this)
+      return
     }
+
+    if (isNativeJsonParsingEnabled) {
+      // the handle may be used again before the callback is called, that is fine,
+      //  the body was already moved out of it.
+      this.handle.takeCollectedDataAsJson((error, value) => {
+        if (error) {
+          this.emit('error', error, CurlCode.CURLE_WRITE_ERROR, this)
+        } else {
+          this.emit('end', status, value, headers, this)
+        }
+      })
+      return
+    }
+
+    const data = !isDataParsingEnabled
+      ? dataRaw
+      : isNativeDataStorageEnabled
+      ? this.handle.takeCollectedDataAsString(EasyTextEncoding.Utf8)
+      : decoder.write(dataRaw)
+
+    this.emit('end', status, data, headers, this)
   }
 
   /**
@@ -368,6 +494,11 @@ class Curl extends EventEmitter {
       !optionValue
     ) {
       value = this.defaultHeaderFunction.bind(this) as never
+    } else if (
+      optionIdOrName === Curl.option.MIMEPOST ||
+      optionIdOrName === 'MIMEPOST'
+    ) {
+      value = this.prepareMimePost(optionValue) as never
     }
 
     const code = this.handle.setOpt(optionIdOrName, value)
@@ -383,6 +514,90 @@ class Curl extends EventEmitter {
     return this
   }
 
+  /**
+   * Sets multiple options at once, this is faster than calling `setOpt` for each one of them,
+   *  as all of them are set with a single call into the addon.
+   *
+   * The options can be an object, where the keys are the options names, in upper or camel case,
+   *  or an array of `[option, value]` pairs, which are set in the given order.
+   *
+   * If libcurl rejects one of the options an error is thrown, like with `setOpt`,
+   *  and the options after it are not set.
+   */
+  setOpts(
+    options: CurlOptionValueType | [CurlOptionName | number, unknown][],
+  ): this {
+    let pairs: [CurlOptionName | number, unknown][]
+
+    if (Array.isArray(options)) {
+      pairs = options.map((pair): [CurlOptionName | number, unknown] => [
+        pair[0],
+        pair[1],
+      ])
+    } else {
+      const optionsObject = options
+      pairs = Object.keys(optionsObject).map((key): [
+        CurlOptionName,
+        unknown,
+      ] => [
+        key in CurlOptionCamelCaseMap
+          ? CurlOptionCamelCaseMap[key as keyof typeof CurlOptionCamelCaseMap]
+          : (key as CurlOptionName),
+        optionsObject[key as keyof CurlOptionValueType],
+      ])
+    }
+
+    // same special case for WRITEFUNCTION and HEADERFUNCTION than in setOpt
+    for (const pair of pairs) {
+      if (
+        (pair[0] === Curl.option.WRITEFUNCTION ||
+          pair[0] === 'WRITEFUNCTION') &&
+        !pair[1]
+      ) {
+        pair[1] = this.defaultWriteFunction.bind(this)
+      } else if (
+        (pair[0] === Curl.option.HEADERFUNCTION ||
+          pair[0] === 'HEADERFUNCTION') &&
+        !pair[1]
+      ) {
+        pair[1] = this.defaultHeaderFunction.bind(this)
+      } else if (
+        pair[0] === Curl.option.MIMEPOST ||
+        pair[0] === 'MIMEPOST'
+      ) {
+        pair[1] = this.prepareMimePost(pair[1] as CurlMimePart[] | null)
+      }
+    }
+
+    const result = this.handle.setOpts(pairs)
+
+    if (result) {
+      throw new Error(
+        result.code === CurlCode.CURLE_UNKNOWN_OPTION
+          ? `Unknown option given: ${result.option}. You can use the Curl.option constants.`
+          : `${result.option}: ${Easy.strError(result.code)}`,
+      )
+    }
+
+    return this
+  }
+
+  /**
+   * Sets all options of the given template, see `OptionTemplate`.
+   *
+   * If libcurl rejects one of the options an error is thrown, like with `setOpt`,
+   *  and the options after it are not set.
+   */
+  applyTemplate(optionTemplate: OptionTemplate): this {
+    const result = this.handle.applyTemplate(optionTemplate)
+
+    if (result) {
+      throw new Error(`${result.option}: ${Easy.strError(result.code)}`)
+    }
+
+    return this
+  }
+
   /**
    * Use `Curl.info` for predefined constants.
    * Official libcurl documentation: [curl_easy_getinfo()](http://curl.haxx.se/libcurl/c/curl_easy_getinfo.html)
@@ -397,6 +612,143 @@ class Curl extends EventEmitter {
     return data
   }
 
+  /**
+   * Uploads the given data without calling `READFUNCTION`, it is served straight from their memory.
+   *
+   * See `Easy.setUploadBuffer`
+   */
+  setUploadBuffer(data: ArrayBufferView | ArrayBufferView[] | null) {
+    this.handle.setUploadBuffer(data)
+
+    return this
+  }
+
+  /**
+   * Uploads the given file, which is memory mapped, without calling `READFUNCTION`.
+   *
+   * See `Easy.setUploadFile`
+   */
+  setUploadFile(file: string | number | null) {
+    this.handle.setUploadFile(file)
+
+    return this
+  }
+
+  /**
+   * Uploads the data read from the given stream, without calling `READFUNCTION`.
+   * The stream is paused while `highWaterMark` bytes are waiting to be sent.
+   *
+   * If the stream emits an error the request fails with `CURLE_ABORTED_BY_CALLBACK`.
+   *
+   * See `Easy.setUploadQueue`
+   */
+  setUploadStream(stream: Readable | null, highWaterMark = 64 * 1024) {
+    this.removeUploadStreamListeners()
+
+    if (!stream) {
+      this.handle.setUploadQueue(null)
+
+      return this
+    }
+
+    const handle = this.handle
+
+    const onData = (chunk: Buffer | string) => {
+      const isFull = !handle.writeUploadQueue(
+        typeof chunk === 'string' ? Buffer.from(chunk) : chunk,
+      )
+
+      if (isFull) {
+        stream.pause()
+      }
+    }
+    const onEnd = () => handle.endUploadQueue()
+    const onError = () => handle.endUploadQueue(true)
+
+    handle.setUploadQueue(highWaterMark, highWaterMark / 2, () => {
+      stream.resume()
+    })
+
+    stream.on('data', onData)
+    stream.once('end', onEnd)
+    stream.once('error', onError)
+
+    this.uploadStreamCleanup = () => {
+      stream.removeListener('data', onData)
+      stream.removeListener('end', onEnd)
+      stream.removeListener('error', onError)
+    }
+
+    return this
+  }
+
+  protected removeUploadStreamListeners() {
+    if (this.uploadStreamCleanup) {
+      this.uploadStreamCleanup()
+      this.uploadStreamCleanup = null
+    }
+
+    if (this.mimePostStreamsCleanup) {
+      this.mimePostStreamsCleanup()
+      this.mimePostStreamsCleanup = null
+    }
+  }
+
+  /**
+   * Replaces the stream parts of the given form with parts read from a callback.
+   */
+  protected prepareMimePost(parts: CurlMimePart[] | null) {
+    if (this.mimePostStreamsCleanup) {
+      this.mimePostStreamsCleanup()
+      this.mimePostStreamsCleanup = null
+    }
+
+    if (!Array.isArray(parts)) {
+      return parts
+    }
+
+    const cleanups: (() => void)[] = []
+
+    const result = parts.map(part => {
+      if (!part || !('stream' in part)) {
+        return part
+      }
+
+      const { stream, ...rest } = part
+      const reader = createStreamReader(this.handle, stream)
+
+      cleanups.push(reader.cleanup)
+
+      return { ...rest, read: reader.read }
+    })
+
+    if (cleanups.length) {
+      this.mimePostStreamsCleanup = () =>
+        cleanups.forEach(cleanup => cleanup())
+    }
+
+    return result
+  }
+
+  /**
+   * Enables the given digests, which are computed natively while the body is received.
+   * Use `getDigest` to retrieve them after the request finishes.
+   *
+   * Multiple values of `EasyDigest` can be combined with `|`.
+   */
+  setDigests(digests: EasyDigest | number) {
+    this.handle.setDigests(digests)
+
+    return this
+  }
+
+  /**
+   * Returns the digest of the body received by the last request, as a lowercase hex string.
+   */
+  getDigest(digest: EasyDigest) {
+    return this.handle.getDigest(digest)
+  }
+
   /**
    * The option XFERINFOFUNCTION was introduced in curl version 7.32.0,
    *  versions older than that should use PROGRESSFUNCTION.
@@ -436,6 +788,28 @@ class Curl extends EventEmitter {
 
     this.isRunning = true
 
+    const isNativeJsonParsingEnabled =
+      this.features & CurlFeature.NativeJsonParsing &&
+      !(this.features & CurlFeature.NoDataParsing)
+
+    this.handle.setWriteMode(
+      (this.features & CurlFeature.NativeDataStorage ||
+        isNativeJsonParsingEnabled) &&
+        !(this.features & CurlFeature.NoDataStorage)
+        ? EasyWriteMode.Collect
+        : this.features & CurlFeature.CoalesceData
+        ? EasyWriteMode.Coalesce
+        : EasyWriteMode.Callback,
+    )
+    this.handle.setBufferPooling(!!(this.features & CurlFeature.BufferPooling))
+    this.handle.setHeaderMode(
+      this.features & CurlFeature.NativeHeaderParsing &&
+        !(this.features & CurlFeature.NoHeaderParsing) &&
+        !(this.features & CurlFeature.NoHeaderStorage)
+        ? EasyHeaderMode.Parse
+        : EasyHeaderMode.Callback,
+    )
+
     multiHandle.addHandle(this.handle)
 
     return this
@@ -476,6 +850,7 @@ class Curl extends EventEmitter {
    */
   reset() {
     this.removeAllListeners()
+    this.removeUploadStreamListeners()
     this.handle.reset()
 
     // add callbacks back as reset will remove them
@@ -533,6 +908,8 @@ class Curl extends EventEmitter {
     this.handle.setOpt(Curl.option.WRITEFUNCTION, null)
     this.handle.setOpt(Curl.option.HEADERFUNCTION, null)
 
+    this.removeUploadStreamListeners()
+
     this.handle.close()
   }
 }
@@ -601,7 +978,7 @@ interface Curl {
    *
    * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
-  setOpt(option: StringListOptions, value: string[] | null): this
+  setOpt(option: StringListOptions, value: string[] | HeaderList | null): this
   /**
    * Use `Curl.option` for predefined constants.
    *
@@ -665,6 +1042,18 @@ interface Curl {
    * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
   setOpt(option: 'HTTPPOST', value: HttpPostField[] | null): this
+  /**
+   * Use `Curl.option` for predefined constants.
+   *
+   * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
+   */
+  setOpt(option: 'MIMEPOST', value: CurlMimePart[] | null): this
+  /**
+   * Use `Curl.option` for predefined constants.
+   *
+   * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
+   */
+  setOpt(option: 'POSTFIELDS', value: string | ArrayBufferView | null): this
   /**
    * Use `Curl.option` for predefined constants.
    *
@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import path from 'path'
+
+// tslint:disable-next-line
+import binary from 'node-pre-gyp'
+
+import { NodeLibcurlNativeBinding } from './types'
+
+const bindingPath = binary.find(
+  path.resolve(path.join(__dirname, './../package.json')),
+)
+
+const bindings: NodeLibcurlNativeBinding = require(bindingPath)
+
+/**
+ * Immutable list of strings, converted to a `curl_slist` only once, which can be used
+ *  as the value of the list options, like `HTTPHEADER`, on any number of handles.
+ *
+ * Use `extend` to add lines for a single request, without copying the ones already in the list.
+ *
+ * @public
+ */
+class HeaderList extends bindings.HeaderList {}
+
+export { HeaderList }
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import os from 'os'
+
+import { CurlCode, CurlMultiCode } from './enum/CurlCode'
+import { CurlShareLock } from './enum/CurlShareLock'
+import { CurlShareOption } from './enum/CurlShareOption'
+import { EasyNativeBinding } from './types'
+import { Share } from './Share'
+import { ThreadedMulti } from './ThreadedMulti'
+
+/**
+ * How `MultiPool` chooses the thread of a new transfer.
+ *
+ * @public
+ */
+export type MultiPoolStrategy = 'leastLoaded' | 'host'
+
+/**
+ * @public
+ */
+export interface MultiPoolOptions {
+  /**
+   * Number of threads, each one with its own `ThreadedMulti`.
+   *
+   * Defaults to the number of CPUs.
+   */
+  threads?: number
+
+  /**
+   * - `leastLoaded`: the thread with the fewest transfers is used. This is the default.
+   * - `host`: transfers to the same host always use the same thread, so its connections are
+   *  reused. The host must be given to `addHandle`,
+   *  otherwise the least loaded thread is used.
+   */
+  strategy?: MultiPoolStrategy
+
+  /**
+   * Data shared by the transfers of all threads.
+   *
+   * Defaults to the DNS cache and the SSL sessions. libcurl does not support sharing the
+   *  connection cache between threads, use the `host` strategy to reuse connections instead.
+   */
+  share?: CurlShareLock[]
+}
+
+/**
+ * Callback called on the main thread when the transfer of a handle finishes.
+ *
+ * @public
+ */
+export type MultiPoolMessageCallback = (
+  error: Error | null,
+  easyHandle: EasyNativeBinding,
+  errorCode: CurlCode,
+) => void
+
+/**
+ * Pool of `ThreadedMulti` instances, each one running its transfers on its own thread,
+ *  so they are spread across multiple cores.
+ *
+ * The handles added to the pool use a single `Share`, with the DNS cache and SSL sessions
+ *  shared by all threads.
+ *
+ * The same restrictions of `ThreadedMulti.addHandle` apply to the handles added here.
+ *
+ * Requires libcurl 7.68.0 or newer.
+ *
+ * @public
+ */
+class MultiPool {
+  /**
+   * Share used by all handles added to this pool.
+   */
+  readonly share: Share
+
+  protected shards: ThreadedMulti[]
+  protected strategy: MultiPoolStrategy
+  protected handleShards = new Map<EasyNativeBinding, ThreadedMulti>()
+  protected onMessageCallback: MultiPoolMessageCallback | null = null
+
+  constructor(options: MultiPoolOptions = {}) {
+    const {
+      threads = os.cpus().length,
+      strategy = 'leastLoaded',
+      share = [CurlShareLock.DataDns, CurlShareLock.DataSslSession],
+    } = options
+
+    if (!Number.isInteger(threads) || threads < 1) {
+      throw new TypeError('The number of threads must be a positive integer.')
+    }
+
+    this.strategy = strategy
+
+    this.share = new Share()
+
+    for (const data of share) {
+      this.share.setOpt(CurlShareOption.SHARE, data)
+    }
+
+    this.shards = []
+
+    for (let i = 0; i < threads; i++) {
+      const shard = new ThreadedMulti()
+      shard.onMessage(this.handleMessage)
+
+      this.shards.push(shard)
+    }
+  }
+
+  /**
+   * Adds an easy handle, its transfer is started right away on one of the threads.
+   *
+   * The `SHARE` option of the handle is set to the share of this pool.
+   *
+   * `host` is used by the `host` strategy to choose the thread.
+   */
+  addHandle(handle: EasyNativeBinding, host?: string): CurlMultiCode {
+    if (this.handleShards.has(handle)) {
+      throw new Error('Easy handle is already inside this pool.')
+    }
+
+    const shard = this.chooseShard(host)
+
+    handle.setOpt('SHARE', this.share)
+
+    try {
+      const code = shard.addHandle(handle)
+
+      this.handleShards.set(handle, shard)
+
+      return code
+    } catch (error) {
+      handle.setOpt('SHARE', null)
+      throw error
+    }
+  }
+
+  /**
+   * Removes an easy handle that was added to this pool, see `ThreadedMulti.removeHandle`.
+   */
+  removeHandle(handle: EasyNativeBinding): CurlMultiCode {
+    const shard = this.handleShards.get(handle)
+
+    if (!shard) {
+      throw new Error('Easy handle is not inside this pool.')
+    }
+
+    this.handleShards.delete(handle)
+
+    return shard.removeHandle(handle)
+  }
+
+  /**
+   * Callback called when the transfer of a handle finishes, on any of the threads.
+   *
+   * Pass `null` to remove the current callback set
+   */
+  onMessage(cb: MultiPoolMessageCallback | null) {
+    this.onMessageCallback = cb
+
+    return this
+  }
+
+  /**
+   * Returns the number of easy handles that are inside this pool
+   */
+  getCount() {
+    return this.shards.reduce((count, shard) => count + shard.getCount(), 0)
+  }
+
+  /**
+   * Number of easy handles inside each thread of this pool
+   */
+  getCounts() {
+    return this.shards.map(shard => shard.getCount())
+  }
+
+  /**
+   * Stops all threads.
+   *
+   * The handles still inside this pool are removed, without `onMessage` being called for them.
+   *
+   * The share is not closed, the handles keep using it until they are closed,
+   *  or their `SHARE` option is changed.
+   */
+  close() {
+    for (const shard of this.shards) {
+      shard.close()
+    }
+
+    this.handleShards.clear()
+  }
+
+  protected chooseShard(host?: string) {
+    if (this.strategy === 'host' && host) {
+      return this.shards[hashString(host.toLowerCase()) % this.shards.length]
+    }
+
+    let chosen = this.shards[0]
+    let chosenCount = chosen.getCount()
+
+    for (let i = 1; i < this.shards.length && chosenCount > 0; i++) {
+      const count = this.shards[i].getCount()
+
+      if (count < chosenCount) {
+        chosen = this.shards[i]
+        chosenCount = count
+      }
+    }
+
+    return chosen
+  }
+
+  protected handleMessage = (
+    error: Error | null,
+    handle: EasyNativeBinding,
+    errorCode: CurlCode,
+  ) => {
+    // removed handles are not in the map anymore
+    this.handleShards.delete(handle)
+
+    if (this.onMessageCallback) {
+      this.onMessageCallback(error, handle, errorCode)
+    }
+  }
+}
+
+// FNV-1a, only used to spread the hosts across the threads
+const hashString = (value: string) => {
+  let hash = 0x811c9dc5
+
+  for (let i = 0; i < value.length; i++) {
+    hash ^= value.charCodeAt(i)
+    hash = Math.imul(hash, 0x01000193)
+  }
+
+  return hash >>> 0
+}
+
+export { MultiPool }
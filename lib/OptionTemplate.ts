@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import path from 'path'
+
+// tslint:disable-next-line
+import binary from 'node-pre-gyp'
+
+import { NodeLibcurlNativeBinding } from './types'
+import {
+  CurlOptionName,
+  CurlOptionCamelCaseMap,
+  CurlOptionValueType,
+} from './generated/CurlOption'
+
+const bindingPath = binary.find(
+  path.resolve(path.join(__dirname, './../package.json')),
+)
+
+const bindings: NodeLibcurlNativeBinding = require(bindingPath)
+
+/**
+ * Immutable set of options, which can be applied to many handles with `Easy.applyTemplate`
+ *  or `Curl.applyTemplate`.
+ *
+ * The values are converted to the format used by libcurl only once, when the template is created,
+ *  so this is cheaper than setting the same options on each handle.
+ *
+ * Only options whose value is a string, a number or an array of strings, like `HTTPHEADER`, can be used.
+ *
+ * @public
+ */
+class OptionTemplate extends bindings.OptionTemplate {
+  /**
+   * The options can be an object, where the keys are the options names, in upper or camel case,
+   *  or an array of `[option, value]` pairs, which are set in the given order.
+   */
+  constructor(
+    options: CurlOptionValueType | [CurlOptionName | number, unknown][],
+  ) {
+    super(
+      Array.isArray(options)
+        ? options
+        : Object.keys(options).map((key): [CurlOptionName, unknown] => [
+            key in CurlOptionCamelCaseMap
+              ? CurlOptionCamelCaseMap[
+                  key as keyof typeof CurlOptionCamelCaseMap
+                ]
+              : (key as CurlOptionName),
+            (options as CurlOptionValueType)[key as keyof CurlOptionValueType],
+          ]),
+    )
+  }
+}
+
+export { OptionTemplate }
@@ -0,0 +1,34 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import path from 'path'
+
+// tslint:disable-next-line
+import binary from 'node-pre-gyp'
+
+import { NodeLibcurlNativeBinding } from './types'
+
+const bindingPath = binary.find(
+  path.resolve(path.join(__dirname, './../package.json')),
+)
+
+const bindings: NodeLibcurlNativeBinding = require(bindingPath)
+
+/**
+ * Multi handle that runs the transfers on its own native thread, using `curl_multi_poll`,
+ *  instead of the Node.js event loop.
+ *
+ * The socket I/O, TLS and decompression done by libcurl do not use the main thread,
+ *  which is only woken up when a transfer finishes. Multiple instances can be used to spread
+ *  the transfers across multiple cores.
+ *
+ * Requires libcurl 7.68.0 or newer.
+ *
+ * @public
+ */
+class ThreadedMulti extends bindings.ThreadedMulti {}
+
+export { ThreadedMulti }
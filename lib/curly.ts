@@ -13,6 +13,7 @@ import {
 import { HeaderInfo } from './parseHeaders'
 
 import { Curl } from './Curl'
+import { CurlFeature } from './enum/CurlFeature'
 
 /**
  * Object the curly call resolves to.
@@ -112,6 +113,9 @@ const create = (): CurlyFunction => {
 
     curlHandle.setOpt('URL', url)
 
+    let hasWriteFunction = false
+    let hasHeaderFunction = false
+
     for (const key of Object.keys(options)) {
       const keyTyped = key as keyof CurlOptionValueType
 
@@ -122,8 +126,25 @@ const create = (): CurlyFunction => {
             ]
           : (keyTyped as CurlOptionName)
 
-      // @ts-ignore @TODO Try to type this
-      curlHandle.setOpt(optionName, options[key])
+      if (optionName === 'WRITEFUNCTION' && options[keyTyped]) {
+        hasWriteFunction = true
+      }
+
+      if (optionName === 'HEADERFUNCTION' && options[keyTyped]) {
+        hasHeaderFunction = true
+      }
+    }
+
+    // all options are set with a single call into the addon
+    curlHandle.setOpts(options)
+
+    // the body is only needed at the end, so there is no need to call into js for each chunk
+    if (!hasWriteFunction) {
+      curlHandle.enable(CurlFeature.NativeDataStorage)
+    }
+
+    if (!hasHeaderFunction) {
+      curlHandle.enable(CurlFeature.NativeHeaderParsing)
     }
 
     return new Promise((resolve, reject) => {
@@ -38,4 +38,37 @@ export enum CurlFeature {
    * Same than `NoDataStorage | NoHeaderStorage`, implies RAW.
    */
   NoStorage = NoDataStorage | NoHeaderStorage,
+
+  /**
+   * Data received is stored natively and passed to the end event at once,
+   *  the `data` event is not emitted and `WRITEFUNCTION` is not called.
+   * Has no effect if NO_DATA_STORAGE is also enabled.
+   */
+  NativeDataStorage = 1 << 4,
+
+  /**
+   * Buffers passed to the `data` and `header` events are backed by pooled native memory,
+   *  which is reused after they are garbage collected.
+   */
+  BufferPooling = 1 << 5,
+
+  /**
+   * Data received while processing a single socket event is emitted with a single `data` event,
+   *  instead of one event per chunk. Has no effect if NATIVE_DATA_STORAGE is enabled.
+   */
+  CoalesceData = 1 << 6,
+
+  /**
+   * Headers received are parsed natively and passed to the end event at once,
+   *  the `header` event is not emitted and `HEADERFUNCTION` is not called.
+   * Has no effect if NO_HEADER_PARSING or NO_HEADER_STORAGE is also enabled.
+   */
+  NativeHeaderParsing = 1 << 7,
+
+  /**
+   * Data received is stored natively and parsed as JSON outside the main thread,
+   *  the parsed value is passed to the end event instead of a string.
+   * Has no effect if NO_DATA_PARSING or NO_DATA_STORAGE is also enabled.
+   */
+  NativeJsonParsing = 1 << 8,
 }
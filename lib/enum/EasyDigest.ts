@@ -0,0 +1,22 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+/**
+ * Digests that can be computed natively while the body is received, to be used with `Easy.setDigests`
+ *
+ * Multiple values can be combined with `|`, `Easy.getDigest` accepts a single one.
+ *
+ * @public
+ */
+export enum EasyDigest {
+  Md5 = 1 << 0,
+  Sha1 = 1 << 1,
+  Sha256 = 1 << 2,
+  /**
+   * CRC-32C (Castagnoli), the hex string is the big endian representation of the value.
+   */
+  Crc32c = 1 << 3,
+}
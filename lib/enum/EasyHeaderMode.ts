@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+/**
+ * What an `Easy` handle does with the header lines it receives, to be used with `Easy.setHeaderMode`
+ *
+ * @public
+ */
+export enum EasyHeaderMode {
+  /**
+   * Each line is passed to the `HEADERFUNCTION` callback. This is the default.
+   */
+  Callback = 0,
+
+  /**
+   * Lines are parsed natively, `HEADERFUNCTION` is not called.
+   * The parsed headers can be retrieved with `Easy.takeParsedHeaders` after the transfer finishes.
+   */
+  Parse = 1,
+}
@@ -0,0 +1,22 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+/**
+ * How the body is decoded by `Easy.takeCollectedDataAsString`
+ *
+ * @public
+ */
+export enum EasyTextEncoding {
+  /**
+   * Invalid sequences are replaced with U+FFFD, like `StringDecoder` does. This is the default.
+   */
+  Utf8 = 0,
+
+  /**
+   * Each byte is a character, this never fails.
+   */
+  Latin1 = 1,
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+/**
+ * What an `Easy` handle does with the body data it receives, to be used with `Easy.setWriteMode`
+ *
+ * @public
+ */
+export enum EasyWriteMode {
+  /**
+   * Each chunk is passed to the `WRITEFUNCTION` callback. This is the default.
+   */
+  Callback = 0,
+
+  /**
+   * Chunks are stored natively, `WRITEFUNCTION` is not called.
+   * The whole body can be retrieved with `Easy.takeCollectedData` after the transfer finishes.
+   */
+  Collect = 1,
+
+  /**
+   * Chunks received while processing a single socket event are concatenated and passed
+   *  to the `WRITEFUNCTION` callback at once, using `1` for `size` and the data length for `nmemb`.
+   *
+   * Returning `CurlWriteFunc.Pause` pauses the transfer, and returning anything other than the data length
+   *  makes the transfer fail with `CURLE_WRITE_ERROR`.
+   */
+  Coalesce = 2,
+}
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+/**
+ * Indexes of the int32 values at the start of the SharedArrayBuffer passed to `Easy.setWriteRing`.
+ *
+ * The header takes 16 bytes, the ring data starts right after it.
+ *
+ * @public
+ */
+export enum EasyWriteRingIndex {
+  /**
+   * Total bytes written to the ring, wraps around at 2^32. Only written by the addon.
+   */
+  Head = 0,
+
+  /**
+   * Total bytes read from the ring, wraps around at 2^32. Only written by the consumer.
+   */
+  Tail = 1,
+
+  /**
+   * `0` while the transfer is running, `1` after it finishes, `2` if the handle stopped writing
+   * to the ring before that, because it was removed from its `Multi` instance, closed or reset,
+   * or the ring was replaced. The consumer is notified in all cases.
+   */
+  State = 2,
+
+  /**
+   * Must be set to `1` by the consumer before calling `Atomics.wait` on the `Head`,
+   * and to `0` after, the addon only calls `Atomics.notify` when it is set.
+   */
+  Waiting = 3,
+}
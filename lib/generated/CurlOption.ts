@@ -9,6 +9,7 @@
 
 import { CurlGssApi } from '../enum/CurlGssApi'
 import { CurlSslOpt } from '../enum/CurlSslOpt'
+import { HeaderList } from '../HeaderList'
 import { Share } from '../Share'
 
 /**
@@ -1625,6 +1626,13 @@ export interface CurlOption {
    */
   readonly WILDCARDMATCH: 'WILDCARDMATCH'
 
+  /**
+   * Data pointer to pass to the write callback.
+   *
+   * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html](https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html)
+   */
+  readonly WRITEDATA: 'WRITEDATA'
+
   /**
    * Callback for writing data.
    *
@@ -3258,6 +3266,13 @@ export const CurlOptionCamelCaseMap = {
    */
   wildcardMatch: 'WILDCARDMATCH',
 
+  /**
+   * Data pointer to pass to the write callback.
+   *
+   * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html](https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html)
+   */
+  writeData: 'WRITEDATA',
+
   /**
    * Callback for writing data.
    *
@@ -3514,10 +3529,11 @@ export type CurlOptionName =
   | 'USERPWD'
   | 'VERBOSE'
   | 'WILDCARDMATCH'
+  | 'WRITEDATA'
   | 'WRITEFUNCTION'
   | 'XFERINFOFUNCTION'
   | 'XOAUTH2_BEARER'
-import { FileInfo, HttpPostField } from '../types'
+import { FileInfo, HttpPostField, MimePart } from '../types'
 export type DataCallbackOptions =
   | 'READFUNCTION'
   | 'HEADERFUNCTION'
@@ -3546,6 +3562,8 @@ export type SpecificOptions =
   | 'TRAILERFUNCTION'
   | 'SHARE'
   | 'HTTPPOST'
+  | 'MIMEPOST'
+  | 'POSTFIELDS'
   | 'GSSAPI_DELEGATION'
   | 'PROXY_SSL_OPTIONS'
   | 'SSL_OPTIONS'
@@ -3768,14 +3786,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html](https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html)
    */
-  CONNECT_TO?: string[] | null
+  CONNECT_TO?: string[] | HeaderList | null
 
   /**
    * Connect to a specific host and port.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html](https://curl.haxx.se/libcurl/c/CURLOPT_CONNECT_TO.html)
    */
-  connectTo?: string[] | null
+  connectTo?: string[] | HeaderList | null
 
   /**
    * Timeout for the connection phase.
@@ -4514,14 +4532,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html)
    */
-  HTTP200ALIASES?: string[] | null
+  HTTP200ALIASES?: string[] | HeaderList | null
 
   /**
    * Alternative versions of 200 OK.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTP200ALIASES.html)
    */
-  http200aliases?: string[] | null
+  http200aliases?: string[] | HeaderList | null
 
   /**
    * HTTP server authentication methods.
@@ -4556,14 +4574,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html)
    */
-  HTTPHEADER?: string[] | null
+  HTTPHEADER?: string[] | HeaderList | null
 
   /**
    * Custom HTTP headers.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_HTTPHEADER.html)
    */
-  httpHeader?: string[] | null
+  httpHeader?: string[] | HeaderList | null
 
   /**
    * Multipart formpost HTTP POST.
@@ -4822,14 +4840,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html](https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html)
    */
-  MAIL_RCPT?: string[] | null
+  MAIL_RCPT?: string[] | HeaderList | null
 
   /**
    * Address of the recipients.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html](https://curl.haxx.se/libcurl/c/CURLOPT_MAIL_RCPT.html)
    */
-  mailRcpt?: string[] | null
+  mailRcpt?: string[] | HeaderList | null
 
   /**
    * Cap the download speed to this.
@@ -4934,14 +4952,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_MIMEPOST.html](https://curl.haxx.se/libcurl/c/CURLOPT_MIMEPOST.html)
    */
-  MIMEPOST?: string | number | boolean | null
+  MIMEPOST?: MimePart[] | null
 
   /**
    * Post/send MIME data.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_MIMEPOST.html](https://curl.haxx.se/libcurl/c/CURLOPT_MIMEPOST.html)
    */
-  mimePost?: string | number | boolean | null
+  mimePost?: MimePart[] | null
 
   /**
    * Enable .netrc parsing.
@@ -5144,14 +5162,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html)
    */
-  POSTFIELDS?: string | number | boolean | null
+  POSTFIELDS?: string | ArrayBufferView | null
 
   /**
    * Send a POST with this data.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTFIELDS.html)
    */
-  postFields?: string | number | boolean | null
+  postFields?: string | ArrayBufferView | null
 
   /**
    * The POST data is this big.
@@ -5186,14 +5204,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html)
    */
-  POSTQUOTE?: string[] | null
+  POSTQUOTE?: string[] | HeaderList | null
 
   /**
    * Commands to run after transfer.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_POSTQUOTE.html)
    */
-  postQuote?: string[] | null
+  postQuote?: string[] | HeaderList | null
 
   /**
    * How to act on redirects after POST.
@@ -5228,14 +5246,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html)
    */
-  PREQUOTE?: string[] | null
+  PREQUOTE?: string[] | HeaderList | null
 
   /**
    * Commands to run just before transfer.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_PREQUOTE.html)
    */
-  preQuote?: string[] | null
+  preQuote?: string[] | HeaderList | null
 
   /**
    * OBSOLETE callback for progress meter.
@@ -5592,14 +5610,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html)
    */
-  PROXYHEADER?: string[] | null
+  PROXYHEADER?: string[] | HeaderList | null
 
   /**
    * Custom HTTP headers sent to proxy.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html](https://curl.haxx.se/libcurl/c/CURLOPT_PROXYHEADER.html)
    */
-  proxyHeader?: string[] | null
+  proxyHeader?: string[] | HeaderList | null
 
   /**
    * Proxy password.
@@ -5690,14 +5708,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html)
    */
-  QUOTE?: string[] | null
+  QUOTE?: string[] | HeaderList | null
 
   /**
    * Commands to run before transfer.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html](https://curl.haxx.se/libcurl/c/CURLOPT_QUOTE.html)
    */
-  quote?: string[] | null
+  quote?: string[] | HeaderList | null
 
   /**
    * Provide source for entropy random data.
@@ -5802,14 +5820,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html](https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html)
    */
-  RESOLVE?: string[] | null
+  RESOLVE?: string[] | HeaderList | null
 
   /**
    * Provide fixed/fake name resolves.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html](https://curl.haxx.se/libcurl/c/CURLOPT_RESOLVE.html)
    */
-  resolve?: string[] | null
+  resolve?: string[] | HeaderList | null
 
   /**
    * Resume a transfer.
@@ -6418,14 +6436,14 @@ export type CurlOptionValueType = {
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html](https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html)
    */
-  TELNETOPTIONS?: string[] | null
+  TELNETOPTIONS?: string[] | HeaderList | null
 
   /**
    * TELNET options.
    *
    * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html](https://curl.haxx.se/libcurl/c/CURLOPT_TELNETOPTIONS.html)
    */
-  telnetOptions?: string[] | null
+  telnetOptions?: string[] | HeaderList | null
 
   /**
    * TFTP block size.
@@ -6791,6 +6809,13 @@ export type CurlOptionValueType = {
    */
   wildcardMatch?: string | number | boolean | null
 
+  /**
+   * Data pointer to pass to the write callback.
+   *
+   * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html](https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html)
+   */
+  WRITEDATA?: string | number | boolean | null
+
   /**
    * Callback for writing data.
    *
@@ -6798,6 +6823,13 @@ export type CurlOptionValueType = {
    */
   WRITEFUNCTION?: ((data: Buffer, size: number, nmemb: number) => number) | null
 
+  /**
+   * Data pointer to pass to the write callback.
+   *
+   * Official libcurl documentation: : [https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html](https://curl.haxx.se/libcurl/c/CURLOPT_WRITEDATA.html)
+   */
+  writeData?: string | number | boolean | null
+
   /**
    * Callback for writing data.
    *
@@ -6,8 +6,17 @@
  */
 export { Curl } from './Curl'
 export { Easy } from './Easy'
+export { HeaderList } from './HeaderList'
 export { Multi } from './Multi'
+export {
+  MultiPool,
+  MultiPoolMessageCallback,
+  MultiPoolOptions,
+  MultiPoolStrategy,
+} from './MultiPool'
+export { OptionTemplate } from './OptionTemplate'
 export { Share } from './Share'
+export { ThreadedMulti } from './ThreadedMulti'
 export { curly, CurlyFunction, CurlyResult } from './curly'
 
 // those are only for documentation purposes
@@ -46,6 +55,11 @@ export * from './enum/CurlSslVersion'
 export * from './enum/CurlTimeCond'
 export * from './enum/CurlUseSsl'
 export * from './enum/CurlWriteFunc'
+export * from './enum/EasyDigest'
+export * from './enum/EasyHeaderMode'
+export * from './enum/EasyTextEncoding'
+export * from './enum/EasyWriteMode'
+export * from './enum/EasyWriteRingIndex'
 export * from './enum/SocketState'
 
 // types that can be helpful for library consumer
@@ -59,4 +73,11 @@ export {
 } from './generated/CurlOption'
 export { MultiOption, MultiOptionName } from './generated/MultiOption'
 
-export { FileInfo, HttpPostField } from './types'
+export {
+  BufferPoolStats,
+  CurlMimePart,
+  FileInfo,
+  HttpPostField,
+  MimePart,
+  MultiSocketStats,
+} from './types'
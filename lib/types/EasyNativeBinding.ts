@@ -4,6 +4,7 @@
  * This source code is licensed under the MIT license found in the
  * LICENSE file in the root directory of this source tree.
  */
+import { HeaderList } from '../HeaderList'
 import { Share } from '../Share'
 import {
   CurlOptionName,
@@ -18,18 +19,62 @@ import { CurlCode } from '../enum/CurlCode'
 import { CurlGssApi } from '../enum/CurlGssApi'
 import { CurlPause } from '../enum/CurlPause'
 import { CurlSslOpt } from '../enum/CurlSslOpt'
+import { EasyDigest } from '../enum/EasyDigest'
+import { EasyHeaderMode } from '../enum/EasyHeaderMode'
+import { EasyTextEncoding } from '../enum/EasyTextEncoding'
+import { EasyWriteMode } from '../enum/EasyWriteMode'
+import { HeaderInfo } from '../parseHeaders'
 import { SocketState } from '../enum/SocketState'
 
-import { FileInfo, HttpPostField } from './'
+import {
+  FileInfo,
+  HttpPostField,
+  MimePart,
+  OptionTemplateNativeBinding,
+} from './'
 
 export interface GetInfoReturn {
   data: number | string | null
   code: CurlCode
 }
 
+export interface SetOptsReturn {
+  option: CurlOptionName | number
+  code: CurlCode
+}
+
+/**
+ * Counters of the memory blocks that back the Buffers created when buffer pooling is enabled,
+ *  returned by `Easy.getBufferPoolStats`. The pool is shared by all handles of the same thread.
+ *
+ * @public
+ */
+export interface BufferPoolStats {
+  /**
+   * Number of blocks that had to be allocated.
+   */
+  blocksAllocated: number
+
+  /**
+   * Number of blocks given back by collected Buffers that were used again.
+   */
+  blocksReused: number
+
+  /**
+   * Bytes of the blocks kept to be reused.
+   */
+  cachedBytes: number
+}
+
 export declare class EasyNativeBinding {
   isInsideMultiHandle: boolean
 
+  /**
+   * `CurlPause` bits currently set for the transfer, by `pause`, by callbacks returning a pause code,
+   *  or by the addon while it waits to read or write data natively.
+   */
+  readonly pauseState: CurlPause
+
   // START AUTOMATICALLY GENERATED CODE - DO NOT EDIT
   /**
    * Use `Curl.option` for predefined constants.
@@ -61,7 +106,10 @@ export declare class EasyNativeBinding {
    *
    * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
-  setOpt(option: StringListOptions, value: string[] | null): CurlCode
+  setOpt(
+    option: StringListOptions,
+    value: string[] | HeaderList | null,
+  ): CurlCode
   /**
    * Use `Curl.option` for predefined constants.
    *
@@ -125,6 +173,21 @@ export declare class EasyNativeBinding {
    * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
    */
   setOpt(option: 'HTTPPOST', value: HttpPostField[] | null): CurlCode
+  /**
+   * Use `Curl.option` for predefined constants.
+   *
+   * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
+   */
+  setOpt(option: 'MIMEPOST', value: MimePart[] | null): CurlCode
+  /**
+   * Use `Curl.option` for predefined constants.
+   *
+   * Official libcurl documentation: [curl_easy_setopt()](http://curl.haxx.se/libcurl/c/curl_easy_setopt.html)
+   */
+  setOpt(
+    option: 'POSTFIELDS',
+    value: string | ArrayBufferView | null,
+  ): CurlCode
   /**
    * Use `Curl.option` for predefined constants.
    *
@@ -153,6 +216,30 @@ export declare class EasyNativeBinding {
     value: string | number | boolean | null,
   ): CurlCode
   // END AUTOMATICALLY GENERATED CODE - DO NOT EDIT
+  /**
+   * Sets multiple options at once, with a single call into the addon.
+   *
+   * The options can be an object, or an array of `[option, value]` pairs, which are set in order.
+   * Each value follows the same rules than the ones passed to `setOpt`.
+   *
+   * Instead of returning the code of each option, the first one libcurl rejected is returned,
+   *  together with its code, the options after it are not set. `null` is returned if all of them were set.
+   *
+   * Invalid values still throw, like with `setOpt`.
+   */
+  setOpts(
+    options:
+      | { [option: string]: unknown }
+      | [CurlOptionName | number, unknown][],
+  ): SetOptsReturn | null
+  /**
+   * Sets all options of the given template, which were already converted when it was created.
+   *
+   * The return value is the same than the one of `setOpts`, with the option being its id.
+   */
+  applyTemplate(
+    optionTemplate: OptionTemplateNativeBinding,
+  ): SetOptsReturn | null
   /**
    * Use `Curl.info` for predefined constants.
    *
@@ -212,6 +299,182 @@ export declare class EasyNativeBinding {
    */
   dupHandle(): EasyNativeBinding
 
+  /**
+   * Changes what is done with the body data received by this handle.
+   *
+   * With `EasyWriteMode.Collect` the data is stored natively instead of being passed
+   *  to the `WRITEFUNCTION` callback, use `takeCollectedData` to retrieve it.
+   *
+   * With `EasyWriteMode.Coalesce` the chunks received while processing a single socket event
+   *  are passed to the `WRITEFUNCTION` callback at once.
+   *
+   * This cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setWriteMode(mode: EasyWriteMode): this
+
+  /**
+   * Returns the body data stored by the last transfer when using `EasyWriteMode.Collect`,
+   *  the storage is emptied afterwards.
+   *
+   * The memory is moved to the returned Buffer, no copy is made.
+   */
+  takeCollectedData(): Buffer
+
+  /**
+   * Same than `takeCollectedData`, but the body is decoded into a string, by default as UTF-8.
+   *
+   * ASCII and latin1 bodies are not copied, the string is backed by the memory they were stored in.
+   */
+  takeCollectedDataAsString(encoding?: EasyTextEncoding): string
+
+  /**
+   * Same than `takeCollectedData`, but the body is parsed as JSON on the libuv threadpool,
+   *  only the resulting values are created on the main thread.
+   *
+   * The callback is called with a `SyntaxError` if the body is not valid JSON.
+   */
+  takeCollectedDataAsJson(
+    callback: (error: Error | null, value?: any) => void,
+  ): void
+
+  /**
+   * When enabled, the Buffers passed to the `WRITEFUNCTION`, `HEADERFUNCTION` and `DEBUGFUNCTION`
+   *  callbacks are backed by native memory blocks that are reused after the Buffers are garbage collected,
+   *  instead of being allocated for each chunk.
+   *
+   * Keeping references to those Buffers for a long time keeps the blocks from being reused.
+   */
+  setBufferPooling(enabled: boolean): this
+
+  /**
+   * Changes what is done with the header lines received by this handle.
+   *
+   * With `EasyHeaderMode.Parse` the lines are parsed natively instead of being passed
+   *  to the `HEADERFUNCTION` callback, use `takeParsedHeaders` to retrieve them.
+   *
+   * This cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setHeaderMode(mode: EasyHeaderMode): this
+
+  /**
+   * Returns the headers parsed during the last transfer when using `EasyHeaderMode.Parse`,
+   *  in the same format used by the `Curl` class `end` event.
+   */
+  takeParsedHeaders(): HeaderInfo[]
+
+  /**
+   * Position of the file set with the `WRITEDATA` option where the body is going to be written.
+   *
+   * By default, or if `-1` is passed, the current position of the file is used.
+   */
+  setWriteDataOffset(offset: number): this
+
+  /**
+   * Copies the body into the given `SharedArrayBuffer`, used as a single producer / single consumer ring,
+   * instead of passing it to `WRITEFUNCTION`. This allows another thread, like a `worker_threads` one,
+   * to process the data while it is being received.
+   *
+   * The buffer must have 16 bytes for the header, described by {@link EasyWriteRingIndex},
+   * followed by the ring data, which size must be a power of two of at least 16384 bytes.
+   * The consumer reads the bytes between `Tail` and `Head`, at `Tail & (size - 1)`, and then advances `Tail`.
+   *
+   * When the ring is full the transfer is paused until the consumer makes room, which is checked
+   *  with a timer backing off up to 50ms, or right away when `writeRingConsumed` is called.
+   * With `Easy.perform` the thread is blocked while waiting, so the consumer must be running on another thread,
+   *  and the transfer fails with `CURLE_WRITE_ERROR` if it does not make room within 5 seconds.
+   *
+   * Pass `null` to stop using the ring. It cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setWriteRing(sharedArrayBuffer: SharedArrayBuffer | null): this
+
+  /**
+   * Lets the handle know the consumer of the write ring advanced the `Tail`, so a transfer paused
+   *  because the ring was full is resumed right away, instead of on the next check of its timer.
+   *
+   * Consumers running on another thread can call it after telling the main thread, with `postMessage` for example.
+   */
+  writeRingConsumed(): this
+
+  /**
+   * Enables the given digests, which are computed natively while the body is received,
+   *  with each chunk, so there is no need for another pass over the data later on.
+   *
+   * Pass `0` to disable them. This cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setDigests(digests: EasyDigest | number): this
+
+  /**
+   * Uploads the given data without calling `READFUNCTION`, it is served straight from their memory.
+   * Seeking, for example when libcurl needs to rewind the upload, works automatically.
+   *
+   * If an array is passed, their items are uploaded one after the other.
+   * The data must not be changed while it is being uploaded. Pass `null` to stop using it.
+   *
+   * This cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setUploadBuffer(data: ArrayBufferView | ArrayBufferView[] | null): this
+
+  /**
+   * Uploads the given file, which is memory mapped, without calling `READFUNCTION`.
+   * `file` can be a path or a file descriptor, which can be closed after this returns.
+   *
+   * Seeking is just a pointer move, so rewinding the upload, for example on redirects,
+   * is cheap. When the same file is uploaded by multiple handles they share the same mapping.
+   *
+   * The file must not be truncated while it is being uploaded, reading the part that was removed
+   *  crashes the process with `SIGBUS`. Use `READDATA` for files that can change during the upload.
+   * Pass `null` to stop using it.
+   * This replaces any data set with `setUploadBuffer`, and vice versa.
+   *
+   * This cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setUploadFile(file: string | number | null): this
+
+  /**
+   * Uploads data that is pushed with `writeUploadQueue` while the request is running,
+   * without calling `READFUNCTION`. Pass `null` to stop using it.
+   *
+   * When the queue is empty the transfer is paused, until more data is written,
+   * or `endUploadQueue` is called.
+   *
+   * `writeUploadQueue` returns `false` once the queued data reaches `highWaterMark` bytes,
+   * `onDrain` is called after it goes back to `lowWaterMark` bytes,
+   * the same way `Writable` streams work.
+   *
+   * This only works when the handle is inside a `Multi` instance, with `perform` there is
+   * no way to write more data while it is blocking, so the transfer fails if the queue is empty.
+   *
+   * This cannot be changed while the handle is inside a `Multi` instance.
+   */
+  setUploadQueue(
+    highWaterMark: number,
+    lowWaterMark: number,
+    onDrain: (this: EasyNativeBinding) => void,
+  ): this
+  setUploadQueue(highWaterMark: null): this
+
+  /**
+   * Adds a chunk to the upload queue, it is sent straight from its memory,
+   * so it must not be changed after this is called.
+   *
+   * Returns `false` if the queue is full, see `setUploadQueue`.
+   */
+  writeUploadQueue(chunk: ArrayBufferView): boolean
+
+  /**
+   * Lets the upload queue know no more data is coming.
+   *
+   * If `isAborted` is `true` the request fails with `CURLE_ABORTED_BY_CALLBACK`.
+   */
+  endUploadQueue(isAborted?: boolean): this
+
+  /**
+   * Returns the digest of the body received by the last transfer, as a lowercase hex string.
+   *
+   * The digest must have been enabled with `setDigests`.
+   */
+  getDigest(digest: EasyDigest): string
+
   /**
    * The only time this method should be used is when one enables the internal polling of the connection socket used by
    *  this handle (by calling `Easy#monitorSocketEvents`)
@@ -252,4 +515,17 @@ export declare interface EasyNativeBindingObject {
    * Official libcurl documentation: [curl_easy_strerror()](http://curl.haxx.se/libcurl/c/curl_easy_strerror.html)
    */
   strError(errorCode: CurlCode): string
+
+  /**
+   * Returns how many memory blocks were allocated and reused by the pool used with `setBufferPooling`.
+   */
+  getBufferPoolStats(): BufferPoolStats
+
+  /**
+   * Gives the memory of a Buffer received while `setBufferPooling` is enabled back to the pool right away,
+   *  instead of after the Buffer is garbage collected. The Buffer becomes empty, so it must not be referenced anymore.
+   *
+   * Returns `false`, leaving the Buffer untouched, if it is not backed by the pool, or before Node.js 14.
+   */
+  releasePooledBuffer(buffer: Buffer): boolean
 }
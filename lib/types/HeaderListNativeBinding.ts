@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+export declare class HeaderListNativeBinding {
+  /**
+   * Returns a new list, with the given lines followed by the ones of this list.
+   *
+   * The lines of this list are not copied, they are shared by both lists.
+   */
+  extend(lines: string[]): this
+
+  /**
+   * Returns all lines of this list, in the order they are sent.
+   */
+  toArray(): string[]
+}
+
+export declare interface HeaderListNativeBindingObject {
+  new (lines?: string[]): HeaderListNativeBinding
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { Readable } from 'stream'
+
+interface MimePartBase {
+  /**
+   * Field name
+   */
+  name: string
+  /**
+   * Content-Type
+   */
+  type?: string
+  /**
+   * File name to be used when uploading
+   */
+  filename?: string
+  /**
+   * Extra headers for this part
+   */
+  headers?: string[]
+}
+
+interface MimePartData extends MimePartBase {
+  /**
+   * Part contents.
+   *
+   * Buffers and TypedArrays are sent straight from their memory, without being copied,
+   * so they must not be changed while the form is being used.
+   */
+  data: string | ArrayBufferView
+}
+
+interface MimePartFile extends MimePartBase {
+  /**
+   * Path of the file to be sent, it is streamed from disk.
+   */
+  file: string
+}
+
+interface MimePartRead extends MimePartBase {
+  /**
+   * Called when more data for this part is needed, the same way `READFUNCTION` is.
+   *
+   * It can return `CurlReadFunc.Pause`, use `Curl.pause` to resume the transfer.
+   *
+   * The data cannot be read again, so the form can only be sent once.
+   */
+  read: (data: Buffer, size: number, nmemb: number) => number
+  /**
+   * Size of the data returned by `read`, if unknown the request uses chunked encoding.
+   */
+  size?: number
+}
+
+interface MimePartStream extends MimePartBase {
+  /**
+   * Stream whose data is sent as the contents of this part, it's read while the form is
+   *  being sent, pausing the transfer while there is no data available.
+   *
+   * If the stream emits an error the request fails with `CURLE_ABORTED_BY_CALLBACK`.
+   *
+   * The data cannot be read again, so the form can only be sent once.
+   */
+  stream: Readable
+  /**
+   * Size of the data of the stream, if unknown the request uses chunked encoding.
+   */
+  size?: number
+}
+
+/**
+ * Part of a multipart form, set with the `MIMEPOST` option.
+ *
+ * Only one of `data`, `file` and `read` can be used.
+ *
+ * @public
+ */
+export type MimePart = MimePartData | MimePartFile | MimePartRead
+
+/**
+ * Part of a multipart form, set with the `MIMEPOST` option of `Curl`, which also accepts streams.
+ *
+ * Only one of `data`, `file`, `read` and `stream` can be used.
+ *
+ * @public
+ */
+export type CurlMimePart = MimePart | MimePartStream
@@ -13,6 +13,38 @@ import { EasyNativeBinding } from './EasyNativeBinding'
  * OnMessage callback called when there are new informations about handles inside this multi instance.
  */
 
+/**
+ * Counters of the sockets handled by a multi instance, returned by `getSocketStats`.
+ *
+ * @public
+ */
+export interface MultiSocketStats {
+  /**
+   * Contexts of sockets currently open, or still being closed.
+   */
+  socketContexts: number
+
+  /**
+   * Contexts allocated, they are kept and reused after their sockets are closed.
+   */
+  socketContextsAllocated: number
+
+  /**
+   * Number of sockets that were opened since this multi instance was created.
+   */
+  socketContextsAcquired: number
+
+  /**
+   * Number of times the events watched for a socket were changed.
+   */
+  pollStarts: number
+
+  /**
+   * Number of times libcurl asked for the events that were already being watched.
+   */
+  pollStartsSkipped: number
+}
+
 export declare class MultiNativeBinding {
   /**
    * Use `Curl.multi` for predefined constants.
@@ -54,11 +86,40 @@ export declare class MultiNativeBinding {
       | null,
   ): this
 
+  /**
+   * Batched alternative to `onMessage`, while set `onMessage` is not called.
+   *
+   * The handles whose transfers finished are removed from this multi instance before the
+   *  callback is called, so `removeHandle` must not be called for them. All the transfers
+   *  that finished during the same socket event are delivered in a single call:
+   *
+   * - `easyHandles`: the handles.
+   * - `errorCodes`: the result of the transfer of each handle.
+   * - `errors`: the error of each handle, `null` for the ones that succeeded. It's `null`
+   *  itself when all of them succeeded.
+   *
+   * Pass `null` to remove the current callback set
+   */
+  onMessages(
+    cb:
+      | ((
+          easyHandles: EasyNativeBinding[],
+          errorCodes: Int32Array,
+          errors: (Error | null)[] | null,
+        ) => void)
+      | null,
+  ): this
+
   /**
    * Returns the number of easy handles that are inside this multi instance
    */
   getCount(): number
 
+  /**
+   * Returns the counters of the sockets handled by this multi instance.
+   */
+  getSocketStats(): MultiSocketStats
+
   /**
    * Closes this multi handle.
    *
@@ -8,8 +8,11 @@ import {
   CurlNativeBindingObject,
   CurlVersionInfoNativeBindingObject,
   EasyNativeBindingObject,
+  HeaderListNativeBindingObject,
   MultiNativeBindingObject,
+  OptionTemplateNativeBindingObject,
   ShareNativeBindingObject,
+  ThreadedMultiNativeBindingObject,
 } from './'
 
 // type Constructable<T, B> = {
@@ -27,6 +30,9 @@ export interface NodeLibcurlNativeBinding {
   Curl: CurlNativeBindingObject
   CurlVersionInfo: CurlVersionInfoNativeBindingObject
   Easy: EasyNativeBindingObject
+  HeaderList: HeaderListNativeBindingObject
   Multi: MultiNativeBindingObject
+  OptionTemplate: OptionTemplateNativeBindingObject
   Share: ShareNativeBindingObject
+  ThreadedMulti: ThreadedMultiNativeBindingObject
 }
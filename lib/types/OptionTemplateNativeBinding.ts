@@ -0,0 +1,22 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { CurlOptionName } from '../generated/CurlOption'
+
+export declare class OptionTemplateNativeBinding {}
+
+export declare interface OptionTemplateNativeBindingObject {
+  /**
+   * The options can be an object, or an array of `[option, value]` pairs, which are set in order.
+   *
+   * Only options whose value is a string, a number or an array of strings can be used.
+   */
+  new (
+    options:
+      | { [option: string]: unknown }
+      | [CurlOptionName | number, unknown][],
+  ): OptionTemplateNativeBinding
+}
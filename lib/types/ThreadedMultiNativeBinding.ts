@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import { CurlMultiCode, CurlCode } from '../enum/CurlCode'
+
+import { EasyNativeBinding } from './EasyNativeBinding'
+
+export declare class ThreadedMultiNativeBinding {
+  /**
+   * Adds an easy handle, its transfer is started right away on the thread of this instance.
+   *
+   * Only handles whose data never goes through JavaScript can be added:
+   * - `EasyWriteMode.Collect` and `EasyHeaderMode.Parse` must be used.
+   * - No callbacks can be set, and the uploads must use `setUploadBuffer` or `setUploadFile`.
+   *
+   * The handle cannot be used until `onMessage` is called for it.
+   *
+   * `NOSIGNAL` is enabled on the handle, libcurl requires it when running on other threads.
+   */
+  addHandle(handle: EasyNativeBinding): CurlMultiCode
+
+  /**
+   * Removes an easy handle that was added to this instance.
+   *
+   * The handle is only released after the thread stops using it,
+   *  `isInsideMultiHandle` is `true` until then, and the `onMessage` callback is not called for it.
+   */
+  removeHandle(handle: EasyNativeBinding): CurlMultiCode
+
+  /**
+   * Callback called on the main thread when the transfer of a handle finishes.
+   *
+   * Pass `null` to remove the current callback set
+   */
+  onMessage(
+    cb:
+      | ((
+          error: Error | null,
+          easyHandle: EasyNativeBinding,
+          errorCode: CurlCode,
+        ) => void)
+      | null,
+  ): this
+
+  /**
+   * Returns the number of easy handles that are inside this instance
+   */
+  getCount(): number
+
+  /**
+   * Stops the thread and closes the multi handle.
+   *
+   * The handles still inside this instance are removed, without `onMessage` being called for them.
+   */
+  close(): void
+}
+
+export declare interface ThreadedMultiNativeBindingObject {
+  /**
+   * Requires libcurl 7.68.0 or newer.
+   */
+  new (): ThreadedMultiNativeBinding
+}
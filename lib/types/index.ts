@@ -8,15 +8,33 @@ export { CurlNativeBindingObject } from './CurlNativeBinding'
 export {
   CurlVersionInfoNativeBindingObject,
 } from './CurlVersionInfoNativeBinding'
-export { EasyNativeBinding, EasyNativeBindingObject } from './EasyNativeBinding'
+export {
+  BufferPoolStats,
+  EasyNativeBinding,
+  EasyNativeBindingObject,
+} from './EasyNativeBinding'
 export { FileInfo } from './FileInfo'
+export {
+  HeaderListNativeBinding,
+  HeaderListNativeBindingObject,
+} from './HeaderListNativeBinding'
 export { HttpPostField } from './HttpPostField'
+export { CurlMimePart, MimePart } from './MimePart'
 export {
   MultiNativeBinding,
   MultiNativeBindingObject,
+  MultiSocketStats,
 } from './MultiNativeBinding'
 export { NodeLibcurlNativeBinding } from './NodeLibcurlNativeBinding'
+export {
+  OptionTemplateNativeBinding,
+  OptionTemplateNativeBindingObject,
+} from './OptionTemplateNativeBinding'
 export {
   ShareNativeBinding,
   ShareNativeBindingObject,
 } from './ShareNativeBinding'
+export {
+  ThreadedMultiNativeBinding,
+  ThreadedMultiNativeBindingObject,
+} from './ThreadedMultiNativeBinding'
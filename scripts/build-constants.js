@@ -43,6 +43,7 @@ const run = async () => {
     extraHeaderText: `
       import { CurlGssApi } from "../enum/CurlGssApi"
       import { CurlSslOpt } from "../enum/CurlSslOpt"
+      import { HeaderList } from "../HeaderList"
       import { Share } from "../Share"
     `,
   })
@@ -73,7 +74,7 @@ const run = async () => {
   const union = arr => arr.map(i => inspect(i)).join(' | ')
 
   let optionsValueTypeData = [
-    'import { FileInfo, HttpPostField } from "../types"',
+    'import { FileInfo, HttpPostField, MimePart } from "../types"',
     `export type DataCallbackOptions = ${union(optionKindMap.dataCallback)}`,
     `export type ProgressCallbackOptions = ${union(
       optionKindMap.progressCallback,
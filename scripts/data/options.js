@@ -22,6 +22,8 @@ const optionKindMap = {
     'TRAILERFUNCTION',
     'SHARE',
     'HTTPPOST',
+    'MIMEPOST',
+    'POSTFIELDS',
     'GSSAPI_DELEGATION',
     'PROXY_SSL_OPTIONS',
     'SSL_OPTIONS',
@@ -33,7 +35,7 @@ const optionKindValueMap = {
   dataCallback: '((data: Buffer, size: number, nmemb: number) => number)',
   progressCallback:
     '((dltotal: number,dlnow: number,ultotal: number,ulnow: number) => number)',
-  stringList: 'string[]',
+  stringList: 'string[] | HeaderList',
   /* @TODO Add type definitions, they are on Curl.chunk */
   CHUNK_BGN_FUNCTION: '((fileInfo: FileInfo, remains: number) => number)',
   /* @TODO Add type definitions, they are on Curl.chunk */
@@ -43,6 +45,8 @@ const optionKindValueMap = {
   /* @TODO Add type definitions, they are on Curl.fnmatchfunc */
   FNMATCH_FUNCTION: '((pattern: string, value: string) => number)',
   HTTPPOST: 'HttpPostField[]',
+  MIMEPOST: 'MimePart[]',
+  POSTFIELDS: 'string | ArrayBufferView',
   TRAILERFUNCTION: '(() => string[] | false)',
   /* @TODO Add CURL_SEEKFUNC_* type definitions */
   SEEKFUNCTION: '((offset: number, origin: number) => number)',
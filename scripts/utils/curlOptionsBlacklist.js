@@ -41,7 +41,6 @@ const curlOptionsBlacklist = [
   'CURLOPT_FNMATCH_DATA',
   'CURLOPT_TRAILERDATA',
   // Options that are used internally
-  'CURLOPT_WRITEDATA',
   'CURLOPT_HEADERDATA',
 ]
 
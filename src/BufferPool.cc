@@ -0,0 +1,215 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "BufferPool.h"
+
+#include "Curl.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// smallest class is 256 bytes, biggest is 64 KiB (CURL_MAX_WRITE_SIZE is 16 KiB by default)
+#define BUFFER_POOL_MIN_SHIFT 8
+#define BUFFER_POOL_CLASSES 9
+
+// keeps the data aligned
+#define BUFFER_POOL_HEADER_SIZE ((sizeof(Block) + 15) & ~static_cast<size_t>(15))
+
+namespace NodeLibcurl {
+
+BufferPool::BufferPool(size_t maxCachedBytes) : maxCachedBytes(maxCachedBytes), refs(1) {
+  static_assert(sizeof(freeLists) / sizeof(freeLists[0]) == BUFFER_POOL_CLASSES,
+                "One free list per size class");
+
+  for (uint32_t i = 0; i < BUFFER_POOL_CLASSES; i++) {
+    this->freeLists[i] = nullptr;
+  }
+
+  uv_mutex_init(&this->mutex);
+}
+
+BufferPool::~BufferPool() {
+  for (uint32_t i = 0; i < BUFFER_POOL_CLASSES; i++) {
+    Block* block = this->freeLists[i];
+
+    while (block) {
+      Block* next = block->next;
+      std::free(block);
+      block = next;
+    }
+  }
+
+  uv_mutex_destroy(&this->mutex);
+}
+
+BufferPool* BufferPool::Create(size_t maxCachedBytes) { return new BufferPool(maxCachedBytes); }
+
+void BufferPool::Ref() { ++this->refs; }
+
+void BufferPool::Unref() {
+  if (--this->refs == 0) {
+    delete this;
+  }
+}
+
+size_t BufferPool::SizeOfClass(uint32_t sizeClass) {
+  return static_cast<size_t>(1) << (sizeClass + BUFFER_POOL_MIN_SHIFT);
+}
+
+char* BufferPool::DataOf(Block* block) {
+  return reinterpret_cast<char*>(block) + BUFFER_POOL_HEADER_SIZE;
+}
+
+BufferPool::Block* BufferPool::Acquire(uint32_t sizeClass) {
+  uv_mutex_lock(&this->mutex);
+
+  Block* block = this->freeLists[sizeClass];
+
+  if (block) {
+    this->freeLists[sizeClass] = block->next;
+    this->cachedBytes -= SizeOfClass(sizeClass);
+    this->blocksReused++;
+  }
+
+  uv_mutex_unlock(&this->mutex);
+
+  if (!block) {
+    block = static_cast<Block*>(std::malloc(BUFFER_POOL_HEADER_SIZE + SizeOfClass(sizeClass)));
+
+    if (!block) {
+      return nullptr;
+    }
+
+    block->pool = this;
+    block->sizeClass = sizeClass;
+
+    uv_mutex_lock(&this->mutex);
+    this->blocksAllocated++;
+    uv_mutex_unlock(&this->mutex);
+  }
+
+  block->next = nullptr;
+
+  return block;
+}
+
+void BufferPool::Release(Block* block) {
+  size_t size = SizeOfClass(block->sizeClass);
+
+  uv_mutex_lock(&this->mutex);
+
+  if (this->cachedBytes + size <= this->maxCachedBytes) {
+    block->next = this->freeLists[block->sizeClass];
+    this->freeLists[block->sizeClass] = block;
+    this->cachedBytes += size;
+    block = nullptr;
+  }
+
+  uv_mutex_unlock(&this->mutex);
+
+  if (block) {
+    std::free(block);
+  }
+}
+
+void BufferPool::FreeCallback(char* data, void* hint) {
+  Block* block = static_cast<Block*>(hint);
+  BufferPool* pool = block->pool;
+
+  uv_mutex_lock(&pool->mutex);
+  pool->blocksInUse.erase(data);
+  uv_mutex_unlock(&pool->mutex);
+
+  AdjustMemory(-static_cast<ssize_t>(SizeOfClass(block->sizeClass)));
+
+  pool->Release(block);
+  pool->Unref();
+}
+
+v8::Local<v8::Object> BufferPool::NewBuffer(const char* data, size_t length) {
+  Nan::EscapableHandleScope scope;
+
+  uint32_t sizeClass = 0;
+
+  while (sizeClass < BUFFER_POOL_CLASSES && SizeOfClass(sizeClass) < length) {
+    sizeClass++;
+  }
+
+  Block* block = sizeClass < BUFFER_POOL_CLASSES ? this->Acquire(sizeClass) : nullptr;
+
+  if (!block) {
+    return scope.Escape(Nan::CopyBuffer(data, static_cast<uint32_t>(length)).ToLocalChecked());
+  }
+
+  char* blockData = DataOf(block);
+  std::memcpy(blockData, data, length);
+
+  this->Ref();
+
+  Nan::MaybeLocal<v8::Object> buffer =
+      Nan::NewBuffer(blockData, static_cast<uint32_t>(length), BufferPool::FreeCallback, block);
+
+  if (buffer.IsEmpty()) {
+    this->Release(block);
+    this->Unref();
+    return scope.Escape(Nan::CopyBuffer(data, static_cast<uint32_t>(length)).ToLocalChecked());
+  }
+
+  // v8 does not know about memory outside its heap, so let it know, otherwise
+  //  it would not be in a hurry to collect the Buffers and give the blocks back.
+  AdjustMemory(static_cast<ssize_t>(SizeOfClass(sizeClass)));
+
+  uv_mutex_lock(&this->mutex);
+  this->blocksInUse.insert(blockData);
+  uv_mutex_unlock(&this->mutex);
+
+  return scope.Escape(buffer.ToLocalChecked());
+}
+
+bool BufferPool::ReleaseBuffer(v8::Local<v8::Object> buffer) {
+#if V8_MAJOR_VERSION >= 8
+  // before that the free callback only runs when the ArrayBuffer is garbage collected
+  v8::Local<v8::ArrayBufferView> view = buffer.As<v8::ArrayBufferView>();
+  v8::Local<v8::ArrayBuffer> arrayBuffer = view->Buffer();
+
+  if (view->ByteOffset() != 0 || !arrayBuffer->IsDetachable()) {
+    return false;
+  }
+
+  const char* data = node::Buffer::Data(buffer);
+
+  uv_mutex_lock(&this->mutex);
+  bool isPooled = data && this->blocksInUse.count(data) > 0;
+  uv_mutex_unlock(&this->mutex);
+
+  if (!isPooled) {
+    return false;
+  }
+
+  // node calls the free callback soon after the last reference to the memory is dropped
+#if V8_MAJOR_VERSION >= 11
+  return arrayBuffer->Detach(v8::Local<v8::Value>()).FromMaybe(false);
+#else
+  arrayBuffer->Detach();
+
+  return true;
+#endif
+#else
+  return false;
+#endif
+}
+
+BufferPool::Stats BufferPool::GetStats() {
+  uv_mutex_lock(&this->mutex);
+
+  Stats stats = {this->blocksAllocated, this->blocksReused, this->cachedBytes};
+
+  uv_mutex_unlock(&this->mutex);
+
+  return stats;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_BUFFERPOOL_H
+#define NODELIBCURL_BUFFERPOOL_H
+
+#include <nan.h>
+#include <uv.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+namespace NodeLibcurl {
+
+// Pool of native memory blocks used to back the Buffers passed to js callbacks.
+// libcurl reuses its own receive buffer, so the chunk still needs to be copied once,
+// but the memory is recycled when the Buffer is garbage collected, instead of being
+// allocated and freed for each chunk.
+// Blocks are grouped in power of two size classes, chunks bigger than the biggest class
+// are copied into a regular Buffer.
+class BufferPool {
+  struct Block {
+    BufferPool* pool;
+    Block* next;  // only used while the block is inside a free list
+    uint32_t sizeClass;
+  };
+
+  BufferPool(const BufferPool& that);
+  BufferPool& operator=(const BufferPool& that);
+
+  explicit BufferPool(size_t maxCachedBytes);
+  ~BufferPool();
+
+  Block* Acquire(uint32_t sizeClass);
+  void Release(Block* block);
+  void Ref();
+
+  static size_t SizeOfClass(uint32_t sizeClass);
+  static char* DataOf(Block* block);
+
+  static void FreeCallback(char* data, void* hint);
+
+  Block* freeLists[9];
+  size_t cachedBytes = 0;
+  size_t maxCachedBytes;
+
+  // exposed by Easy.getBufferPoolStats
+  uint64_t blocksAllocated = 0;
+  uint64_t blocksReused = 0;
+
+  // data of the blocks backing a Buffer that was not released yet
+  std::unordered_set<const char*> blocksInUse;
+
+  uv_mutex_t mutex;
+  // owner reference + one for each block in use by a Buffer
+  std::atomic<uint32_t> refs;
+
+ public:
+  struct Stats {
+    uint64_t blocksAllocated;
+    uint64_t blocksReused;
+    size_t cachedBytes;
+  };
+
+  // created with one reference, owned by the caller
+  static BufferPool* Create(size_t maxCachedBytes);
+
+  // drops a reference, the pool is deleted after the last Buffer backed by it is collected
+  void Unref();
+
+  // copies data into a pooled block and returns a Buffer backed by it
+  v8::Local<v8::Object> NewBuffer(const char* data, size_t length);
+
+  Stats GetStats();
+
+  // if buffer is backed by a block of this pool, its ArrayBuffer is detached, which gives the
+  // block back right away instead of after it is garbage collected. Returns false otherwise.
+  bool ReleaseBuffer(v8::Local<v8::Object> buffer);
+};
+}  // namespace NodeLibcurl
+#endif
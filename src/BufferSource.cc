@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "BufferSource.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace NodeLibcurl {
+
+BufferSource::BufferSource() {}
+
+BufferSource::~BufferSource() {}
+
+BufferSource* BufferSource::Create(v8::Local<v8::Value> value) {
+  std::vector<v8::Local<v8::Value>> views;
+
+  if (value->IsArray()) {
+    v8::Local<v8::Array> array = value.As<v8::Array>();
+    uint32_t count = array->Length();
+
+    for (uint32_t i = 0; i < count; i++) {
+      views.push_back(Nan::Get(array, i).ToLocalChecked());
+    }
+  } else {
+    views.push_back(value);
+  }
+
+  BufferSource* source = new BufferSource();
+
+  for (size_t i = 0; i < views.size(); i++) {
+    if (!views[i]->IsArrayBufferView()) {
+      delete source;
+      Nan::ThrowTypeError(
+          "Upload buffer must be a Buffer, a TypedArray, a DataView, or an array of them.");
+      return nullptr;
+    }
+
+    std::shared_ptr<ViewContents> contents = ViewContents::Create(views[i]);
+
+    Segment segment;
+    segment.data = contents->data;
+    segment.length = contents->length;
+    segment.start = source->length;
+
+    if (segment.length == 0) {
+      continue;
+    }
+
+    source->contents.push_back(contents);
+    source->segments.push_back(segment);
+    source->length += segment.length;
+  }
+
+  return source;
+}
+
+BufferSource* BufferSource::Create(std::shared_ptr<FileMapping> mapping) {
+  BufferSource* source = new BufferSource();
+
+  if (mapping->length > 0) {
+    Segment segment;
+    segment.data = mapping->data;
+    segment.length = mapping->length;
+    segment.start = 0;
+
+    source->segments.push_back(segment);
+    source->length = mapping->length;
+  }
+
+  source->mapping = mapping;
+
+  return source;
+}
+
+void BufferSource::Prepare() { this->Seek(0); }
+
+bool BufferSource::Seek(int64_t offset) {
+  if (offset < 0 || static_cast<uint64_t>(offset) > this->length) {
+    return false;
+  }
+
+  this->position = static_cast<size_t>(offset);
+
+  // last segment starting at or before the position
+  Segment key;
+  key.start = this->position;
+
+  std::vector<Segment>::iterator it =
+      std::upper_bound(this->segments.begin(), this->segments.end(), key,
+                       [](const Segment& a, const Segment& b) { return a.start < b.start; });
+
+  this->segmentIndex = it == this->segments.begin() ? 0 : (it - this->segments.begin()) - 1;
+
+  return true;
+}
+
+size_t BufferSource::Read(char* ptr, size_t n) {
+  size_t copied = 0;
+
+  while (copied < n && this->segmentIndex < this->segments.size()) {
+    const Segment& segment = this->segments[this->segmentIndex];
+    size_t segmentOffset = this->position - segment.start;
+    size_t length = std::min(n - copied, segment.length - segmentOffset);
+
+    std::memcpy(ptr + copied, segment.data + segmentOffset, length);
+    copied += length;
+    this->position += length;
+
+    if (segmentOffset + length == segment.length) {
+      this->segmentIndex++;
+    }
+  }
+
+  return copied;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_BUFFERSOURCE_H
+#define NODELIBCURL_BUFFERSOURCE_H
+
+#include "FileMapping.h"
+#include "ViewContents.h"
+
+#include <nan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Serves the data to be uploaded by an Easy handle (set with setUploadBuffer) straight from the
+// memory of one or more Buffers / TypedArrays, which is kept alive while it's being used.
+// Multiple views are uploaded one after the other, as if they were a single one.
+// It is also used to serve a memory mapped file (set with setUploadFile).
+class BufferSource {
+  struct Segment {
+    const char* data;
+    size_t length;
+    size_t start;  // position of the first byte of this segment in the whole data
+  };
+
+  BufferSource(const BufferSource& that);
+  BufferSource& operator=(const BufferSource& that);
+
+  std::vector<std::shared_ptr<ViewContents>> contents;
+  std::shared_ptr<FileMapping> mapping;
+  std::vector<Segment> segments;
+  size_t length = 0;
+
+  size_t position = 0;
+  size_t segmentIndex = 0;  // segment position is in
+
+ public:
+  BufferSource();
+
+  ~BufferSource();
+
+  // returns nullptr, with a js exception thrown, if value is not an ArrayBufferView,
+  // or an array of them.
+  static BufferSource* Create(v8::Local<v8::Value> value);
+  static BufferSource* Create(std::shared_ptr<FileMapping> mapping);
+
+  // total size of the data
+  size_t GetLength() const { return this->length; }
+
+  // must be called before each transfer starts
+  void Prepare();
+  // used by the SEEKFUNCTION callback, returns false if the offset is out of bounds
+  bool Seek(int64_t offset);
+
+  // to be used by the READFUNCTION callback
+  size_t Read(char* ptr, size_t n);
+};
+}  // namespace NodeLibcurl
+#endif
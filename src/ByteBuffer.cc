@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "ByteBuffer.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// same value than CURL_MAX_WRITE_SIZE, the biggest chunk libcurl will hand us at once
+#define BYTE_BUFFER_MIN_CAPACITY 16384
+
+namespace NodeLibcurl {
+
+ByteBuffer::ByteBuffer() : data(nullptr), length(0), capacity(0) {}
+
+ByteBuffer::~ByteBuffer() { this->Clear(); }
+
+bool ByteBuffer::Reserve(size_t capacity) {
+  if (capacity <= this->capacity) {
+    return true;
+  }
+
+  char* newData = static_cast<char*>(std::realloc(this->data, capacity));
+
+  if (!newData) {
+    return false;
+  }
+
+  this->data = newData;
+  this->capacity = capacity;
+
+  return true;
+}
+
+bool ByteBuffer::Append(const char* chunk, size_t chunkLength) {
+  size_t required = this->length + chunkLength;
+
+  // overflow
+  if (required < this->length) {
+    return false;
+  }
+
+  if (required > this->capacity) {
+    size_t newCapacity = this->capacity ? this->capacity : BYTE_BUFFER_MIN_CAPACITY;
+
+    while (newCapacity < required) {
+      size_t doubled = newCapacity * 2;
+      newCapacity = doubled > newCapacity ? doubled : required;
+    }
+
+    if (!this->Reserve(newCapacity)) {
+      return false;
+    }
+  }
+
+  if (chunkLength) {
+    std::memcpy(this->data + this->length, chunk, chunkLength);
+    this->length = required;
+  }
+
+  return true;
+}
+
+char* ByteBuffer::Release() {
+  char* released = this->data;
+
+  this->data = nullptr;
+  this->length = 0;
+  this->capacity = 0;
+
+  return released;
+}
+
+void ByteBuffer::Clear() {
+  if (this->data) {
+    std::free(this->data);
+  }
+
+  this->data = nullptr;
+  this->length = 0;
+  this->capacity = 0;
+}
+
+}  // namespace NodeLibcurl
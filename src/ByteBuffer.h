@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_BYTEBUFFER_H
+#define NODELIBCURL_BYTEBUFFER_H
+
+#include <cstddef>
+
+namespace NodeLibcurl {
+
+// Growable malloc backed byte storage.
+// The memory can be released to the caller, which then owns it and must free it with free(),
+// this is what Nan::NewBuffer expects when no free callback is given.
+class ByteBuffer {
+  ByteBuffer(const ByteBuffer& that);
+  ByteBuffer& operator=(const ByteBuffer& that);
+
+ public:
+  char* data;
+  size_t length;
+  size_t capacity;
+
+  ByteBuffer();
+
+  ~ByteBuffer();
+
+  // make sure there is room for at least capacity bytes, returns false if allocation failed
+  bool Reserve(size_t capacity);
+  // appends data to the end of the buffer, growing it geometrically when needed
+  bool Append(const char* chunk, size_t chunkLength);
+  // gives the underlying memory away, the buffer is left empty
+  char* Release();
+  // frees the underlying memory
+  void Clear();
+};
+}  // namespace NodeLibcurl
+#endif
@@ -13,12 +13,17 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 namespace NodeLibcurl {
 
-ssize_t addonAllocatedMemory = 0;
-bool isLibcurlBuiltWithThreadedResolver = true;
+std::atomic<ssize_t> addonAllocatedMemory(0);
+std::atomic<bool> isLibcurlBuiltWithThreadedResolver(true);
+
+// libcurl global state is shared by all the isolates the addon is loaded in, and the
+// global functions are not thread safe.
+static std::mutex globalStateMutex;
 
 // This should be kept in sync with the options on scripts/utils/curlOptionsBlacklist.js
 const std::vector<CurlConstant> curlOptionNotImplemented = {
@@ -38,7 +43,6 @@ const std::vector<CurlConstant> curlOptionNotImplemented = {
     {"CONV_FROM_NETWORK_FUNCTION", CURLOPT_CONV_FROM_NETWORK_FUNCTION},
 
     // Options that are used internally.
-    {"WRITEDATA", CURLOPT_WRITEDATA},
     {"HEADERDATA", CURLOPT_HEADERDATA},
 
 // Options that are not necessary because javascript nature.
@@ -272,6 +276,7 @@ const std::vector<CurlConstant> curlOptionInteger = {
     {"USE_SSL", CURLOPT_USE_SSL},
     {"VERBOSE", CURLOPT_VERBOSE},
     {"WILDCARDMATCH", CURLOPT_WILDCARDMATCH},
+    {"WRITEDATA", CURLOPT_WRITEDATA},
 
     // _LARGE options
     {"INFILESIZE_LARGE", CURLOPT_INFILESIZE_LARGE},
@@ -477,6 +482,10 @@ const std::vector<CurlConstant> curlOptionHttpPost = {
 };
 
 const std::vector<CurlConstant> curlOptionSpecific = {
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+    {"MIMEPOST", CURLOPT_MIMEPOST},
+#endif
+
     {"SHARE", CURLOPT_SHARE},
 };
 
@@ -622,6 +631,23 @@ const std::vector<CurlConstant> curlInfoLinkedList = {
     {"COOKIELIST", CURLINFO_COOKIELIST},
 };
 
+// the order must match the CurlOptionTable enum
+const CurlConstantIndex curlOptionIndex(CurlConstantIndex::ID_LAYOUT_OPTION,
+                                        {&curlOptionNotImplemented, &curlOptionSpecific,
+                                         &curlOptionLinkedList, &curlOptionString,
+                                         &curlOptionInteger, &curlOptionFunction});
+
+// the order must match the CurlInfoTable enum
+const CurlConstantIndex curlInfoIndex(CurlConstantIndex::ID_LAYOUT_INFO,
+                                      {&curlInfoNotImplemented, &curlInfoString, &curlInfoDouble,
+                                       &curlInfoInteger, &curlInfoSocket, &curlInfoLinkedList});
+
+// the order must match the CurlMultiOptionTable enum
+const CurlConstantIndex curlMultiOptionIndex(CurlConstantIndex::ID_LAYOUT_OPTION,
+                                             {&curlMultiOptionNotImplemented,
+                                              &curlMultiOptionStringArray,
+                                              &curlMultiOptionInteger});
+
 static void ExportConstants(v8::Local<v8::Object> obj,
                             const std::vector<NodeLibcurl::CurlConstant>& optionGroup,
                             v8::PropertyAttribute attributes) {
@@ -686,55 +712,19 @@ NAN_MODULE_INIT(Initialize) {
   Nan::Set(target, Nan::New("Curl").ToLocalChecked(), obj);
 }
 
-int32_t IsInsideCurlConstantStruct(const std::vector<CurlConstant>& curlConstants,
-                                   const v8::Local<v8::Value>& searchFor) {
-  Nan::HandleScope scope;
-
-  bool isString = searchFor->IsString();
-  bool isInt = searchFor->IsInt32();
-
-  std::string optionName = "";
-  int32_t optionId = -1;
-
-  if (!isString && !isInt) {
-    return 0;
-  }
-
-  if (isString) {
-    Nan::Utf8String optionNameV8(searchFor);
-
-    optionName = std::string(*optionNameV8);
-
-    std::transform(optionName.begin(), optionName.end(), optionName.begin(), ::toupper);
-
-  } else {  // int
-    optionId = Nan::To<int32_t>(searchFor).FromJust();
-  }
-
-  for (std::vector<CurlConstant>::const_iterator it = curlConstants.begin(),
-                                                 end = curlConstants.end();
-       it != end; ++it) {
-    if ((isString && it->name == optionName) || (isInt && it->value == optionId)) {
-      return static_cast<int32_t>(it->value);
-    }
-  }
-
-  return 0;
-}
-
 // based on https://github.com/libxmljs/libxmljs/blob/master/src/libxmljs.cc#L45
 void AdjustMemory(ssize_t diff) {
-  Nan::HandleScope scope;
-
   addonAllocatedMemory += diff;
 
   // if v8 is no longer running, don't try to adjust memory
 
-  // Return if no available Isolate
+  // Return if no available Isolate, which is also the case on the ThreadedMulti threads
   if (v8::Isolate::GetCurrent() == 0 || v8::Isolate::GetCurrent()->IsDead()) {
     return;
   }
 
+  Nan::HandleScope scope;
+
   Nan::AdjustExternalMemory(static_cast<int>(diff));
 }
 
@@ -753,7 +743,7 @@ NAN_METHOD(GetVersion) {
 NAN_METHOD(GetCount) {
   Nan::HandleScope scope;
 
-  info.GetReturnValue().Set(Easy::currentOpenedHandles);
+  info.GetReturnValue().Set(Easy::currentOpenedHandles.load());
 }
 
 // The following memory allocation wrappers are mostly the ones at
@@ -830,6 +820,8 @@ NAN_METHOD(GlobalInit) {
 
   CURLcode globalInitRetCode;
 
+  std::lock_guard<std::mutex> lock(globalStateMutex);
+
   // We only add the allloc wrappers if we are running libcurl without the threaded resolver
   //  that is because v8 AdjustAmountOfExternalAllocatedMemory must be called from the Node thread
   if (!isLibcurlBuiltWithThreadedResolver) {
@@ -842,10 +834,16 @@ NAN_METHOD(GlobalInit) {
   info.GetReturnValue().Set(globalInitRetCode);
 }
 
+void CleanupGlobalState() {
+  std::lock_guard<std::mutex> lock(globalStateMutex);
+
+  curl_global_cleanup();
+}
+
 NAN_METHOD(GlobalCleanup) {
   Nan::HandleScope scope;
 
-  curl_global_cleanup();
+  CleanupGlobalState();
 
   info.GetReturnValue().Set(Nan::Undefined());
 }
@@ -7,12 +7,14 @@
 #ifndef NODELIBCURL_H
 #define NODELIBCURL_H
 
+#include "CurlConstantIndex.h"
 #include "macros.h"
 
 #include <curl/curl.h>
 #include <nan.h>
 #include <node.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -32,8 +34,8 @@ struct CurlConstant {
   int64_t value;
 };
 
-extern ssize_t addonAllocatedMemory;
-extern bool isLibcurlBuiltWithThreadedResolver;
+extern std::atomic<ssize_t> addonAllocatedMemory;
+extern std::atomic<bool> isLibcurlBuiltWithThreadedResolver;
 
 template <typename T>
 using deleted_unique_ptr = std::unique_ptr<T, std::function<void(T*)>>;
@@ -57,6 +59,35 @@ extern const std::vector<CurlConstant> curlMultiOptionNotImplemented;
 extern const std::vector<CurlConstant> curlMultiOptionInteger;
 extern const std::vector<CurlConstant> curlMultiOptionStringArray;
 
+// tables the options / infos are in, as returned by the indexes below
+enum CurlOptionTable {
+  CURL_OPTION_NOT_IMPLEMENTED = 0,
+  CURL_OPTION_SPECIFIC,
+  CURL_OPTION_LINKED_LIST,
+  CURL_OPTION_STRING,
+  CURL_OPTION_INTEGER,
+  CURL_OPTION_FUNCTION,
+};
+
+enum CurlInfoTable {
+  CURL_INFO_NOT_IMPLEMENTED = 0,
+  CURL_INFO_STRING,
+  CURL_INFO_DOUBLE,
+  CURL_INFO_INTEGER,
+  CURL_INFO_SOCKET,
+  CURL_INFO_LINKED_LIST,
+};
+
+enum CurlMultiOptionTable {
+  CURL_MULTI_OPTION_NOT_IMPLEMENTED = 0,
+  CURL_MULTI_OPTION_STRING_ARRAY,
+  CURL_MULTI_OPTION_INTEGER,
+};
+
+extern const CurlConstantIndex curlOptionIndex;
+extern const CurlConstantIndex curlInfoIndex;
+extern const CurlConstantIndex curlMultiOptionIndex;
+
 // export Curl to js
 NAN_MODULE_INIT(Initialize);
 
@@ -68,10 +99,10 @@ NAN_METHOD(GetCount);
 NAN_GETTER(GetterVersionNum);
 
 // helper methods
-int32_t IsInsideCurlConstantStruct(const std::vector<CurlConstant>& curlConstants,
-                                   const v8::Local<v8::Value>& searchFor);
 void ThrowError(const char* message, const char* reason = nullptr);
 void AdjustMemory(ssize_t size);
+// calls curl_global_cleanup, can be called from any thread
+void CleanupGlobalState();
 
 }  // namespace NodeLibcurl
 #endif
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "CurlConstantIndex.h"
+
+#include "Curl.h"
+
+#include <cctype>
+#include <cstring>
+
+// no option / info name is longer than this
+#define CURL_CONSTANT_MAX_NAME_LENGTH 64
+
+namespace NodeLibcurl {
+
+CurlConstantIndex::CurlConstantIndex(
+    IdLayout layout, std::initializer_list<const std::vector<CurlConstant>*> tables)
+    : layout(layout) {
+  size_t count = 0;
+  for (const std::vector<CurlConstant>* table : tables) {
+    count += table->size();
+  }
+
+  // at most half full, so the probe sequences stay short
+  size_t slotsCount = 16;
+  while (slotsCount < count * 2) {
+    slotsCount *= 2;
+  }
+
+  NameSlot emptySlot = {nullptr, 0, -1};
+  this->slotsByName.assign(slotsCount, emptySlot);
+
+  int8_t tableIndex = 0;
+
+  for (const std::vector<CurlConstant>* table : tables) {
+    for (const CurlConstant& constant : *table) {
+      size_t type;
+      size_t number;
+
+      if (this->SplitId(constant.value, type, number)) {
+        if (this->tablesById.size() <= type) {
+          this->tablesById.resize(type + 1);
+        }
+
+        std::vector<int8_t>& numbers = this->tablesById[type];
+
+        if (numbers.size() <= number) {
+          numbers.resize(number + 1, -1);
+        }
+
+        if (numbers[number] < 0) {
+          numbers[number] = tableIndex;
+        }
+      }
+
+      size_t length = std::strlen(constant.name);
+      size_t mask = slotsCount - 1;
+
+      for (size_t i = HashName(constant.name, length) & mask;; i = (i + 1) & mask) {
+        NameSlot& slot = this->slotsByName[i];
+
+        if (!slot.name) {
+          slot.name = constant.name;
+          slot.id = static_cast<int32_t>(constant.value);
+          slot.table = tableIndex;
+          break;
+        }
+
+        if (std::strcmp(slot.name, constant.name) == 0) {
+          break;
+        }
+      }
+    }
+
+    tableIndex++;
+  }
+}
+
+bool CurlConstantIndex::SplitId(int64_t id, size_t& type, size_t& number) const {
+  if (id < 0) {
+    return false;
+  }
+
+  if (this->layout == ID_LAYOUT_OPTION) {
+    type = static_cast<size_t>(id / 10000);
+    number = static_cast<size_t>(id % 10000);
+  } else {
+    if (id & ~static_cast<int64_t>(CURLINFO_TYPEMASK | CURLINFO_MASK)) {
+      return false;
+    }
+
+    type = static_cast<size_t>((id & CURLINFO_TYPEMASK) >> 20);
+    number = static_cast<size_t>(id & CURLINFO_MASK);
+  }
+
+  return true;
+}
+
+// FNV-1a
+uint32_t CurlConstantIndex::HashName(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<unsigned char>(name[i]);
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+int CurlConstantIndex::Find(v8::Local<v8::Value> searchFor, int32_t& id) const {
+  if (searchFor->IsInt32()) {
+    int32_t value = Nan::To<int32_t>(searchFor).FromJust();
+    size_t type;
+    size_t number;
+
+    if (!this->SplitId(value, type, number) || type >= this->tablesById.size() ||
+        number >= this->tablesById[type].size()) {
+      return -1;
+    }
+
+    int table = this->tablesById[type][number];
+
+    if (table >= 0) {
+      id = value;
+    }
+
+    return table;
+  }
+
+  if (!searchFor->IsString()) {
+    return -1;
+  }
+
+  // the names are stored upper cased
+  char name[CURL_CONSTANT_MAX_NAME_LENGTH];
+  size_t length;
+
+  {
+    Nan::Utf8String nameV8(searchFor);
+
+    length = static_cast<size_t>(nameV8.length());
+
+    if (length >= CURL_CONSTANT_MAX_NAME_LENGTH) {
+      return -1;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+      name[i] = static_cast<char>(std::toupper(static_cast<unsigned char>((*nameV8)[i])));
+    }
+
+    name[length] = '\0';
+  }
+
+  size_t mask = this->slotsByName.size() - 1;
+
+  for (size_t i = HashName(name, length) & mask;; i = (i + 1) & mask) {
+    const NameSlot& slot = this->slotsByName[i];
+
+    if (!slot.name) {
+      return -1;
+    }
+
+    if (std::strcmp(slot.name, name) == 0) {
+      id = slot.id;
+      return slot.table;
+    }
+  }
+}
+
+}  // namespace NodeLibcurl
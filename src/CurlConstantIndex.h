@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_CURLCONSTANTINDEX_H
+#define NODELIBCURL_CURLCONSTANTINDEX_H
+
+#include <nan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace NodeLibcurl {
+
+struct CurlConstant;
+
+// Finds in which of a list of CurlConstant tables a constant is, given its name (case
+// insensitive) or its id, in constant time.
+// The ids are split into their type and number, like libcurl encodes them, and used to index a
+// dense table. The names are in an open addressing hash table, so no memory is allocated when
+// looking them up.
+class CurlConstantIndex {
+  struct NameSlot {
+    const char* name;  // nullptr if the slot is empty
+    int32_t id;
+    int8_t table;
+  };
+
+  CurlConstantIndex(const CurlConstantIndex& that);
+  CurlConstantIndex& operator=(const CurlConstantIndex& that);
+
+  bool SplitId(int64_t id, size_t& type, size_t& number) const;
+  static uint32_t HashName(const char* name, size_t length);
+
+ public:
+  // how the type of the constant is encoded in its id
+  enum IdLayout {
+    ID_LAYOUT_OPTION = 0,  // CURLOPTTYPE_* and CURLMOPT_*, the types are multiples of 10000
+    ID_LAYOUT_INFO = 1,    // CURLINFO_*, the type is in the CURLINFO_TYPEMASK bits
+  };
+
+  // if a constant is in more than one table, the first one is used
+  CurlConstantIndex(IdLayout layout,
+                    std::initializer_list<const std::vector<CurlConstant>*> tables);
+
+  // returns the position in the list of the table searchFor is in, setting id to its value.
+  // -1 is returned if it is in none of them.
+  int Find(v8::Local<v8::Value> searchFor, int32_t& id) const;
+
+ private:
+  IdLayout layout;
+  std::vector<std::vector<int8_t>> tablesById;  // [type][number], -1 if none
+  std::vector<NameSlot> slotsByName;            // the size is a power of two
+};
+}  // namespace NodeLibcurl
+#endif
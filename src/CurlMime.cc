@@ -0,0 +1,368 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "CurlMime.h"
+
+#include "Easy.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+
+namespace NodeLibcurl {
+
+namespace {
+v8::Local<v8::Value> GetProperty(v8::Local<v8::Object> object, const char* name) {
+  return Nan::Get(object, Nan::New<v8::String>(name).ToLocalChecked()).ToLocalChecked();
+}
+
+// the optional string properties
+bool GetStringProperty(v8::Local<v8::Object> object, const char* name, bool& hasValue,
+                       std::string& value) {
+  v8::Local<v8::Value> property = GetProperty(object, name);
+
+  hasValue = !property->IsUndefined();
+
+  if (!hasValue) {
+    return true;
+  }
+
+  if (!property->IsString()) {
+    std::string errorMsg =
+        std::string("Property \"") + name + "\" of the MIMEPOST parts must be a string.";
+    Nan::ThrowTypeError(errorMsg.c_str());
+    return false;
+  }
+
+  Nan::Utf8String string(property);
+  value.assign(*string, string.length());
+
+  return true;
+}
+}  // namespace
+
+CurlMime::CurlMime(Easy* easy, CURL* ch) : ch(ch), easy(easy) { this->mime = curl_mime_init(ch); }
+
+CurlMime::~CurlMime() { curl_mime_free(this->mime); }
+
+bool CurlMime::AddPart(v8::Local<v8::Value> value) {
+  if (!value->IsObject()) {
+    Nan::ThrowTypeError("MIMEPOST option value should be an Array of Objects.");
+    return false;
+  }
+
+  v8::Local<v8::Object> object = value.As<v8::Object>();
+
+  Part part;
+  part.size = -1;
+
+  bool hasName;
+  if (!GetStringProperty(object, "name", hasName, part.name)) {
+    return false;
+  }
+
+  if (!hasName) {
+    Nan::ThrowError("Missing field \"name\".");
+    return false;
+  }
+
+  v8::Local<v8::Value> data = GetProperty(object, "data");
+  v8::Local<v8::Value> file = GetProperty(object, "file");
+  v8::Local<v8::Value> read = GetProperty(object, "read");
+
+  int sourcesCount = !data->IsUndefined() + !file->IsUndefined() + !read->IsUndefined();
+
+  if (sourcesCount != 1) {
+    Nan::ThrowError("MIMEPOST parts must have one, and only one, of data, file or read.");
+    return false;
+  }
+
+  if (data->IsString()) {
+    Nan::Utf8String string(data);
+
+    part.source = PART_SOURCE_STRING;
+    part.value.assign(*string, string.length());
+  } else if (data->IsArrayBufferView()) {
+    part.source = PART_SOURCE_VIEW;
+    part.contents = ViewContents::Create(data);
+  } else if (file->IsString()) {
+    Nan::Utf8String string(file);
+
+    part.source = PART_SOURCE_FILE;
+    part.value.assign(*string, string.length());
+  } else if (read->IsFunction()) {
+    part.source = PART_SOURCE_CALLBACK;
+    part.callback = std::make_shared<Nan::Callback>(read.As<v8::Function>());
+
+    v8::Local<v8::Value> size = GetProperty(object, "size");
+
+    if (size->IsNumber()) {
+      part.size = static_cast<curl_off_t>(Nan::To<double>(size).FromJust());
+    } else if (!size->IsUndefined()) {
+      Nan::ThrowTypeError("Property \"size\" of the MIMEPOST parts must be a number.");
+      return false;
+    }
+  } else {
+    Nan::ThrowTypeError(
+        "Property \"data\" of the MIMEPOST parts must be a string, a Buffer or a TypedArray, "
+        "\"file\" must be a string, and \"read\" must be a function.");
+    return false;
+  }
+
+  if (!GetStringProperty(object, "type", part.hasContentType, part.contentType) ||
+      !GetStringProperty(object, "filename", part.hasFileName, part.fileName)) {
+    return false;
+  }
+
+  v8::Local<v8::Value> headers = GetProperty(object, "headers");
+
+  if (headers->IsArray()) {
+    v8::Local<v8::Array> array = headers.As<v8::Array>();
+
+    for (uint32_t i = 0, len = array->Length(); i < len; ++i) {
+      Nan::Utf8String header(Nan::Get(array, i).ToLocalChecked());
+      part.headers.push_back(std::string(*header, header.length()));
+    }
+  } else if (!headers->IsUndefined()) {
+    Nan::ThrowTypeError("Property \"headers\" of the MIMEPOST parts must be an Array.");
+    return false;
+  }
+
+  this->parts.push_back(part);
+
+  if (this->Build(this->parts.back()) != CURLE_OK) {
+    std::string errorMsg = "Error while adding field \"" + part.name + "\" to post data.";
+    Nan::ThrowError(errorMsg.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+CURLcode CurlMime::AddField(const std::string& name, const std::string& contents) {
+  Part part;
+  part.source = PART_SOURCE_STRING;
+  part.name = name;
+  part.value = contents;
+  part.size = -1;
+  part.hasContentType = false;
+  part.hasFileName = false;
+
+  this->parts.push_back(part);
+
+  return this->Build(this->parts.back());
+}
+
+CURLcode CurlMime::AddFile(const std::string& name, const std::string& file,
+                           const char* contentType, const char* fileName) {
+  Part part;
+  part.source = PART_SOURCE_FILE;
+  part.name = name;
+  part.value = file;
+  part.size = -1;
+  part.hasContentType = !!contentType;
+  part.contentType = contentType ? contentType : "";
+  part.hasFileName = !!fileName;
+  part.fileName = fileName ? fileName : "";
+
+  this->parts.push_back(part);
+
+  return this->Build(this->parts.back());
+}
+
+CURLcode CurlMime::Build(const Part& part) {
+  if (!this->mime) {
+    return CURLE_OUT_OF_MEMORY;
+  }
+
+  curl_mimepart* mimePart = curl_mime_addpart(this->mime);
+
+  if (!mimePart) {
+    return CURLE_OUT_OF_MEMORY;
+  }
+
+  CURLcode code = curl_mime_name(mimePart, part.name.c_str());
+
+  if (code != CURLE_OK) {
+    return code;
+  }
+
+  std::unique_ptr<Reader> reader;
+
+  switch (part.source) {
+    case PART_SOURCE_STRING:
+      code = curl_mime_data(mimePart, part.value.data(), part.value.size());
+      break;
+    case PART_SOURCE_VIEW:
+      reader.reset(new Reader());
+      reader->mime = this;
+      reader->data = part.contents->data;
+      reader->length = part.contents->length;
+      reader->position = 0;
+
+      code = curl_mime_data_cb(mimePart, static_cast<curl_off_t>(reader->length),
+                               CurlMime::ReadView, CurlMime::SeekView, NULL, reader.get());
+      break;
+    case PART_SOURCE_FILE:
+      code = curl_mime_filedata(mimePart, part.value.c_str());
+      break;
+    case PART_SOURCE_CALLBACK:
+      reader.reset(new Reader());
+      reader->mime = this;
+      reader->callback = part.callback;
+
+      code = curl_mime_data_cb(mimePart, part.size, CurlMime::ReadCallback, NULL, NULL,
+                               reader.get());
+      break;
+  }
+
+  if (reader) {
+    this->readers.push_back(std::move(reader));
+  }
+
+  if (code == CURLE_OK && part.hasContentType) {
+    code = curl_mime_type(mimePart, part.contentType.c_str());
+  }
+
+  if (code == CURLE_OK && part.hasFileName) {
+    code = curl_mime_filename(mimePart, part.fileName.c_str());
+  }
+
+  if (code == CURLE_OK && !part.headers.empty()) {
+    curl_slist* headers = NULL;
+
+    for (const std::string& header : part.headers) {
+      curl_slist* list = curl_slist_append(headers, header.c_str());
+
+      if (!list) {
+        curl_slist_free_all(headers);
+        return CURLE_OUT_OF_MEMORY;
+      }
+
+      headers = list;
+    }
+
+    // libcurl takes ownership of the list
+    code = curl_mime_headers(mimePart, headers, 1);
+  }
+
+  return code;
+}
+
+std::unique_ptr<CurlMime> CurlMime::Clone(Easy* easy, CURL* ch) const {
+  std::unique_ptr<CurlMime> clone(new CurlMime(easy, ch));
+
+  for (const Part& part : this->parts) {
+    clone->parts.push_back(part);
+
+    if (clone->Build(clone->parts.back()) != CURLE_OK) {
+      return nullptr;
+    }
+  }
+
+  return clone;
+}
+
+size_t CurlMime::ReadView(char* buffer, size_t size, size_t nitems, void* arg) {
+  Reader* reader = static_cast<Reader*>(arg);
+
+  size_t length = std::min(size * nitems, reader->length - reader->position);
+
+  std::memcpy(buffer, reader->data + reader->position, length);
+  reader->position += length;
+
+  return length;
+}
+
+int CurlMime::SeekView(void* arg, curl_off_t offset, int origin) {
+  Reader* reader = static_cast<Reader*>(arg);
+
+  // libcurl only rewinds the parts
+  if (origin != SEEK_SET || offset < 0 || static_cast<uint64_t>(offset) > reader->length) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+
+  reader->position = static_cast<size_t>(offset);
+
+  return CURL_SEEKFUNC_OK;
+}
+
+// same than Easy::ReadFunction when READFUNCTION is set
+size_t CurlMime::ReadCallback(char* buffer, size_t size, size_t nitems, void* arg) {
+  Reader* reader = static_cast<Reader*>(arg);
+  Easy* easy = reader->mime->easy;
+
+  size_t n = size * nitems;
+
+  Nan::HandleScope scope;
+
+  v8::Local<v8::Object> buf = Nan::NewBuffer(static_cast<uint32_t>(n)).ToLocalChecked();
+  const int argc = 3;
+  v8::Local<v8::Value> argv[argc] = {
+      buf,
+      Nan::New<v8::Uint32>(static_cast<uint32_t>(size)),
+      Nan::New<v8::Uint32>(static_cast<uint32_t>(nitems)),
+  };
+
+  Nan::TryCatch tryCatch;
+  Nan::MaybeLocal<v8::Value> returnValueCallback =
+      Nan::Call(*(reader->callback.get()), easy->handle(), argc, argv);
+
+  if (tryCatch.HasCaught()) {
+    if (easy->isInsideMultiHandle) {
+      easy->callbackError.Reset(tryCatch.Exception());
+    } else {
+      tryCatch.ReThrow();
+    }
+    return CURL_READFUNC_ABORT;
+  }
+
+  if (returnValueCallback.IsEmpty() || !returnValueCallback.ToLocalChecked()->IsInt32()) {
+    v8::Local<v8::Value> typeError =
+        Nan::TypeError("Return value from the MIMEPOST read callback must be an integer.");
+    if (easy->isInsideMultiHandle) {
+      easy->callbackError.Reset(typeError);
+    } else {
+      Nan::ThrowError(typeError);
+      tryCatch.ReThrow();
+    }
+    return CURL_READFUNC_ABORT;
+  }
+
+  int32_t returnValue = Nan::To<int32_t>(returnValueCallback.ToLocalChecked()).FromJust();
+
+  if (returnValue < 0) {
+    return CURL_READFUNC_ABORT;
+  }
+
+  if (returnValue == CURL_READFUNC_PAUSE) {
+    easy->pauseState |= CURLPAUSE_SEND;
+  }
+
+  if (returnValue == CURL_READFUNC_ABORT || returnValue == CURL_READFUNC_PAUSE) {
+    return static_cast<size_t>(returnValue);
+  }
+
+  size_t length = std::min(static_cast<size_t>(returnValue), n);
+  std::memcpy(buffer, node::Buffer::Data(buf), length);
+
+  return length;
+}
+
+bool CurlMime::HasCallbackParts() const {
+  for (const Part& part : this->parts) {
+    if (part.source == PART_SOURCE_CALLBACK) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace NodeLibcurl
+
+#endif
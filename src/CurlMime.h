@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_CURLMIME_H
+#define NODELIBCURL_CURLMIME_H
+
+#include "ViewContents.h"
+#include "macros.h"
+
+#include <curl/curl.h>
+#include <nan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+
+namespace NodeLibcurl {
+
+class Easy;
+
+// Multipart form built with the curl_mime API, set with MIMEPOST (and HTTPPOST).
+// Buffers / TypedArrays are sent straight from their memory, kept alive while the form is,
+// files are streamed from disk by libcurl, and parts can also be read from a js callback.
+// The parts are kept around, so the form can be sent by multiple requests, and duplicated
+// together with the handle.
+class CurlMime {
+  enum PartSource {
+    PART_SOURCE_STRING = 0,  // copied by libcurl
+    PART_SOURCE_VIEW,        // ArrayBufferView
+    PART_SOURCE_FILE,
+    PART_SOURCE_CALLBACK,
+  };
+
+  struct Part {
+    PartSource source;
+    std::string name;
+    std::string value;  // the string data, or the file path
+    std::shared_ptr<ViewContents> contents;  // of the ArrayBufferView
+    std::shared_ptr<Nan::Callback> callback;
+    curl_off_t size;  // of the data returned by the callback, -1 if unknown
+    bool hasContentType;
+    std::string contentType;
+    bool hasFileName;
+    std::string fileName;
+    std::vector<std::string> headers;
+  };
+
+  // state of a part read by one of the callbacks below while the form is being sent
+  struct Reader {
+    CurlMime* mime;
+    std::shared_ptr<Nan::Callback> callback;  // PART_SOURCE_CALLBACK
+    const char* data;                         // PART_SOURCE_VIEW
+    size_t length;
+    size_t position;
+  };
+
+  CurlMime(const CurlMime& that);
+  CurlMime& operator=(const CurlMime& that);
+
+  static size_t ReadView(char* buffer, size_t size, size_t nitems, void* arg);
+  static int SeekView(void* arg, curl_off_t offset, int origin);
+  static size_t ReadCallback(char* buffer, size_t size, size_t nitems, void* arg);
+
+  CURLcode Build(const Part& part);
+
+  CURL* ch;
+  std::vector<Part> parts;
+  std::vector<std::unique_ptr<Reader>> readers;
+
+ public:
+  CurlMime(Easy* easy, CURL* ch);
+
+  ~CurlMime();
+
+  // handle whose errors are used to report exceptions thrown by the callbacks
+  Easy* easy;
+  curl_mime* mime;
+
+  // adds a part described by a js object, see MimePart on the js side.
+  // Returns false, with a js exception thrown, if it is not valid.
+  bool AddPart(v8::Local<v8::Value> value);
+  // used by HTTPPOST, which has its own validation.
+  CURLcode AddField(const std::string& name, const std::string& contents);
+  CURLcode AddFile(const std::string& name, const std::string& file, const char* contentType,
+                   const char* fileName);
+
+  // same parts, to be set on another handle
+  std::unique_ptr<CurlMime> Clone(Easy* easy, CURL* ch) const;
+
+  // true if some part is read from a js callback
+  bool HasCallbackParts() const;
+};
+}  // namespace NodeLibcurl
+
+#endif
+#endif
@@ -0,0 +1,382 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "Digest.h"
+
+#include <cstring>
+
+namespace NodeLibcurl {
+
+namespace {
+inline uint32_t RotateLeft(uint32_t value, int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+inline uint32_t RotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+inline uint32_t ReadBigEndian(const unsigned char* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline uint32_t ReadLittleEndian(const unsigned char* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void WriteBigEndian(unsigned char* p, uint32_t value) {
+  p[0] = static_cast<unsigned char>(value >> 24);
+  p[1] = static_cast<unsigned char>(value >> 16);
+  p[2] = static_cast<unsigned char>(value >> 8);
+  p[3] = static_cast<unsigned char>(value);
+}
+
+inline void WriteLittleEndian(unsigned char* p, uint32_t value) {
+  p[0] = static_cast<unsigned char>(value);
+  p[1] = static_cast<unsigned char>(value >> 8);
+  p[2] = static_cast<unsigned char>(value >> 16);
+  p[3] = static_cast<unsigned char>(value >> 24);
+}
+
+// RFC 1321
+const uint32_t md5K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613,
+    0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193,
+    0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d,
+    0x02441453, 0xd8a1e681, 0xe7d3fbc8, 0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+    0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122,
+    0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665, 0xf4292244,
+    0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb,
+    0xeb86d391};
+
+const int md5Shifts[64] = {7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+                           5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20,
+                           4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+                           6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+void Md5ProcessBlock(uint32_t* h, const unsigned char* block) {
+  uint32_t m[16];
+  for (int i = 0; i < 16; i++) {
+    m[i] = ReadLittleEndian(block + i * 4);
+  }
+
+  uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t f;
+    int g;
+
+    if (i < 16) {
+      f = (b & c) | (~b & d);
+      g = i;
+    } else if (i < 32) {
+      f = (d & b) | (~d & c);
+      g = (5 * i + 1) % 16;
+    } else if (i < 48) {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) % 16;
+    } else {
+      f = c ^ (b | ~d);
+      g = (7 * i) % 16;
+    }
+
+    uint32_t temp = d;
+    d = c;
+    c = b;
+    b = b + RotateLeft(a + f + md5K[i] + m[g], md5Shifts[i]);
+    a = temp;
+  }
+
+  h[0] += a;
+  h[1] += b;
+  h[2] += c;
+  h[3] += d;
+}
+
+// FIPS 180-4
+void Sha1ProcessBlock(uint32_t* h, const unsigned char* block) {
+  uint32_t w[80];
+  for (int i = 0; i < 16; i++) {
+    w[i] = ReadBigEndian(block + i * 4);
+  }
+  for (int i = 16; i < 80; i++) {
+    w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+  }
+
+  uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+
+  for (int i = 0; i < 80; i++) {
+    uint32_t f, k;
+
+    if (i < 20) {
+      f = (b & c) | (~b & d);
+      k = 0x5a827999;
+    } else if (i < 40) {
+      f = b ^ c ^ d;
+      k = 0x6ed9eba1;
+    } else if (i < 60) {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8f1bbcdc;
+    } else {
+      f = b ^ c ^ d;
+      k = 0xca62c1d6;
+    }
+
+    uint32_t temp = RotateLeft(a, 5) + f + e + k + w[i];
+    e = d;
+    d = c;
+    c = RotateLeft(b, 30);
+    b = a;
+    a = temp;
+  }
+
+  h[0] += a;
+  h[1] += b;
+  h[2] += c;
+  h[3] += d;
+  h[4] += e;
+}
+
+const uint32_t sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+void Sha256ProcessBlock(uint32_t* h, const unsigned char* block) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = ReadBigEndian(block + i * 4);
+  }
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+    uint32_t ch = (e & f) ^ (~e & g);
+    uint32_t temp1 = hh + s1 + ch + sha256K[i] + w[i];
+    uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+    uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+    uint32_t temp2 = s0 + maj;
+
+    hh = g;
+    g = f;
+    f = e;
+    e = d + temp1;
+    d = c;
+    c = b;
+    b = a;
+    a = temp1 + temp2;
+  }
+
+  h[0] += a;
+  h[1] += b;
+  h[2] += c;
+  h[3] += d;
+  h[4] += e;
+  h[5] += f;
+  h[6] += g;
+  h[7] += hh;
+}
+
+// CRC-32C (Castagnoli), slicing by 8 bytes
+struct Crc32cTables {
+  uint32_t table[8][256];
+
+  Crc32cTables() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; j++) {
+        crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+      }
+      this->table[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int t = 1; t < 8; t++) {
+        this->table[t][i] =
+            (this->table[t - 1][i] >> 8) ^ this->table[0][this->table[t - 1][i] & 0xff];
+      }
+    }
+  }
+};
+
+const Crc32cTables& GetCrc32cTables() {
+  static const Crc32cTables tables;
+  return tables;
+}
+
+uint32_t Crc32cUpdate(uint32_t crc, const unsigned char* data, size_t length) {
+  const uint32_t(*table)[256] = GetCrc32cTables().table;
+
+  crc = ~crc;
+
+  while (length >= 8) {
+    uint32_t low = ReadLittleEndian(data) ^ crc;
+    uint32_t high = ReadLittleEndian(data + 4);
+
+    crc = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^ table[5][(low >> 16) & 0xff] ^
+          table[4][low >> 24] ^ table[3][high & 0xff] ^ table[2][(high >> 8) & 0xff] ^
+          table[1][(high >> 16) & 0xff] ^ table[0][high >> 24];
+
+    data += 8;
+    length -= 8;
+  }
+
+  while (length--) {
+    crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
+  }
+
+  return ~crc;
+}
+}  // namespace
+
+Digest::Digest() : algorithms(0) { this->Reset(); }
+
+void Digest::Reset() {
+  static const uint32_t md5Initial[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+  static const uint32_t sha1Initial[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+                                          0xc3d2e1f0};
+  static const uint32_t sha256Initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+  std::memset(&this->md5, 0, sizeof(this->md5));
+  std::memcpy(this->md5.h, md5Initial, sizeof(md5Initial));
+
+  std::memset(&this->sha1, 0, sizeof(this->sha1));
+  std::memcpy(this->sha1.h, sha1Initial, sizeof(sha1Initial));
+
+  std::memset(&this->sha256, 0, sizeof(this->sha256));
+  std::memcpy(this->sha256.h, sha256Initial, sizeof(sha256Initial));
+
+  this->crc32c = 0;
+}
+
+void Digest::Update(const char* data, size_t length) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+  if (this->algorithms & ALGORITHM_MD5) {
+    Digest::UpdateBlockState(this->md5, Md5ProcessBlock, bytes, length);
+  }
+
+  if (this->algorithms & ALGORITHM_SHA1) {
+    Digest::UpdateBlockState(this->sha1, Sha1ProcessBlock, bytes, length);
+  }
+
+  if (this->algorithms & ALGORITHM_SHA256) {
+    Digest::UpdateBlockState(this->sha256, Sha256ProcessBlock, bytes, length);
+  }
+
+  if (this->algorithms & ALGORITHM_CRC32C) {
+    this->crc32c = Crc32cUpdate(this->crc32c, bytes, length);
+  }
+}
+
+size_t Digest::Final(Algorithm algorithm, unsigned char* out) const {
+  // the state is copied, so more data can be added later on
+  BlockState state;
+
+  switch (algorithm) {
+    case ALGORITHM_MD5:
+      state = this->md5;
+      Digest::FinalBlockState(state, Md5ProcessBlock, false);
+      for (int i = 0; i < 4; i++) {
+        WriteLittleEndian(out + i * 4, state.h[i]);
+      }
+      return 16;
+    case ALGORITHM_SHA1:
+      state = this->sha1;
+      Digest::FinalBlockState(state, Sha1ProcessBlock, true);
+      for (int i = 0; i < 5; i++) {
+        WriteBigEndian(out + i * 4, state.h[i]);
+      }
+      return 20;
+    case ALGORITHM_SHA256:
+      state = this->sha256;
+      Digest::FinalBlockState(state, Sha256ProcessBlock, true);
+      for (int i = 0; i < 8; i++) {
+        WriteBigEndian(out + i * 4, state.h[i]);
+      }
+      return 32;
+    case ALGORITHM_CRC32C:
+      WriteBigEndian(out, this->crc32c);
+      return 4;
+  }
+
+  return 0;
+}
+
+void Digest::UpdateBlockState(BlockState& state, ProcessBlockFn processBlock,
+                              const unsigned char* data, size_t length) {
+  state.length += length;
+
+  if (state.blockLength > 0) {
+    size_t needed = sizeof(state.block) - state.blockLength;
+    size_t copied = length < needed ? length : needed;
+
+    std::memcpy(state.block + state.blockLength, data, copied);
+    state.blockLength += copied;
+    data += copied;
+    length -= copied;
+
+    if (state.blockLength < sizeof(state.block)) {
+      return;
+    }
+
+    processBlock(state.h, state.block);
+    state.blockLength = 0;
+  }
+
+  // full blocks are processed straight from the data
+  while (length >= sizeof(state.block)) {
+    processBlock(state.h, data);
+    data += sizeof(state.block);
+    length -= sizeof(state.block);
+  }
+
+  if (length > 0) {
+    std::memcpy(state.block, data, length);
+    state.blockLength = length;
+  }
+}
+
+void Digest::FinalBlockState(BlockState& state, ProcessBlockFn processBlock, bool isBigEndian) {
+  uint64_t bitLength = state.length * 8;
+
+  state.block[state.blockLength++] = 0x80;
+
+  if (state.blockLength > 56) {
+    std::memset(state.block + state.blockLength, 0, sizeof(state.block) - state.blockLength);
+    processBlock(state.h, state.block);
+    state.blockLength = 0;
+  }
+
+  std::memset(state.block + state.blockLength, 0, 56 - state.blockLength);
+
+  for (int i = 0; i < 8; i++) {
+    int shift = isBigEndian ? (56 - i * 8) : (i * 8);
+    state.block[56 + i] = static_cast<unsigned char>(bitLength >> shift);
+  }
+
+  processBlock(state.h, state.block);
+}
+
+}  // namespace NodeLibcurl
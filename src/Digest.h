@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_DIGEST_H
+#define NODELIBCURL_DIGEST_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace NodeLibcurl {
+
+// Computes digests of the body incrementally, while it is received.
+// Multiple algorithms can be enabled at once, each chunk is passed to all of them.
+class Digest {
+  // state shared by the Merkle–Damgård based algorithms, which all use 64 bytes blocks
+  struct BlockState {
+    uint32_t h[8];
+    uint64_t length;
+    unsigned char block[64];
+    size_t blockLength;
+  };
+
+  typedef void (*ProcessBlockFn)(uint32_t* h, const unsigned char* block);
+
+  static void UpdateBlockState(BlockState& state, ProcessBlockFn processBlock,
+                               const unsigned char* data, size_t length);
+  static void FinalBlockState(BlockState& state, ProcessBlockFn processBlock, bool isBigEndian);
+
+  BlockState md5;
+  BlockState sha1;
+  BlockState sha256;
+  uint32_t crc32c;
+
+ public:
+  enum Algorithm {
+    ALGORITHM_MD5 = 1 << 0,
+    ALGORITHM_SHA1 = 1 << 1,
+    ALGORITHM_SHA256 = 1 << 2,
+    ALGORITHM_CRC32C = 1 << 3,
+  };
+
+  static const uint32_t ALL_ALGORITHMS =
+      ALGORITHM_MD5 | ALGORITHM_SHA1 | ALGORITHM_SHA256 | ALGORITHM_CRC32C;
+  // size of the biggest digest, the SHA-256 one
+  static const size_t MAX_SIZE = 32;
+
+  // bitmask of the enabled algorithms
+  uint32_t algorithms;
+
+  Digest();
+
+  // starts over, without data
+  void Reset();
+  void Update(const char* data, size_t length);
+  // writes the digest of all data passed to Update to out, and returns its size.
+  // More data can still be added afterwards.
+  size_t Final(Algorithm algorithm, unsigned char* out) const;
+};
+}  // namespace NodeLibcurl
+#endif
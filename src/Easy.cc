@@ -8,7 +8,12 @@
 
 #include "Curl.h"
 #include "CurlHttpPost.h"
+#include "IsolateData.h"
+#include "JsonParseWorker.h"
+#include "Multi.h"
 #include "Share.h"
+#include "TextDecoding.h"
+#include "ViewContents.h"
 #include "make_unique.h"
 
 #include <algorithm>
@@ -17,32 +22,51 @@
 #include <cstring>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 // 36055 was allocated on Win64
 #define MEMORY_PER_HANDLE 30000
 
+// Content-Length values bigger than this are not used to pre-allocate the collected body
+#define COLLECT_MAX_PRESIZE (64 * 1024 * 1024)
+
 namespace NodeLibcurl {
 
+// Owns the values libcurl does not copy, like lists and POSTFIELDS, with one slot per option.
+// Setting an option again retires the value it had, which is only released when the next
+// transfer starts, since the one running may still be using it.
 class Easy::ToFree {
  public:
-  std::vector<std::vector<char> > str;
-  std::vector<curl_slist*> slist;
-  std::vector<std::unique_ptr<CurlHttpPost> > post;
+  typedef std::shared_ptr<const void> Value;
+
+  std::map<CURLoption, Value> slots;
+  std::vector<Value> retired;
 
-  ~ToFree() {
-    for (unsigned int i = 0; i < slist.size(); i++) {
-      curl_slist_free_all(slist[i]);
+  void Set(CURLoption option, Value value) {
+    Value& slot = this->slots[option];
+
+    if (slot && slot != value) {
+      this->retired.push_back(std::move(slot));
+    }
+
+    slot = std::move(value);
+  }
+
+  void Unset(CURLoption option) {
+    std::map<CURLoption, Value>::iterator it = this->slots.find(option);
+
+    if (it != this->slots.end()) {
+      this->retired.push_back(std::move(it->second));
+      this->slots.erase(it);
     }
   }
-};
 
-Nan::Persistent<v8::FunctionTemplate> Easy::constructor;
-Nan::Persistent<v8::String> Easy::onDataCbSymbol;
-Nan::Persistent<v8::String> Easy::onHeaderCbSymbol;
+  void ReleaseRetired() { this->retired.clear(); }
+};
 
-uint32_t Easy::counter = 0;
-uint32_t Easy::currentOpenedHandles = 0;
+std::atomic<uint32_t> Easy::counter(0);
+std::atomic<uint32_t> Easy::currentOpenedHandles(0);
 
 Easy::Easy() {
   this->ch = curl_easy_init();
@@ -87,7 +111,23 @@ Easy::Easy(Easy* orig) {
   // no need to reset the _DATA option for the READ, SEEK and WRITE callbacks,
   // since they are reset on ResetRequiredHandleOptions()
 
-  this->toFree = orig->toFree;
+  // the values are shared, the duplicated handle uses the same ones
+  this->toFree = std::make_shared<Easy::ToFree>(*orig->toFree);
+
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+  // the form copied by libcurl would share the state of its parts with the original one
+  if (orig->mimePost) {
+    this->mimePost = orig->mimePost->Clone(this, this->ch);
+    curl_easy_setopt(this->ch, CURLOPT_MIMEPOST,
+                     this->mimePost ? this->mimePost->mime : static_cast<curl_mime*>(NULL));
+  }
+#endif
+
+  this->writeMode = orig->writeMode;
+  this->headerMode = orig->headerMode;
+  this->isBufferPoolingEnabled = orig->isBufferPoolingEnabled;
+  this->isPostFieldsSizeFromView = orig->isPostFieldsSizeFromView;
+  this->digest.algorithms = orig->digest.algorithms;
 
   this->ResetRequiredHandleOptions();
 
@@ -128,10 +168,19 @@ void Easy::Dispose() {
   assert(this->isOpen && "This handle was already closed.");
   assert(this->ch && "The curl handle ran away.");
 
+  // the Multi instance must not keep a reference to this handle after it's freed
+  if (this->multi) {
+    this->multi->RemoveEasy(this);
+  }
+
   curl_easy_cleanup(this->ch);
 
   NODE_LIBCURL_ADJUST_MEM(-MEMORY_PER_HANDLE);
 
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+  this->mimePost.reset();
+#endif
+
   if (this->isMonitoringSockets) {
     this->UnmonitorSockets();
   }
@@ -140,9 +189,152 @@ void Easy::Dispose() {
 
   this->callbackError.Reset();
 
+  this->bufferSource.reset();
+  this->uploadQueue.reset();
+
+  this->collectedData.Clear();
+  this->pendingData.Clear();
+
+  if (this->fileSink) {
+    this->fileSink->Detach();
+    this->fileSink = nullptr;
+  }
+
+  if (this->ringSink) {
+    this->ringSink->Detach();
+    this->ringSink = nullptr;
+  }
+
+  if (this->fileSource) {
+    this->fileSource->Detach();
+    this->fileSource = nullptr;
+  }
+
   --Easy::currentOpenedHandles;
 }
 
+void Easy::PrepareTransfer() {
+  // the options were set to other values, so libcurl does not use the previous ones anymore
+  this->toFree->ReleaseRetired();
+
+  // data from a previous transfer that was not taken is discarded
+  this->collectedData.Clear();
+  this->isCollectedDataPresized = false;
+
+  this->pendingData.Clear();
+  this->hasPendingDataError = false;
+
+  this->headerParser.Clear();
+  this->digest.Reset();
+
+  // libcurl starts each transfer unpaused
+  this->pauseState = CURLPAUSE_CONT;
+
+  if (this->fileSink) {
+    this->fileSink->Prepare();
+  }
+  this->isCompletionDeferred = false;
+
+  if (this->ringSink) {
+    this->ringSink->Prepare();
+  }
+
+  if (this->fileSource) {
+    this->fileSource->Prepare();
+  }
+
+  if (this->bufferSource) {
+    this->bufferSource->Prepare();
+  }
+
+  if (this->uploadQueue) {
+    this->uploadQueue->Prepare();
+  }
+}
+
+void Easy::EndTransfer() {
+  // lets the consumer know there is no more data coming
+  if (this->ringSink) {
+    this->ringSink->End();
+  }
+}
+
+bool Easy::CanRunOnThread(const char*& reason) const {
+  if (!this->callbacks.empty() || this->cbOnSocketEvent || this->isMonitoringSockets) {
+    reason = "it has js callbacks set.";
+  } else if (this->writeMode != WRITE_MODE_COLLECT || this->fileSink || this->ringSink) {
+    reason = "the write mode must be EasyWriteMode.Collect, without WRITEDATA or a write ring.";
+  } else if (this->headerMode != HEADER_MODE_PARSE) {
+    reason = "the header mode must be EasyHeaderMode.Parse.";
+  } else if (this->fileSource || this->uploadQueue) {
+    reason = "only setUploadBuffer and setUploadFile can be used for uploads.";
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+  } else if (this->mimePost && this->mimePost->HasCallbackParts()) {
+    reason = "MIMEPOST has parts read from a callback.";
+#endif
+  } else {
+    return true;
+  }
+
+  return false;
+}
+
+CURLcode Easy::GetTransferResult(CURLcode code) {
+  // libcurl is not aware that the js callback did not accept the coalesced data,
+  // or that writing to the WRITEDATA file failed after it finished.
+  if (code == CURLE_OK &&
+      (this->hasPendingDataError || (this->fileSink && this->fileSink->errorCode < 0))) {
+    return CURLE_WRITE_ERROR;
+  }
+
+  return code;
+}
+
+void Easy::PauseDirection(int direction) {
+  this->pauseState |= direction;
+  curl_easy_pause(this->ch, this->pauseState);
+}
+
+void Easy::ResumeDirection(int direction) {
+  // libcurl can call the callbacks again from inside curl_easy_pause, which may pause it again
+  this->pauseState &= ~direction;
+  curl_easy_pause(this->ch, this->pauseState);
+}
+
+bool Easy::DeferCompletion(CURLcode code) {
+  if (!this->fileSink || !this->fileSink->IsBusy()) {
+    return false;
+  }
+
+  this->isCompletionDeferred = true;
+  this->deferredCompletionCode = code;
+
+  return true;
+}
+
+void Easy::OnFileSinkDrained() {
+  if (!this->isCompletionDeferred) {
+    return;
+  }
+
+  this->isCompletionDeferred = false;
+
+  if (this->multi) {
+    this->multi->CallOnMessageCallback(this->ch, this->deferredCompletionCode);
+  }
+}
+
+void Easy::OnRemovedFromMulti() {
+  this->isInsideMultiHandle = false;
+  this->multi = nullptr;
+  this->isCompletionDeferred = false;
+
+  // the transfer is not going to finish, if it did not already
+  if (this->ringSink) {
+    this->ringSink->Abort();
+  }
+}
+
 void Easy::MonitorSockets() {
   int retUv;
   CURLcode retCurl;
@@ -177,7 +369,7 @@ void Easy::MonitorSockets() {
 
   this->socketPollHandle = new uv_poll_t;
 
-  retUv = uv_poll_init_socket(uv_default_loop(), this->socketPollHandle, socket);
+  retUv = uv_poll_init_socket(IsolateData::Current()->loop, this->socketPollHandle, socket);
 
   if (retUv < 0) {
     std::string errorMsg;
@@ -244,31 +436,51 @@ void Easy::CallSocketEvent(int status, int events) {
 // Called by libcurl when some chunk of data (from body) is available
 size_t Easy::WriteFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
   Easy* obj = static_cast<Easy*>(userdata);
-  return obj->OnData(ptr, size, nmemb);
+  size_t ret = obj->OnData(ptr, size, nmemb);
+
+  // libcurl paused receiving by itself
+  if (ret == CURL_WRITEFUNC_PAUSE) {
+    obj->pauseState |= CURLPAUSE_RECV;
+  }
+
+  return ret;
 }
 
 // Called by libcurl when some chunk of data (from headers) is available
 size_t Easy::HeaderFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
   Easy* obj = static_cast<Easy*>(userdata);
-  return obj->OnHeader(ptr, size, nmemb);
+  size_t ret = obj->OnHeader(ptr, size, nmemb);
+
+  if (ret == CURL_WRITEFUNC_PAUSE) {
+    obj->pauseState |= CURLPAUSE_RECV;
+  }
+
+  return ret;
 }
 
 // Called by libcurl as soon as it needs to read data in order to send it to the
 // peer
 size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata) {
-  uv_fs_t readReq;
+  Easy* obj = static_cast<Easy*>(userdata);
+  size_t ret = obj->OnRead(ptr, size, nmemb);
 
-  int32_t returnValue = CURL_READFUNC_ABORT;
+  // libcurl paused sending by itself
+  if (ret == CURL_READFUNC_PAUSE) {
+    obj->pauseState |= CURLPAUSE_SEND;
+  }
 
-  Easy* obj = static_cast<Easy*>(userdata);
-  int32_t fd = obj->readDataFileDescriptor;
+  return ret;
+}
+
+size_t Easy::OnRead(char* ptr, size_t size, size_t nmemb) {
+  int32_t returnValue = CURL_READFUNC_ABORT;
 
   size_t n = size * nmemb;
 
-  CallbacksMap::iterator it = obj->callbacks.find(CURLOPT_READFUNCTION);
+  CallbacksMap::iterator it = this->callbacks.find(CURLOPT_READFUNCTION);
 
   // Read callback was set, use it instead
-  if (it != obj->callbacks.end()) {
+  if (it != this->callbacks.end()) {
     Nan::HandleScope scope;
 
     v8::Local<v8::Object> buf = Nan::NewBuffer(static_cast<uint32_t>(n)).ToLocalChecked();
@@ -283,11 +495,11 @@ size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata)
 
     Nan::TryCatch tryCatch;
     Nan::MaybeLocal<v8::Value> returnValueCallback =
-        Nan::Call(*(it->second.get()), obj->handle(), argc, argv);
+        Nan::Call(*(it->second.get()), this->handle(), argc, argv);
 
     if (tryCatch.HasCaught()) {
-      if (obj->isInsideMultiHandle) {
-        obj->callbackError.Reset(tryCatch.Exception());
+      if (this->isInsideMultiHandle) {
+        this->callbackError.Reset(tryCatch.Exception());
       } else {
         tryCatch.ReThrow();
       }
@@ -297,8 +509,8 @@ size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata)
     if (returnValueCallback.IsEmpty() || !returnValueCallback.ToLocalChecked()->IsInt32()) {
       v8::Local<v8::Value> typeError =
           Nan::TypeError("Return value from the READ callback must be an integer.");
-      if (obj->isInsideMultiHandle) {
-        obj->callbackError.Reset(typeError);
+      if (this->isInsideMultiHandle) {
+        this->callbackError.Reset(typeError);
       } else {
         Nan::ThrowError(typeError);
         tryCatch.ReThrow();
@@ -317,26 +529,38 @@ size_t Easy::ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata)
     }
 
     // otherwise use the default read callback
+  } else if (this->bufferSource) {
+    // setUploadBuffer or setUploadFile was called, the data comes straight from memory
+    return this->bufferSource->Read(ptr, n);
+  } else if (this->uploadQueue) {
+    // setUploadQueue was called, the data is pushed from js
+    size_t length = this->uploadQueue->Read(ptr, n, this->multi != nullptr);
+
+    if (this->uploadQueue->TakeDrain()) {
+      Nan::HandleScope scope;
+      Nan::TryCatch tryCatch;
+
+      Nan::Call(this->uploadQueue->onDrain, this->handle(), 0, nullptr);
+
+      if (tryCatch.HasCaught()) {
+        if (this->isInsideMultiHandle) {
+          this->callbackError.Reset(tryCatch.Exception());
+        } else {
+          tryCatch.ReThrow();
+        }
+        return CURL_READFUNC_ABORT;
+      }
+    }
+
+    return length;
   } else {
     // abort early if we don't have a file descriptor
-    if (fd == -1) {
+    if (!this->fileSource) {
       return CURL_READFUNC_ABORT;
     }
 
-    // get the offset
-    curl_off_t offset = obj->readDataOffset;
-    if (offset >= 0) {
-      // increment it for the next read
-      obj->readDataOffset += n;
-    }
-
-#if UV_VERSION_MAJOR < 1
-    returnValue = uv_fs_read(uv_default_loop(), &readReq, fd, ptr, n, offset, NULL);
-#else
-    uv_buf_t uvbuf = uv_buf_init(ptr, (unsigned int)(n));
-
-    returnValue = uv_fs_read(uv_default_loop(), &readReq, fd, &uvbuf, 1, offset, NULL);
-#endif
+    // inside a Multi instance the file is read ahead on the threadpool
+    return this->fileSource->Read(ptr, n, this->multi != nullptr);
   }
 
   if (returnValue < 0) {
@@ -401,8 +625,17 @@ size_t Easy::SeekFunction(void* userdata, curl_off_t offset, int origin) {
     }
 
     // otherwise use the default seek callback
+  } else if (obj->bufferSource) {
+    returnValue = obj->bufferSource->Seek(static_cast<int64_t>(offset)) ? CURL_SEEKFUNC_OK
+                                                                        : CURL_SEEKFUNC_FAIL;
+  } else if (obj->fileSource) {
+    obj->fileSource->Seek(static_cast<int64_t>(offset));
+    returnValue = CURL_SEEKFUNC_OK;
+  } else if (obj->uploadQueue) {
+    // the chunks already read were released
+    returnValue = CURL_SEEKFUNC_CANTSEEK;
   } else {
-    obj->readDataOffset = offset;
+    // nothing is read by the default read callback, there is no position to move
     returnValue = CURL_SEEKFUNC_OK;
   }
 
@@ -410,23 +643,69 @@ size_t Easy::SeekFunction(void* userdata, curl_off_t offset, int origin) {
 }
 
 size_t Easy::OnData(char* data, size_t size, size_t nmemb) {
+  size_t n = size * nmemb;
+  size_t ret;
+
+  if (this->fileSink) {
+    // WRITEDATA was set, the body goes straight to the file
+    ret = this->fileSink->Write(data, n, this->multi != nullptr);
+  } else if (this->ringSink) {
+    // setWriteRing was called, the body is copied into the SharedArrayBuffer
+    ret = this->ringSink->Write(data, n, this->multi != nullptr);
+  } else if (this->writeMode == WRITE_MODE_COLLECT) {
+    ret = this->CollectData(data, n);
+  } else if (this->writeMode == WRITE_MODE_COALESCE) {
+    ret = this->CoalesceData(data, n);
+  } else {
+    ret = this->CallDataCallback(data, size, nmemb, false);
+  }
+
+  // chunks that paused the transfer are going to be passed again, only hash accepted ones
+  if (this->digest.algorithms && ret == n) {
+    this->digest.Update(data, n);
+  }
+
+  return ret;
+}
+
+// calls WRITEFUNCTION or the onData property with the given chunk.
+// If isDataOwned is true, data must have been allocated with malloc, and its ownership
+// is moved to the Buffer passed to js.
+size_t Easy::CallDataCallback(char* data, size_t size, size_t nmemb, bool isDataOwned) {
   Nan::HandleScope scope;
 
   size_t n = size * nmemb;
 
   CallbacksMap::iterator it = this->callbacks.find(CURLOPT_WRITEFUNCTION);
   v8::Local<v8::Value> cbOnData =
-      Nan::Get(this->handle(), Nan::New(Easy::onDataCbSymbol)).ToLocalChecked();
+      Nan::Get(this->handle(), Nan::New(IsolateData::Current()->onDataCbSymbol)).ToLocalChecked();
 
   bool hasWriteCallback = (it != this->callbacks.end());
 
   // No callback is set
   if (!hasWriteCallback && cbOnData->IsUndefined()) {
+    if (isDataOwned) {
+      std::free(data);
+    }
     return n;
   }
 
+  v8::Local<v8::Object> buf;
+
+  if (isDataOwned) {
+    Nan::MaybeLocal<v8::Object> maybeBuf = Nan::NewBuffer(data, static_cast<uint32_t>(n));
+
+    if (maybeBuf.IsEmpty()) {
+      std::free(data);
+      return 0;
+    }
+
+    buf = maybeBuf.ToLocalChecked();
+  } else {
+    buf = this->NewChunkBuffer(data, n);
+  }
+
   const int argc = 3;
-  v8::Local<v8::Object> buf = Nan::CopyBuffer(data, static_cast<uint32_t>(n)).ToLocalChecked();
   v8::Local<v8::Uint32> sizeArg = Nan::New<v8::Uint32>(static_cast<uint32_t>(size));
   v8::Local<v8::Uint32> nmembArg = Nan::New<v8::Uint32>(static_cast<uint32_t>(nmemb));
 
@@ -452,14 +731,100 @@ size_t Easy::OnData(char* data, size_t size, size_t nmemb) {
   return ret;
 }
 
-size_t Easy::OnHeader(char* data, size_t size, size_t nmemb) {
-  Nan::HandleScope scope;
+size_t Easy::CollectData(const char* data, size_t n) {
+  // first chunk of the body, the headers are already known, so we can try to allocate
+  // all the memory needed at once.
+  if (!this->isCollectedDataPresized) {
+    this->isCollectedDataPresized = true;
+
+    curl_off_t contentLength = -1;
+#if NODE_LIBCURL_VER_GE(7, 55, 0)
+    curl_easy_getinfo(this->ch, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength);
+#else
+    double contentLengthDouble = -1;
+    curl_easy_getinfo(this->ch, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &contentLengthDouble);
+    contentLength = static_cast<curl_off_t>(contentLengthDouble);
+#endif
+
+    // this is just a hint, if it fails Append is going to try again with a smaller size
+    if (contentLength > 0 && contentLength <= COLLECT_MAX_PRESIZE) {
+      this->collectedData.Reserve(this->collectedData.length + static_cast<size_t>(contentLength));
+    }
+  }
+
+  // returning something different than n makes libcurl abort the transfer with CURLE_WRITE_ERROR
+  if (!this->collectedData.Append(data, n)) {
+    return 0;
+  }
+
+  return n;
+}
+
+size_t Easy::CoalesceData(const char* data, size_t n) {
+  // a previous flush was not accepted by the js callback
+  if (this->hasPendingDataError) {
+    return 0;
+  }
+
+  if (!this->pendingData.Append(data, n)) {
+    return 0;
+  }
+
+  // the Multi handle flushes it after the current curl_multi_socket_action call returns,
+  // otherwise it's flushed when curl_easy_perform returns.
+  if (this->multi && !this->isPendingDataQueued) {
+    this->isPendingDataQueued = true;
+    this->multi->QueuePendingData(this);
+  }
+
+  return n;
+}
+
+// passes all data received since the last flush to the js callback at once
+void Easy::FlushPendingData() {
+  this->isPendingDataQueued = false;
+
+  size_t length = this->pendingData.length;
+
+  if (!length || !this->isOpen) {
+    return;
+  }
+
+  // the memory is moved to the Buffer, no copy is made
+  size_t ret = this->CallDataCallback(this->pendingData.Release(), 1, length, true);
+
+  // libcurl already considers this data as delivered, so we cannot return CURL_WRITEFUNC_PAUSE
+  // or abort from the write callback anymore. Instead pause the transfer directly, or fail it
+  // the next time data arrives or when it finishes.
+  if (ret == CURL_WRITEFUNC_PAUSE) {
+    this->PauseDirection(CURLPAUSE_RECV);
+  } else if (ret != length) {
+    this->hasPendingDataError = true;
+  }
+}
+
+// Buffer passed to the js callbacks receiving data from libcurl
+v8::Local<v8::Object> Easy::NewChunkBuffer(const char* data, size_t length) {
+  if (this->isBufferPoolingEnabled) {
+    return IsolateData::Current()->bufferPool->NewBuffer(data, length);
+  }
+
+  return Nan::CopyBuffer(data, static_cast<uint32_t>(length)).ToLocalChecked();
+}
 
+size_t Easy::OnHeader(char* data, size_t size, size_t nmemb) {
   size_t n = size * nmemb;
 
+  if (this->headerMode == HEADER_MODE_PARSE) {
+    this->headerParser.Parse(data, n);
+    return n;
+  }
+
+  Nan::HandleScope scope;
+
   CallbacksMap::iterator it = this->callbacks.find(CURLOPT_HEADERFUNCTION);
   v8::Local<v8::Value> cbOnHeader =
-      Nan::Get(this->handle(), Nan::New(Easy::onHeaderCbSymbol)).ToLocalChecked();
+      Nan::Get(this->handle(), Nan::New(IsolateData::Current()->onHeaderCbSymbol)).ToLocalChecked();
 
   bool hasHeaderCallback = (it != this->callbacks.end());
 
@@ -469,7 +834,7 @@ size_t Easy::OnHeader(char* data, size_t size, size_t nmemb) {
   }
 
   const int argc = 3;
-  v8::Local<v8::Object> buf = Nan::CopyBuffer(data, static_cast<uint32_t>(n)).ToLocalChecked();
+  v8::Local<v8::Object> buf = this->NewChunkBuffer(data, n);
   v8::Local<v8::Uint32> sizeArg = Nan::New<v8::Uint32>(static_cast<uint32_t>(size));
   v8::Local<v8::Uint32> nmembArg = Nan::New<v8::Uint32>(static_cast<uint32_t>(nmemb));
 
@@ -551,6 +916,69 @@ v8::Local<v8::Object> Easy::CreateV8ObjectFromCurlFileInfo(curl_fileinfo* fileIn
   return scope.Escape(obj);
 }
 
+// creates an array of objects with the same format than the one returned by lib/parseHeaders.ts
+v8::Local<v8::Array> Easy::CreateV8ArrayFromHeaderParser(const HeaderParser& parser) {
+  Nan::EscapableHandleScope scope;
+
+  v8::Local<v8::String> resultKey = Nan::New("result").ToLocalChecked();
+  v8::Local<v8::String> versionKey = Nan::New("version").ToLocalChecked();
+  v8::Local<v8::String> codeKey = Nan::New("code").ToLocalChecked();
+  v8::Local<v8::String> reasonKey = Nan::New("reason").ToLocalChecked();
+  v8::Local<v8::String> setCookieKey = Nan::New("Set-Cookie").ToLocalChecked();
+
+  const char* text = parser.text.data();
+  uint32_t groupsLength = static_cast<uint32_t>(parser.groups.size());
+
+  v8::Local<v8::Array> groups = Nan::New<v8::Array>(groupsLength);
+
+  for (uint32_t i = 0; i < groupsLength; i++) {
+    const HeaderParser::Group& group = parser.groups[i];
+
+    v8::Local<v8::Object> headers = Nan::New<v8::Object>();
+    v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+    Nan::Set(result, versionKey,
+             Nan::New(text + group.version.offset, static_cast<int>(group.version.length))
+                 .ToLocalChecked());
+    Nan::Set(result, codeKey, Nan::New<v8::Number>(group.code));
+    Nan::Set(result, reasonKey,
+             Nan::New(text + group.reason.offset, static_cast<int>(group.reason.length))
+                 .ToLocalChecked());
+
+    Nan::Set(headers, resultKey, result);
+
+    v8::Local<v8::Array> setCookie;
+
+    for (std::vector<HeaderParser::Field>::const_iterator it = group.fields.begin(),
+                                                          end = group.fields.end();
+         it != end; ++it) {
+      v8::Local<v8::Value> value = Nan::Undefined();
+
+      if (it->hasValue) {
+        value = Nan::New(text + it->value.offset, static_cast<int>(it->value.length))
+                    .ToLocalChecked();
+      }
+
+      if (it->isSetCookie) {
+        if (setCookie.IsEmpty()) {
+          setCookie = Nan::New<v8::Array>();
+          Nan::Set(headers, setCookieKey, setCookie);
+        }
+
+        Nan::Set(setCookie, setCookie->Length(), value);
+      } else {
+        Nan::Set(headers,
+                 Nan::New(text + it->key.offset, static_cast<int>(it->key.length)).ToLocalChecked(),
+                 value);
+      }
+    }
+
+    Nan::Set(groups, i, headers);
+  }
+
+  return scope.Escape(groups);
+}
+
 long Easy::CbChunkBgn(curl_fileinfo* transferInfo, void* ptr, int remains) {  // NOLINT(runtime/int)
   Easy* obj = static_cast<Easy*>(ptr);
 
@@ -645,7 +1073,7 @@ int Easy::CbDebug(CURL* handle, curl_infotype type, char* data, size_t size, voi
   assert(it != obj->callbacks.end() && "DEBUG callback not set.");
 
   const int argc = 2;
-  v8::Local<v8::Object> buf = Nan::CopyBuffer(data, static_cast<uint32_t>(size)).ToLocalChecked();
+  v8::Local<v8::Object> buf = obj->NewChunkBuffer(data, size);
   v8::Local<v8::Value> argv[] = {
       Nan::New<v8::Integer>(type),
       buf,
@@ -936,6 +1364,8 @@ NAN_MODULE_INIT(Easy::Initialize) {
 
   // prototype methods
   Nan::SetPrototypeMethod(tmpl, "setOpt", Easy::SetOpt);
+  Nan::SetPrototypeMethod(tmpl, "setOpts", Easy::SetOpts);
+  Nan::SetPrototypeMethod(tmpl, "applyTemplate", Easy::ApplyTemplate);
   Nan::SetPrototypeMethod(tmpl, "getInfo", Easy::GetInfo);
   Nan::SetPrototypeMethod(tmpl, "send", Easy::Send);
   Nan::SetPrototypeMethod(tmpl, "recv", Easy::Recv);
@@ -944,6 +1374,23 @@ NAN_MODULE_INIT(Easy::Initialize) {
   Nan::SetPrototypeMethod(tmpl, "pause", Easy::Pause);
   Nan::SetPrototypeMethod(tmpl, "reset", Easy::Reset);
   Nan::SetPrototypeMethod(tmpl, "dupHandle", Easy::DupHandle);
+  Nan::SetPrototypeMethod(tmpl, "setWriteMode", Easy::SetWriteMode);
+  Nan::SetPrototypeMethod(tmpl, "takeCollectedData", Easy::TakeCollectedData);
+  Nan::SetPrototypeMethod(tmpl, "takeCollectedDataAsString", Easy::TakeCollectedDataAsString);
+  Nan::SetPrototypeMethod(tmpl, "takeCollectedDataAsJson", Easy::TakeCollectedDataAsJson);
+  Nan::SetPrototypeMethod(tmpl, "setBufferPooling", Easy::SetBufferPooling);
+  Nan::SetPrototypeMethod(tmpl, "setHeaderMode", Easy::SetHeaderMode);
+  Nan::SetPrototypeMethod(tmpl, "takeParsedHeaders", Easy::TakeParsedHeaders);
+  Nan::SetPrototypeMethod(tmpl, "setWriteDataOffset", Easy::SetWriteDataOffset);
+  Nan::SetPrototypeMethod(tmpl, "setWriteRing", Easy::SetWriteRing);
+  Nan::SetPrototypeMethod(tmpl, "writeRingConsumed", Easy::WriteRingConsumed);
+  Nan::SetPrototypeMethod(tmpl, "setUploadBuffer", Easy::SetUploadBuffer);
+  Nan::SetPrototypeMethod(tmpl, "setUploadFile", Easy::SetUploadFile);
+  Nan::SetPrototypeMethod(tmpl, "setUploadQueue", Easy::SetUploadQueue);
+  Nan::SetPrototypeMethod(tmpl, "writeUploadQueue", Easy::WriteUploadQueue);
+  Nan::SetPrototypeMethod(tmpl, "endUploadQueue", Easy::EndUploadQueue);
+  Nan::SetPrototypeMethod(tmpl, "setDigests", Easy::SetDigests);
+  Nan::SetPrototypeMethod(tmpl, "getDigest", Easy::GetDigest);
   Nan::SetPrototypeMethod(tmpl, "onSocketEvent", Easy::OnSocketEvent);
   Nan::SetPrototypeMethod(tmpl, "monitorSocketEvents", Easy::MonitorSocketEvents);
   Nan::SetPrototypeMethod(tmpl, "unmonitorSocketEvents", Easy::UnmonitorSocketEvents);
@@ -951,17 +1398,21 @@ NAN_MODULE_INIT(Easy::Initialize) {
 
   // static methods
   Nan::SetMethod(tmpl, "strError", Easy::StrError);
+  Nan::SetMethod(tmpl, "getBufferPoolStats", Easy::GetBufferPoolStats);
+  Nan::SetMethod(tmpl, "releasePooledBuffer", Easy::ReleasePooledBuffer);
 
   Nan::SetAccessor(proto, Nan::New("id").ToLocalChecked(), Easy::IdGetter, 0,
                    v8::Local<v8::Value>(), v8::DEFAULT, v8::ReadOnly);
   Nan::SetAccessor(proto, Nan::New("isInsideMultiHandle").ToLocalChecked(),
                    Easy::IsInsideMultiHandleGetter, 0, v8::Local<v8::Value>(), v8::DEFAULT,
                    v8::ReadOnly);
+  Nan::SetAccessor(proto, Nan::New("pauseState").ToLocalChecked(), Easy::PauseStateGetter, 0,
+                   v8::Local<v8::Value>(), v8::DEFAULT, v8::ReadOnly);
 
-  Easy::constructor.Reset(tmpl);
+  IsolateData::Current()->easyConstructor.Reset(tmpl);
 
-  Easy::onDataCbSymbol.Reset(Nan::New("onData").ToLocalChecked());
-  Easy::onHeaderCbSymbol.Reset(Nan::New("onHeader").ToLocalChecked());
+  IsolateData::Current()->onDataCbSymbol.Reset(Nan::New("onData").ToLocalChecked());
+  IsolateData::Current()->onHeaderCbSymbol.Reset(Nan::New("onHeader").ToLocalChecked());
 
   Nan::Set(target, Nan::New("Easy").ToLocalChecked(), Nan::GetFunction(tmpl).ToLocalChecked());
 }
@@ -976,7 +1427,8 @@ NAN_METHOD(Easy::New) {
 
   // Copy constructor, used when duplicating handles.
   if (!jsHandle->IsUndefined()) {
-    if (!jsHandle->IsObject() || !Nan::New(Easy::constructor)->HasInstance(jsHandle)) {
+    if (!jsHandle->IsObject() ||
+        !Nan::New(IsolateData::Current()->easyConstructor)->HasInstance(jsHandle)) {
       Nan::ThrowError(Nan::TypeError("Argument must be an instance of an Easy handle."));
       return;
     }
@@ -1007,67 +1459,117 @@ NAN_GETTER(Easy::IsInsideMultiHandleGetter) {
   info.GetReturnValue().Set(Nan::New(obj->isInsideMultiHandle));
 }
 
-NAN_METHOD(Easy::SetOpt) {
-  Nan::HandleScope scope;
-
+NAN_GETTER(Easy::PauseStateGetter) {
   Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
 
-  if (!obj->isOpen) {
-    Nan::ThrowError("Curl handle is closed.");
-    return;
-  }
-
-  v8::Local<v8::Value> opt = info[0];
-  v8::Local<v8::Value> value = info[1];
+  info.GetReturnValue().Set(Nan::New(obj->pauseState));
+}
 
+// sets a single option, returns false if a js exception was thrown, otherwise the code returned
+// by libcurl is stored in code.
+bool Easy::SetOptValue(Easy* obj, v8::Local<v8::Value> opt, v8::Local<v8::Value> value,
+                       CURLcode& code) {
   CURLcode setOptRetCode = CURLE_UNKNOWN_OPTION;
 
-  int optionId;
+  int32_t optionId = 0;
+  int optionTable = curlOptionIndex.Find(opt, optionId);
 
-  if ((optionId = IsInsideCurlConstantStruct(curlOptionNotImplemented, opt))) {
+  if (optionTable == CURL_OPTION_NOT_IMPLEMENTED) {
     Nan::ThrowError(
         "Unsupported option, probably because it's too complex to implement "
         "using javascript or unecessary when using javascript (like the _DATA "
         "options).");
-    return;
-  } else if ((optionId = IsInsideCurlConstantStruct(curlOptionSpecific, opt))) {
+    return false;
+  } else if (optionTable == CURL_OPTION_SPECIFIC) {
     switch (optionId) {
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+      case CURLOPT_MIMEPOST:
+        if (value->IsNull()) {
+          setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_MIMEPOST, NULL);
+
+          if (setOptRetCode == CURLE_OK) {
+            obj->mimePost.reset();
+          }
+        } else {
+          if (!value->IsArray()) {
+            Nan::ThrowTypeError("MIMEPOST option value should be an Array of Objects.");
+            return false;
+          }
+
+          v8::Local<v8::Array> parts = value.As<v8::Array>();
+
+          std::unique_ptr<CurlMime> mimePost = std::make_unique<CurlMime>(obj, obj->ch);
+
+          for (uint32_t i = 0, len = parts->Length(); i < len; ++i) {
+            // exception already thrown
+            if (!mimePost->AddPart(Nan::Get(parts, i).ToLocalChecked())) {
+              return false;
+            }
+          }
+
+          setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_MIMEPOST, mimePost->mime);
+
+          if (setOptRetCode == CURLE_OK) {
+            obj->mimePost = std::move(mimePost);
+          }
+        }
+        break;
+#endif
       case CURLOPT_SHARE:
         if (value->IsNull()) {
           setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_SHARE, NULL);
+
+          if (setOptRetCode == CURLE_OK) {
+            obj->toFree->Unset(CURLOPT_SHARE);
+          }
         } else {
-          if (!value->IsObject() || !Nan::New(Share::constructor)->HasInstance(value)) {
+          if (!value->IsObject() ||
+              !Nan::New(IsolateData::Current()->shareConstructor)->HasInstance(value)) {
             Nan::ThrowTypeError(
                 "Invalid value for the SHARE option. It must be a Share "
                 "instance.");
-            return;
+            return false;
           }
 
           Share* share = Nan::ObjectWrap::Unwrap<Share>(value.As<v8::Object>());
 
           if (!share->isOpen) {
             Nan::ThrowError("Share handle is already closed.");
-            return;
+            return false;
           }
 
           setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_SHARE, share->sh);
+
+          // the share must not be collected while the handle is using it, the copyable traits
+          // reset the reference when the slot releases it.
+          if (setOptRetCode == CURLE_OK) {
+            obj->toFree->Set(
+                CURLOPT_SHARE,
+                std::make_shared<
+                    Nan::Persistent<v8::Value, Nan::CopyablePersistentTraits<v8::Value>>>(value));
+          }
         }
         break;
     }
     // linked list options
-  } else if ((optionId = IsInsideCurlConstantStruct(curlOptionLinkedList, opt))) {
+  } else if (optionTable == CURL_OPTION_LINKED_LIST) {
     // HTTPPOST is a special case, since it's an array of objects.
     if (optionId == CURLOPT_HTTPPOST) {
       std::string invalidArrayMsg = "HTTPPOST option value should be an Array of Objects.";
 
       if (!value->IsArray()) {
         Nan::ThrowTypeError(invalidArrayMsg.c_str());
-        return;
+        return false;
       }
 
       v8::Local<v8::Array> rows = v8::Local<v8::Array>::Cast(value);
 
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+      // curl_formadd is deprecated, the same form is built with the mime api
+      std::unique_ptr<CurlMime> httpPost = std::make_unique<CurlMime>(obj, obj->ch);
+#else
       std::unique_ptr<CurlHttpPost> httpPost = std::make_unique<CurlHttpPost>();
+#endif
 
       // [{ key : val }]
       for (uint32_t i = 0, len = rows->Length(); i < len; ++i) {
@@ -1075,7 +1577,7 @@ NAN_METHOD(Easy::SetOpt) {
         v8::Local<v8::Value> obj = Nan::Get(rows, i).ToLocalChecked();
         if (!obj->IsObject()) {
           Nan::ThrowTypeError(invalidArrayMsg.c_str());
-          return;
+          return false;
         }
 
         v8::Local<v8::Object> postData = v8::Local<v8::Object>::Cast(obj);
@@ -1133,7 +1635,7 @@ NAN_METHOD(Easy::SetOpt) {
                           "\". Valid properties are file, type, contents, name "
                           "and filename.";
               Nan::ThrowError(errorMsg.c_str());
-              return;
+              return false;
           }
 
           // check if value is a string.
@@ -1142,18 +1644,18 @@ NAN_METHOD(Easy::SetOpt) {
 
             errorMsg += std::string("Value for property \"") + optionName + "\" must be a string.";
             Nan::ThrowTypeError(errorMsg.c_str());
-            return;
+            return false;
           }
         }
 
         if (!hasName) {
           Nan::ThrowError("Missing field \"name\".");
-          return;
+          return false;
         }
 
         Nan::Utf8String fieldName(
             Nan::Get(postData, Nan::New<v8::String>("name").ToLocalChecked()).ToLocalChecked());
-        CURLFORMcode curlFormCode;
+        bool isAdded;
 
         if (hasFile) {
           Nan::Utf8String file(
@@ -1167,13 +1669,29 @@ NAN_METHOD(Easy::SetOpt) {
               Nan::Utf8String fileName(
                   Nan::Get(postData, Nan::New<v8::String>("filename").ToLocalChecked())
                       .ToLocalChecked());
-              curlFormCode =
-                  httpPost->AddFile(*fieldName, fieldName.length(), *file, *contentType, *fileName);
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+              isAdded = httpPost->AddFile(std::string(*fieldName, fieldName.length()), *file,
+                                          *contentType, *fileName) == CURLE_OK;
+#else
+              isAdded = httpPost->AddFile(*fieldName, fieldName.length(), *file, *contentType,
+                                          *fileName) == CURL_FORMADD_OK;
+#endif
             } else {
-              curlFormCode = httpPost->AddFile(*fieldName, fieldName.length(), *file, *contentType);
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+              isAdded = httpPost->AddFile(std::string(*fieldName, fieldName.length()), *file,
+                                          *contentType, nullptr) == CURLE_OK;
+#else
+              isAdded = httpPost->AddFile(*fieldName, fieldName.length(), *file, *contentType) ==
+                        CURL_FORMADD_OK;
+#endif
             }
           } else {
-            curlFormCode = httpPost->AddFile(*fieldName, fieldName.length(), *file);
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+            isAdded = httpPost->AddFile(std::string(*fieldName, fieldName.length()), *file,
+                                        nullptr, nullptr) == CURLE_OK;
+#else
+            isAdded = httpPost->AddFile(*fieldName, fieldName.length(), *file) == CURL_FORMADD_OK;
+#endif
           }
 
         } else if (hasContent) {  // if file is not set, the contents field MUST
@@ -1183,37 +1701,61 @@ NAN_METHOD(Easy::SetOpt) {
               Nan::Get(postData, Nan::New<v8::String>("contents").ToLocalChecked())
                   .ToLocalChecked());
 
-          curlFormCode =
-              httpPost->AddField(*fieldName, fieldName.length(), *fieldValue, fieldValue.length());
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+          isAdded = httpPost->AddField(std::string(*fieldName, fieldName.length()),
+                                       std::string(*fieldValue, fieldValue.length())) == CURLE_OK;
+#else
+          isAdded = httpPost->AddField(*fieldName, fieldName.length(), *fieldValue,
+                                       fieldValue.length()) == CURL_FORMADD_OK;
+#endif
 
         } else {
           Nan::ThrowError("Missing field \"contents\".");
-          return;
+          return false;
         }
 
-        if (curlFormCode != CURL_FORMADD_OK) {
+        if (!isAdded) {
           std::string errorMsg;
 
           errorMsg += std::string("Error while adding field \"") + *fieldName + "\" to post data.";
           Nan::ThrowError(errorMsg.c_str());
-          return;
+          return false;
         }
       }
 
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+      setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_MIMEPOST, httpPost->mime);
+
+      if (setOptRetCode == CURLE_OK) {
+        obj->mimePost = std::move(httpPost);
+      }
+#else
       setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_HTTPPOST, httpPost->first);
 
       if (setOptRetCode == CURLE_OK) {
-        obj->toFree->post.push_back(std::move(httpPost));
+        obj->toFree->Set(CURLOPT_HTTPPOST, std::shared_ptr<CurlHttpPost>(std::move(httpPost)));
       }
+#endif
 
     } else {
+      std::shared_ptr<const HeaderList::Lines> headerListLines;
+
       if (value->IsNull()) {
         setOptRetCode = curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), NULL);
 
+      } else if (value->IsObject() &&
+                 Nan::New(IsolateData::Current()->headerListConstructor)->HasInstance(value)) {
+        // the nodes of the list are used as they are, the handle only keeps a reference to them
+        headerListLines =
+            Nan::ObjectWrap::Unwrap<HeaderList>(Nan::To<v8::Object>(value).ToLocalChecked())
+                ->lines;
+
+        setOptRetCode = curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId),
+                                         headerListLines->Head());
       } else {
         if (!value->IsArray()) {
           Nan::ThrowTypeError("Option value must be an Array.");
-          return;
+          return false;
         }
 
         // convert value to curl linked list (curl_slist)
@@ -1227,16 +1769,45 @@ NAN_METHOD(Easy::SetOpt) {
         setOptRetCode = curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), slist);
 
         if (setOptRetCode == CURLE_OK) {
-          obj->toFree->slist.push_back(slist);
+          obj->toFree->Set(static_cast<CURLoption>(optionId),
+                           std::shared_ptr<curl_slist>(slist, curl_slist_free_all));
+        } else {
+          curl_slist_free_all(slist);
+        }
+      }
+
+      if (setOptRetCode == CURLE_OK) {
+        if (headerListLines) {
+          obj->toFree->Set(static_cast<CURLoption>(optionId), headerListLines);
+        } else if (value->IsNull()) {
+          obj->toFree->Unset(static_cast<CURLoption>(optionId));
         }
       }
     }
 
+    // binary POSTFIELDS, sent straight from the memory of the Buffer / TypedArray, which is kept
+    // alive while the option is set to it. The size is set too, since the data may contain zeros.
+  } else if (optionTable == CURL_OPTION_STRING && optionId == CURLOPT_POSTFIELDS &&
+             value->IsArrayBufferView()) {
+    std::shared_ptr<ViewContents> contents = ViewContents::Create(value);
+
+    setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_POSTFIELDSIZE_LARGE,
+                                     static_cast<curl_off_t>(contents->length));
+
+    if (setOptRetCode == CURLE_OK) {
+      setOptRetCode = curl_easy_setopt(obj->ch, CURLOPT_POSTFIELDS, contents->data);
+    }
+
+    if (setOptRetCode == CURLE_OK) {
+      obj->toFree->Set(CURLOPT_POSTFIELDS, contents);
+      obj->isPostFieldsSizeFromView = true;
+    }
+
     // check if option is string, and the value is correct
-  } else if ((optionId = IsInsideCurlConstantStruct(curlOptionString, opt))) {
+  } else if (optionTable == CURL_OPTION_STRING) {
     if (!value->IsString()) {
       Nan::ThrowTypeError("Option value must be a string.");
-      return;
+      return false;
     }
 
     // Create a string copy
@@ -1246,31 +1817,36 @@ NAN_METHOD(Easy::SetOpt) {
       setOptRetCode = curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), NULL);
     }
 
-    Nan::Utf8String value(info[1]);
-
-    size_t length = static_cast<size_t>(value.length());
+    Nan::Utf8String valueUtf8(value);
 
-    std::string valueStr = std::string(*value, length);
+    size_t length = static_cast<size_t>(valueUtf8.length());
 
     // libcurl makes a copy of the strings after version 7.17, CURLOPT_POSTFIELD
     // is the only exception
     if (static_cast<CURLoption>(optionId) == CURLOPT_POSTFIELDS) {
-      std::vector<char> valueChar = std::vector<char>(valueStr.begin(), valueStr.end());
-      valueChar.push_back(0);
+      // the size set for a previous Buffer does not apply to this string
+      if (obj->isPostFieldsSizeFromView) {
+        curl_easy_setopt(obj->ch, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(-1));
+        obj->isPostFieldsSizeFromView = false;
+      }
 
-      setOptRetCode = curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), &valueChar[0]);
+      // including the terminating null character
+      std::shared_ptr<std::vector<char>> valueChar =
+          std::make_shared<std::vector<char>>(*valueUtf8, *valueUtf8 + length + 1);
 
-      if (setOptRetCode == CURLE_OK) {
-        obj->toFree->str.push_back(std::move(valueChar));
+      setOptRetCode =
+          curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), valueChar->data());
+
+      if (setOptRetCode == CURLE_OK) {
+        obj->toFree->Set(CURLOPT_POSTFIELDS, valueChar);
       }
 
     } else {
-      setOptRetCode =
-          curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), valueStr.c_str());
+      setOptRetCode = curl_easy_setopt(obj->ch, static_cast<CURLoption>(optionId), *valueUtf8);
     }
 
     // check if option is an integer, and the value is correct
-  } else if ((optionId = IsInsideCurlConstantStruct(curlOptionInteger, opt))) {
+  } else if (optionTable == CURL_OPTION_INTEGER) {
     switch (optionId) {
       case CURLOPT_INFILESIZE_LARGE:
       case CURLOPT_MAXFILESIZE_LARGE:
@@ -1284,10 +1860,37 @@ NAN_METHOD(Easy::SetOpt) {
         break;
       // special case with READDATA, since we need to store the file descriptor
       // and not overwrite the READDATA already set in the handle.
-      case CURLOPT_READDATA:
-        obj->readDataFileDescriptor = Nan::To<int32_t>(value).FromJust();
+      case CURLOPT_READDATA: {
+        int32_t fd = value->IsNull() ? -1 : Nan::To<int32_t>(value).FromJust();
+
+        if (obj->fileSource) {
+          obj->fileSource->Detach();
+          obj->fileSource = nullptr;
+        }
+
+        if (fd >= 0) {
+          obj->fileSource = new FileSource(obj, static_cast<uv_file>(fd));
+        }
+
+        setOptRetCode = CURLE_OK;
+        break;
+      }
+      // same for WRITEDATA, the file descriptor is used by the FileSink
+      case CURLOPT_WRITEDATA: {
+        int32_t fd = value->IsNull() ? -1 : Nan::To<int32_t>(value).FromJust();
+
+        if (obj->fileSink) {
+          obj->fileSink->Detach();
+          obj->fileSink = nullptr;
+        }
+
+        if (fd >= 0) {
+          obj->fileSink = new FileSink(obj, static_cast<uv_file>(fd), obj->writeDataOffset);
+        }
+
         setOptRetCode = CURLE_OK;
         break;
+      }
       default:
         setOptRetCode = curl_easy_setopt(
             obj->ch, static_cast<CURLoption>(optionId),
@@ -1295,13 +1898,18 @@ NAN_METHOD(Easy::SetOpt) {
         break;
     }
 
+    // the size was given explicitly, it must be kept even if POSTFIELDS is set to a string later
+    if (optionId == CURLOPT_POSTFIELDSIZE || optionId == CURLOPT_POSTFIELDSIZE_LARGE) {
+      obj->isPostFieldsSizeFromView = false;
+    }
+
     // check if option is a function, and the value is correct
-  } else if ((optionId = IsInsideCurlConstantStruct(curlOptionFunction, opt))) {
+  } else if (optionTable == CURL_OPTION_FUNCTION) {
     bool isNull = value->IsNull();
 
     if (!value->IsFunction() && !isNull) {
       Nan::ThrowTypeError("Option value must be a null or a function.");
-      return;
+      return false;
     }
 
     switch (optionId) {
@@ -1480,7 +2088,194 @@ NAN_METHOD(Easy::SetOpt) {
     }
   }
 
-  info.GetReturnValue().Set(setOptRetCode);
+  code = setOptRetCode;
+  return true;
+}
+
+NAN_METHOD(Easy::SetOpt) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  CURLcode code = CURLE_OK;
+
+  if (!Easy::SetOptValue(obj, info[0], info[1], code)) {
+    return;
+  }
+
+  info.GetReturnValue().Set(code);
+}
+
+// applies multiple options at once, the options can be an object, or an array of [option, value]
+// pairs, in which case they are applied in the given order.
+// The first option that libcurl rejected and its code are returned, the ones after it are not set.
+NAN_METHOD(Easy::SetOpts) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  v8::Local<v8::Value> options = info[0];
+  bool isArray = options->IsArray();
+
+  if (!isArray && (!options->IsObject() || options->IsFunction())) {
+    Nan::ThrowTypeError("Options should be an Object or an Array of [option, value] pairs.");
+    return;
+  }
+
+  v8::Local<v8::Object> optionsObj = Nan::To<v8::Object>(options).ToLocalChecked();
+  v8::Local<v8::Array> keys;
+
+  if (isArray) {
+    keys = optionsObj.As<v8::Array>();
+  } else if (!Nan::GetOwnPropertyNames(optionsObj).ToLocal(&keys)) {
+    return;
+  }
+
+  uint32_t length = keys->Length();
+
+  for (uint32_t i = 0; i < length; i++) {
+    v8::Local<v8::Value> opt;
+    v8::Local<v8::Value> value;
+
+    if (isArray) {
+      v8::Local<v8::Value> pair = Nan::Get(keys, i).ToLocalChecked();
+
+      if (!pair->IsArray()) {
+        Nan::ThrowTypeError("Options should be an Object or an Array of [option, value] pairs.");
+        return;
+      }
+
+      v8::Local<v8::Object> pairObj = Nan::To<v8::Object>(pair).ToLocalChecked();
+      opt = Nan::Get(pairObj, 0).ToLocalChecked();
+      value = Nan::Get(pairObj, 1).ToLocalChecked();
+    } else {
+      opt = Nan::Get(keys, i).ToLocalChecked();
+
+      if (!Nan::Get(optionsObj, opt).ToLocal(&value)) {
+        return;
+      }
+    }
+
+    CURLcode code = CURLE_OK;
+
+    if (!Easy::SetOptValue(obj, opt, value, code)) {
+      return;
+    }
+
+    if (code != CURLE_OK) {
+      v8::Local<v8::Object> result = Nan::New<v8::Object>();
+      Nan::Set(result, Nan::New("option").ToLocalChecked(), opt);
+      Nan::Set(result, Nan::New("code").ToLocalChecked(), Nan::New<v8::Integer>(code));
+
+      info.GetReturnValue().Set(result);
+      return;
+    }
+  }
+
+  info.GetReturnValue().Set(Nan::Null());
+}
+
+// sets all options of an OptionTemplate, which were already converted when it was created.
+// The result is the same than the one of setOpts.
+NAN_METHOD(Easy::ApplyTemplate) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  v8::Local<v8::Value> value = info[0];
+
+  if (!value->IsObject() ||
+      !Nan::New(IsolateData::Current()->optionTemplateConstructor)->HasInstance(value)) {
+    Nan::ThrowTypeError("Argument must be an OptionTemplate.");
+    return;
+  }
+
+  OptionTemplate* optionTemplate =
+      Nan::ObjectWrap::Unwrap<OptionTemplate>(Nan::To<v8::Object>(value).ToLocalChecked());
+
+  const std::shared_ptr<const OptionTemplate::Options>& options = optionTemplate->options;
+
+  // the size set for a previous Buffer POSTFIELDS does not apply to the string of the template,
+  // libcurl would copy that many bytes from it.
+  if (obj->isPostFieldsSizeFromView) {
+    for (const OptionTemplate::Entry& entry : options->entries) {
+      if (entry.id == CURLOPT_COPYPOSTFIELDS) {
+        curl_easy_setopt(obj->ch, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(-1));
+        obj->isPostFieldsSizeFromView = false;
+        break;
+      }
+    }
+  }
+
+  size_t appliedCount = 0;
+  CURLcode code = optionTemplate->Apply(obj->ch, appliedCount);
+
+  // the lists are not copied by libcurl, the slots of their options keep the template options,
+  // or the HeaderList, alive.
+  for (size_t i = 0; i < appliedCount; i++) {
+    const OptionTemplate::Entry& entry = options->entries[i];
+
+    switch (entry.kind) {
+      case OptionTemplate::Entry::KIND_LIST:
+        obj->toFree->Set(entry.id, options);
+        break;
+      case OptionTemplate::Entry::KIND_HEADER_LIST:
+        obj->toFree->Set(entry.id, entry.headerList);
+        break;
+      case OptionTemplate::Entry::KIND_NULL:
+        obj->toFree->Unset(entry.id);
+        break;
+      default:
+        break;
+    }
+
+    // libcurl replaces the POSTFIELDS pointer with its own copy
+    if (entry.id == CURLOPT_COPYPOSTFIELDS) {
+      obj->toFree->Unset(CURLOPT_POSTFIELDS);
+    }
+  }
+
+  if (code != CURLE_OK) {
+    v8::Local<v8::Object> result = Nan::New<v8::Object>();
+    Nan::Set(result, Nan::New("option").ToLocalChecked(),
+             Nan::New<v8::Integer>(static_cast<int32_t>(options->entries[appliedCount].id)));
+    Nan::Set(result, Nan::New("code").ToLocalChecked(), Nan::New<v8::Integer>(code));
+
+    info.GetReturnValue().Set(result);
+    return;
+  }
+
+  info.GetReturnValue().Set(Nan::Null());
 }
 
 // traits class to determine if we need to check for null pointer first
@@ -1526,17 +2321,23 @@ NAN_METHOD(Easy::GetInfo) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
   v8::Local<v8::Value> infoVal = info[0];
 
   v8::Local<v8::Value> retVal = Nan::Undefined();
 
-  int infoId;
+  int32_t infoId = 0;
+  int infoTable = curlInfoIndex.Find(infoVal, infoId);
 
   CURLINFO curlInfo;
   CURLcode code = CURLE_OK;
 
   // Special case for unsupported info
-  if ((infoId = IsInsideCurlConstantStruct(curlInfoNotImplemented, infoVal))) {
+  if (infoTable == CURL_INFO_NOT_IMPLEMENTED) {
     Nan::ThrowError(
         "Unsupported info, probably because it's too complex to implement "
         "using javascript or unecessary when using javascript.");
@@ -1546,11 +2347,11 @@ NAN_METHOD(Easy::GetInfo) {
   Nan::TryCatch tryCatch;
 
   // String
-  if ((infoId = IsInsideCurlConstantStruct(curlInfoString, infoVal))) {
+  if (infoTable == CURL_INFO_STRING) {
     retVal = Easy::GetInfoTmpl<char*, v8::String>(obj, infoId);
 
     // Double
-  } else if ((infoId = IsInsideCurlConstantStruct(curlInfoDouble, infoVal))) {
+  } else if (infoTable == CURL_INFO_DOUBLE) {
     switch (infoId) {
       // curl_off_t variants that were added on 7.55
 #if NODE_LIBCURL_VER_GE(7, 59, 0)
@@ -1581,11 +2382,11 @@ NAN_METHOD(Easy::GetInfo) {
     }
 
     // Integer
-  } else if ((infoId = IsInsideCurlConstantStruct(curlInfoInteger, infoVal))) {
+  } else if (infoTable == CURL_INFO_INTEGER) {
     retVal = Easy::GetInfoTmpl<long, v8::Number>(obj, infoId);  // NOLINT(runtime/int)
 
     // ACTIVESOCKET and alike
-  } else if ((infoId = IsInsideCurlConstantStruct(curlInfoSocket, infoVal))) {
+  } else if (infoTable == CURL_INFO_SOCKET) {
 #if NODE_LIBCURL_VER_GE(7, 45, 0)
     curl_socket_t socket;
 #else
@@ -1601,7 +2402,7 @@ NAN_METHOD(Easy::GetInfo) {
     }
 
     // Linked list
-  } else if ((infoId = IsInsideCurlConstantStruct(curlInfoLinkedList, infoVal))) {
+  } else if (infoTable == CURL_INFO_LINKED_LIST) {
     curl_slist* linkedList;
     curl_slist* curr;
 
@@ -1657,6 +2458,11 @@ NAN_METHOD(Easy::Send) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
   if (info.Length() == 0) {
     Nan::ThrowError("Missing buffer argument.");
     return;
@@ -1692,6 +2498,11 @@ NAN_METHOD(Easy::Recv) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
   if (info.Length() == 0) {
     Nan::ThrowError("Missing buffer argument.");
     return;
@@ -1728,8 +2539,22 @@ NAN_METHOD(Easy::Perform) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  obj->PrepareTransfer();
+
   SETLOCALE_WRAPPER(CURLcode code = curl_easy_perform(obj->ch););
 
+  obj->EndTransfer();
+
+  if (obj->writeMode == WRITE_MODE_COALESCE) {
+    obj->FlushPendingData();
+    code = obj->GetTransferResult(code);
+  }
+
   v8::Local<v8::Integer> ret = Nan::New<v8::Integer>(static_cast<int32_t>(code));
 
   info.GetReturnValue().Set(ret);
@@ -1745,6 +2570,11 @@ NAN_METHOD(Easy::Upkeep) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
 #if NODE_LIBCURL_VER_GE(7, 62, 0)
   CURLcode code = curl_easy_upkeep(obj->ch);
 #else
@@ -1770,6 +2600,11 @@ NAN_METHOD(Easy::Pause) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
   if (!info[0]->IsUint32()) {
     Nan::ThrowTypeError("Bitmask value must be an integer.");
     return;
@@ -1777,6 +2612,8 @@ NAN_METHOD(Easy::Pause) {
 
   uint32_t bitmask = Nan::To<uint32_t>(info[0]).FromJust();
 
+  obj->pauseState = static_cast<int>(bitmask) & CURLPAUSE_ALL;
+
   CURLcode code = curl_easy_pause(obj->ch, static_cast<int>(bitmask));
 
   info.GetReturnValue().Set(static_cast<int32_t>(code));
@@ -1792,6 +2629,11 @@ NAN_METHOD(Easy::Reset) {
     return;
   }
 
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
   curl_easy_reset(obj->ch);
 
   // reset the URL,
@@ -1803,9 +2645,42 @@ NAN_METHOD(Easy::Reset) {
 
   obj->toFree = nullptr;
   obj->toFree = std::make_shared<Easy::ToFree>();
+  obj->isPostFieldsSizeFromView = false;
+  obj->pauseState = CURLPAUSE_CONT;
+
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+  obj->mimePost.reset();
+#endif
+
+  if (obj->fileSource) {
+    obj->fileSource->Detach();
+    obj->fileSource = nullptr;
+  }
+
+  obj->bufferSource.reset();
+  obj->uploadQueue.reset();
+
+  obj->writeMode = WRITE_MODE_CALLBACK;
+  obj->collectedData.Clear();
+  obj->pendingData.Clear();
+  obj->hasPendingDataError = false;
+  obj->isBufferPoolingEnabled = false;
+  obj->headerMode = HEADER_MODE_CALLBACK;
+  obj->headerParser.Clear();
+  obj->digest.algorithms = 0;
+  obj->digest.Reset();
+
+  if (obj->fileSink) {
+    obj->fileSink->Detach();
+    obj->fileSink = nullptr;
+  }
 
-  obj->readDataFileDescriptor = -1;
-  obj->readDataOffset = -1;
+  if (obj->ringSink) {
+    obj->ringSink->Detach();
+    obj->ringSink = nullptr;
+  }
+  obj->writeDataOffset = -1;
+  obj->isCompletionDeferred = false;
 
   info.GetReturnValue().Set(info.This());
 }
@@ -1813,117 +2688,744 @@ NAN_METHOD(Easy::Reset) {
 NAN_METHOD(Easy::DupHandle) {
   Nan::HandleScope scope;
 
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
   // create a new js object using this one as the argument for the constructor.
   const int argc = 1;
   v8::Local<v8::Value> argv[argc] = {info.This()};
-  v8::Local<v8::Function> cons = Nan::GetFunction(Nan::New(Easy::constructor)).ToLocalChecked();
+  v8::Local<v8::Function> cons =
+      Nan::GetFunction(Nan::New(IsolateData::Current()->easyConstructor)).ToLocalChecked();
 
   v8::Local<v8::Object> newInstance = Nan::NewInstance(cons, argc, argv).ToLocalChecked();
 
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+  // the copy constructor cannot throw, so a form that could not be duplicated is reported here
+  Easy* duplicated = Nan::ObjectWrap::Unwrap<Easy>(newInstance);
+
+  if (obj->mimePost && !duplicated->mimePost) {
+    duplicated->Dispose();
+    Nan::ThrowError("Could not duplicate the MIMEPOST form of the handle.");
+    return;
+  }
+#endif
+
   info.GetReturnValue().Set(newInstance);
 }
 
-NAN_METHOD(Easy::OnSocketEvent) {
+NAN_METHOD(Easy::SetWriteMode) {
   Nan::HandleScope scope;
 
   Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
 
-  if (!info.Length()) {
-    Nan::ThrowError("You must specify the callback function.");
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
     return;
   }
 
-  v8::Local<v8::Value> arg = info[0];
+  if (!info[0]->IsUint32()) {
+    Nan::ThrowTypeError("Write mode must be an integer.");
+    return;
+  }
 
-  if (arg->IsNull()) {
-    obj->cbOnSocketEvent = nullptr;
+  uint32_t mode = Nan::To<uint32_t>(info[0]).FromJust();
 
-    info.GetReturnValue().Set(info.This());
+  if (mode > WRITE_MODE_COALESCE) {
+    Nan::ThrowError("Invalid write mode.");
     return;
   }
 
-  if (!arg->IsFunction()) {
-    Nan::ThrowTypeError("Invalid callback given.");
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the write mode while the handle is inside a Multi instance.");
     return;
   }
 
-  v8::Local<v8::Function> callback = arg.As<v8::Function>();
+  obj->writeMode = static_cast<WriteMode>(mode);
 
-  obj->cbOnSocketEvent.reset(new Nan::Callback(callback));
   info.GetReturnValue().Set(info.This());
 }
 
-NAN_METHOD(Easy::MonitorSocketEvents) {
+// returns the body stored using WRITE_MODE_COLLECT, the memory is moved to the Buffer, no copy is
+// made.
+NAN_METHOD(Easy::TakeCollectedData) {
   Nan::HandleScope scope;
 
   Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
 
-  Nan::TryCatch tryCatch;
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
 
-  obj->MonitorSockets();
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
 
-  if (tryCatch.HasCaught()) {
-    tryCatch.ReThrow();
+  size_t length = obj->collectedData.length;
+
+  if (length == 0) {
+    obj->collectedData.Clear();
+    info.GetReturnValue().Set(Nan::NewBuffer(0).ToLocalChecked());
     return;
   }
 
-  info.GetReturnValue().Set(info.This());
+  // Nan::NewBuffer takes the length as an uint32_t, kMaxLength can be bigger than that on 64-bit
+  if (length > node::Buffer::kMaxLength || length > std::numeric_limits<uint32_t>::max()) {
+    obj->collectedData.Clear();
+    Nan::ThrowRangeError("Collected data is too big to fit into a Buffer.");
+    return;
+  }
+
+  // Content-Length may have over-estimated the size, for example when the body was decoded.
+  // Give the excess back before handing the memory to v8.
+  if (obj->collectedData.capacity - length > length / 8) {
+    char* shrunk = static_cast<char*>(std::realloc(obj->collectedData.data, length));
+    if (shrunk) {
+      obj->collectedData.data = shrunk;
+      obj->collectedData.capacity = length;
+    }
+  }
+
+  char* data = obj->collectedData.Release();
+
+  // the Buffer takes ownership of data and is going to free() it when garbage collected
+  Nan::MaybeLocal<v8::Object> buffer = Nan::NewBuffer(data, static_cast<uint32_t>(length));
+
+  if (buffer.IsEmpty()) {
+    std::free(data);
+    Nan::ThrowError("Could not create Buffer with the collected data.");
+    return;
+  }
+
+  info.GetReturnValue().Set(buffer.ToLocalChecked());
 }
 
-NAN_METHOD(Easy::UnmonitorSocketEvents) {
+NAN_METHOD(Easy::TakeCollectedDataAsString) {
   Nan::HandleScope scope;
 
   Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
 
-  Nan::TryCatch tryCatch;
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
 
-  obj->UnmonitorSockets();
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
 
-  if (tryCatch.HasCaught()) {
-    tryCatch.ReThrow();
+  uint32_t encoding = TEXT_ENCODING_UTF8;
+
+  if (!info[0]->IsUndefined()) {
+    if (!info[0]->IsUint32()) {
+      Nan::ThrowTypeError("Encoding must be an integer.");
+      return;
+    }
+
+    encoding = Nan::To<uint32_t>(info[0]).FromJust();
+
+    if (encoding > TEXT_ENCODING_LATIN1) {
+      Nan::ThrowError("Invalid encoding.");
+      return;
+    }
+  }
+
+  size_t length = obj->collectedData.length;
+  char* data = obj->collectedData.Release();
+
+  // the string takes ownership of data
+  Nan::MaybeLocal<v8::String> string =
+      NewStringFromBody(data, length, static_cast<TextEncoding>(encoding));
+
+  if (string.IsEmpty()) {
+    Nan::ThrowError("Collected data is too big to fit into a string.");
     return;
   }
 
-  info.GetReturnValue().Set(info.This());
+  info.GetReturnValue().Set(string.ToLocalChecked());
 }
 
-NAN_METHOD(Easy::Close) {
-  // check https://github.com/php/php-src/blob/master/ext/curl/interface.c#L3196
+NAN_METHOD(Easy::TakeCollectedDataAsJson) {
   Nan::HandleScope scope;
 
   Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
 
   if (!obj->isOpen) {
-    Nan::ThrowError("Curl handle already closed.");
+    Nan::ThrowError("Curl handle is closed.");
     return;
   }
 
-  if (obj->isInsideMultiHandle) {
-    Nan::ThrowError("Curl handle is inside a Multi instance, you must remove it first.");
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
     return;
   }
 
-  obj->Dispose();
+  if (!info[0]->IsFunction()) {
+    Nan::ThrowTypeError("Callback must be a function.");
+    return;
+  }
 
-  return;
+  size_t length = obj->collectedData.length;
+  char* data = obj->collectedData.Release();
+
+  Nan::Callback* callback = new Nan::Callback(info[0].As<v8::Function>());
+
+  // the worker takes ownership of data
+  Nan::AsyncQueueWorker(new JsonParseWorker(callback, data, length));
 }
 
-NAN_METHOD(Easy::StrError) {
+NAN_METHOD(Easy::SetUploadBuffer) {
   Nan::HandleScope scope;
 
-  v8::Local<v8::Value> errCode = info[0];
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
 
-  if (!errCode->IsInt32()) {
-    Nan::ThrowTypeError("Invalid errCode passed to Easy.strError.");
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
     return;
   }
 
-  const char* errorMsg =
-      curl_easy_strerror(static_cast<CURLcode>(Nan::To<int32_t>(errCode).FromJust()));
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the upload buffer while the handle is inside a Multi instance.");
+    return;
+  }
+
+  if (info[0]->IsNull() || info[0]->IsUndefined()) {
+    obj->bufferSource.reset();
+    info.GetReturnValue().Set(info.This());
+    return;
+  }
+
+  BufferSource* bufferSource = BufferSource::Create(info[0]);
+
+  // exception already thrown
+  if (!bufferSource) {
+    return;
+  }
+
+  obj->bufferSource.reset(bufferSource);
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::SetUploadFile) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the upload file while the handle is inside a Multi instance.");
+    return;
+  }
+
+  if (info[0]->IsNull() || info[0]->IsUndefined()) {
+    obj->bufferSource.reset();
+    info.GetReturnValue().Set(info.This());
+    return;
+  }
+
+  std::shared_ptr<FileMapping> mapping;
+  std::string error;
+
+  if (info[0]->IsString()) {
+    Nan::Utf8String path(info[0]);
+    mapping = FileMapping::Open(std::string(*path, path.length()), error);
+  } else if (info[0]->IsInt32() && Nan::To<int32_t>(info[0]).FromJust() >= 0) {
+    mapping = FileMapping::Open(Nan::To<int32_t>(info[0]).FromJust(), error);
+  } else {
+    Nan::ThrowTypeError("Upload file must be a path or a file descriptor.");
+    return;
+  }
+
+  if (!mapping) {
+    std::string errorMsg = "Could not map the upload file: " + error;
+    Nan::ThrowError(errorMsg.c_str());
+    return;
+  }
+
+  obj->bufferSource.reset(BufferSource::Create(mapping));
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::SetUploadQueue) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the upload queue while the handle is inside a Multi instance.");
+    return;
+  }
+
+  if (info[0]->IsNull() || info[0]->IsUndefined()) {
+    obj->uploadQueue.reset();
+    info.GetReturnValue().Set(info.This());
+    return;
+  }
+
+  if (!info[0]->IsNumber() || !info[1]->IsNumber() || !info[2]->IsFunction()) {
+    Nan::ThrowTypeError(
+        "Arguments must be the high watermark, the low watermark and the drain callback.");
+    return;
+  }
+
+  double highWaterMark = Nan::To<double>(info[0]).FromJust();
+  double lowWaterMark = Nan::To<double>(info[1]).FromJust();
+
+  if (!(highWaterMark > 0) || !(lowWaterMark >= 0) || lowWaterMark >= highWaterMark) {
+    Nan::ThrowRangeError("The high watermark must be positive, and bigger than the low watermark.");
+    return;
+  }
+
+  obj->uploadQueue.reset(new UploadQueue(obj, static_cast<size_t>(highWaterMark),
+                                         static_cast<size_t>(lowWaterMark),
+                                         info[2].As<v8::Function>()));
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::WriteUploadQueue) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (!obj->uploadQueue) {
+    Nan::ThrowError("The upload queue was not set.");
+    return;
+  }
+
+  if (obj->uploadQueue->IsEnded()) {
+    Nan::ThrowError("The upload queue already ended.");
+    return;
+  }
+
+  if (!info[0]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Chunk must be a Buffer, a TypedArray or a DataView.");
+    return;
+  }
+
+  info.GetReturnValue().Set(Nan::New(obj->uploadQueue->Write(info[0])));
+}
+
+NAN_METHOD(Easy::EndUploadQueue) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (!obj->uploadQueue) {
+    Nan::ThrowError("The upload queue was not set.");
+    return;
+  }
+
+  obj->uploadQueue->End(Nan::To<bool>(info[0]).FromMaybe(false));
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::SetDigests) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (!info[0]->IsUint32()) {
+    Nan::ThrowTypeError("Digests must be an integer.");
+    return;
+  }
+
+  uint32_t algorithms = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (algorithms & ~Digest::ALL_ALGORITHMS) {
+    Nan::ThrowError("Invalid digest algorithm.");
+    return;
+  }
+
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the digests while the handle is inside a Multi instance.");
+    return;
+  }
+
+  obj->digest.algorithms = algorithms;
+  obj->digest.Reset();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::GetDigest) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  if (!info[0]->IsUint32()) {
+    Nan::ThrowTypeError("Digest algorithm must be an integer.");
+    return;
+  }
+
+  uint32_t algorithm = Nan::To<uint32_t>(info[0]).FromJust();
+
+  // exactly one bit must be set
+  if (!algorithm || (algorithm & (algorithm - 1)) || (algorithm & ~Digest::ALL_ALGORITHMS)) {
+    Nan::ThrowError("Invalid digest algorithm.");
+    return;
+  }
+
+  if (!(obj->digest.algorithms & algorithm)) {
+    Nan::ThrowError("Digest algorithm was not enabled with setDigests.");
+    return;
+  }
+
+  static const char hexDigits[] = "0123456789abcdef";
+
+  unsigned char value[Digest::MAX_SIZE];
+  char hex[Digest::MAX_SIZE * 2];
+  size_t size = obj->digest.Final(static_cast<Digest::Algorithm>(algorithm), value);
+
+  for (size_t i = 0; i < size; i++) {
+    hex[i * 2] = hexDigits[value[i] >> 4];
+    hex[i * 2 + 1] = hexDigits[value[i] & 0x0f];
+  }
+
+  info.GetReturnValue().Set(Nan::New(hex, static_cast<int>(size * 2)).ToLocalChecked());
+}
+
+NAN_METHOD(Easy::SetBufferPooling) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  obj->isBufferPoolingEnabled = Nan::To<bool>(info[0]).FromJust();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::SetHeaderMode) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (!info[0]->IsUint32()) {
+    Nan::ThrowTypeError("Header mode must be an integer.");
+    return;
+  }
+
+  uint32_t mode = Nan::To<uint32_t>(info[0]).FromJust();
+
+  if (mode > HEADER_MODE_PARSE) {
+    Nan::ThrowError("Invalid header mode.");
+    return;
+  }
+
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the header mode while the handle is inside a Multi instance.");
+    return;
+  }
+
+  obj->headerMode = static_cast<HeaderMode>(mode);
+
+  info.GetReturnValue().Set(info.This());
+}
+
+// returns the headers parsed using HEADER_MODE_PARSE, one object for each block of headers
+NAN_METHOD(Easy::TakeParsedHeaders) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  obj->headerParser.Finish();
+
+  v8::Local<v8::Array> headers = Easy::CreateV8ArrayFromHeaderParser(obj->headerParser);
+
+  obj->headerParser.Clear();
+
+  info.GetReturnValue().Set(headers);
+}
+
+NAN_METHOD(Easy::SetWriteDataOffset) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (!info[0]->IsNumber()) {
+    Nan::ThrowTypeError("Offset must be a number.");
+    return;
+  }
+
+  double offset = Nan::To<double>(info[0]).FromJust();
+
+  obj->writeDataOffset = offset < 0 ? -1 : static_cast<int64_t>(offset);
+
+  if (obj->fileSink) {
+    obj->fileSink->SetOffset(obj->writeDataOffset);
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::SetWriteRing) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot change the write ring while the handle is inside a Multi instance.");
+    return;
+  }
+
+  v8::Local<v8::Value> value = info[0];
+
+  if (!value->IsNull() && !value->IsSharedArrayBuffer()) {
+    Nan::ThrowTypeError("Write ring must be a SharedArrayBuffer or null.");
+    return;
+  }
+
+  RingSink* ringSink = nullptr;
+
+  if (!value->IsNull()) {
+    ringSink = RingSink::Create(obj, value.As<v8::SharedArrayBuffer>());
+
+    // exception already thrown
+    if (!ringSink) {
+      return;
+    }
+  }
+
+  if (obj->ringSink) {
+    obj->ringSink->Detach();
+  }
+
+  obj->ringSink = ringSink;
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::WriteRingConsumed) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle is closed.");
+    return;
+  }
+
+  if (!obj->ringSink) {
+    Nan::ThrowError("The write ring was not set.");
+    return;
+  }
+
+  obj->ringSink->OnConsumed();
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::OnSocketEvent) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!info.Length()) {
+    Nan::ThrowError("You must specify the callback function.");
+    return;
+  }
+
+  v8::Local<v8::Value> arg = info[0];
+
+  if (arg->IsNull()) {
+    obj->cbOnSocketEvent = nullptr;
+
+    info.GetReturnValue().Set(info.This());
+    return;
+  }
+
+  if (!arg->IsFunction()) {
+    Nan::ThrowTypeError("Invalid callback given.");
+    return;
+  }
+
+  v8::Local<v8::Function> callback = arg.As<v8::Function>();
+
+  obj->cbOnSocketEvent.reset(new Nan::Callback(callback));
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::MonitorSocketEvents) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (obj->isInsideThreadedMulti) {
+    Nan::ThrowError("Curl handle is being used by a ThreadedMulti instance.");
+    return;
+  }
+
+  Nan::TryCatch tryCatch;
+
+  obj->MonitorSockets();
+
+  if (tryCatch.HasCaught()) {
+    tryCatch.ReThrow();
+    return;
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::UnmonitorSocketEvents) {
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  Nan::TryCatch tryCatch;
+
+  obj->UnmonitorSockets();
+
+  if (tryCatch.HasCaught()) {
+    tryCatch.ReThrow();
+    return;
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Easy::Close) {
+  // check https://github.com/php/php-src/blob/master/ext/curl/interface.c#L3196
+  Nan::HandleScope scope;
+
+  Easy* obj = Nan::ObjectWrap::Unwrap<Easy>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Curl handle already closed.");
+    return;
+  }
+
+  if (obj->isInsideMultiHandle) {
+    Nan::ThrowError("Curl handle is inside a Multi instance, you must remove it first.");
+    return;
+  }
+
+  obj->Dispose();
+
+  return;
+}
+
+NAN_METHOD(Easy::StrError) {
+  Nan::HandleScope scope;
+
+  v8::Local<v8::Value> errCode = info[0];
+
+  if (!errCode->IsInt32()) {
+    Nan::ThrowTypeError("Invalid errCode passed to Easy.strError.");
+    return;
+  }
+
+  const char* errorMsg =
+      curl_easy_strerror(static_cast<CURLcode>(Nan::To<int32_t>(errCode).FromJust()));
 
   v8::Local<v8::String> ret = Nan::New(errorMsg).ToLocalChecked();
 
   info.GetReturnValue().Set(ret);
 }
 
+NAN_METHOD(Easy::GetBufferPoolStats) {
+  Nan::HandleScope scope;
+
+  BufferPool::Stats stats = IsolateData::Current()->bufferPool->GetStats();
+
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+
+  Nan::Set(ret, Nan::New("blocksAllocated").ToLocalChecked(),
+           Nan::New(static_cast<double>(stats.blocksAllocated)));
+  Nan::Set(ret, Nan::New("blocksReused").ToLocalChecked(),
+           Nan::New(static_cast<double>(stats.blocksReused)));
+  Nan::Set(ret, Nan::New("cachedBytes").ToLocalChecked(),
+           Nan::New(static_cast<double>(stats.cachedBytes)));
+
+  info.GetReturnValue().Set(ret);
+}
+
+NAN_METHOD(Easy::ReleasePooledBuffer) {
+  Nan::HandleScope scope;
+
+  if (!node::Buffer::HasInstance(info[0])) {
+    Nan::ThrowTypeError("Argument must be a Buffer.");
+    return;
+  }
+
+  v8::Local<v8::Object> buffer = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+
+  bool isReleased = IsolateData::Current()->bufferPool->ReleaseBuffer(buffer);
+
+  info.GetReturnValue().Set(Nan::New(isReleased));
+}
+
 }  // namespace NodeLibcurl
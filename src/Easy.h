@@ -7,10 +7,23 @@
 #ifndef NODELIBCURL_EASY_H
 #define NODELIBCURL_EASY_H
 
+#include "BufferSource.h"
+#include "ByteBuffer.h"
+#include "CurlMime.h"
+#include "Digest.h"
+#include "FileSink.h"
+#include "FileSource.h"
+#include "HeaderList.h"
+#include "HeaderParser.h"
+#include "OptionTemplate.h"
+#include "RingSink.h"
+#include "UploadQueue.h"
+
 #include <curl/curl.h>
 #include <nan.h>
 #include <node.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -18,6 +31,8 @@
 
 namespace NodeLibcurl {
 
+class Multi;
+
 class Easy : public Nan::ObjectWrap {
   class ToFree;
 
@@ -36,11 +51,16 @@ class Easy : public Nan::ObjectWrap {
   void MonitorSockets();
   void UnmonitorSockets();
 
+  size_t OnRead(char* ptr, size_t size, size_t nmemb);
   size_t OnData(char* data, size_t size, size_t nmemb);
   size_t OnHeader(char* data, size_t size, size_t nmemb);
+  size_t CallDataCallback(char* data, size_t size, size_t nmemb, bool isDataOwned);
+  size_t CollectData(const char* data, size_t n);
+  size_t CoalesceData(const char* data, size_t n);
+  v8::Local<v8::Object> NewChunkBuffer(const char* data, size_t length);
 
   // static members
-  static uint32_t counter;
+  static std::atomic<uint32_t> counter;
 
   // callbacks
   typedef std::map<CURLoption, std::shared_ptr<Nan::Callback>> CallbacksMap;
@@ -56,38 +76,96 @@ class Easy : public Nan::ObjectWrap {
       false;  // we need this flag because of
               // https://github.com/curl/curl/commit/907520c4b93616bddea15757bbf0bfb45cde8101
   bool isMonitoringSockets = false;
-
-  int32_t readDataFileDescriptor = -1;  // READDATA sets that
-  curl_off_t readDataOffset = -1;       // SEEKDATA sets that
+  bool isBufferPoolingEnabled = false;
+  bool isPostFieldsSizeFromView = false;  // POSTFIELDSIZE was set by a binary POSTFIELDS
+
+  ByteBuffer collectedData;  // body received when using WRITE_MODE_COLLECT
+  bool isCollectedDataPresized = false;
+  ByteBuffer pendingData;  // body received when using WRITE_MODE_COALESCE, not flushed yet
+  bool hasPendingDataError = false;
+  HeaderParser headerParser;  // used with HEADER_MODE_PARSE
+  Digest digest;              // setDigests sets the algorithms
+
+  FileSink* fileSink = nullptr;  // WRITEDATA sets that
+  int64_t writeDataOffset = -1;  // setWriteDataOffset sets that
+  bool isCompletionDeferred = false;
+  CURLcode deferredCompletionCode = CURLE_OK;
+
+  RingSink* ringSink = nullptr;  // setWriteRing sets that
+
+  FileSource* fileSource = nullptr;  // READDATA sets that
+  std::unique_ptr<BufferSource> bufferSource;  // setUploadBuffer and setUploadFile set that
+  std::unique_ptr<UploadQueue> uploadQueue;    // setUploadQueue sets that
+#if NODE_LIBCURL_VER_GE(7, 56, 0)
+  std::unique_ptr<CurlMime> mimePost;  // MIMEPOST and HTTPPOST set that
+#endif
   uint32_t id = counter++;
 
   // static methods
   template <typename TResultType, typename Tv8MappingType>
   static v8::Local<v8::Value> GetInfoTmpl(const Easy* obj, int infoId);
   static v8::Local<v8::Object> CreateV8ObjectFromCurlFileInfo(curl_fileinfo* fileInfo);
-
-  // persistent objects
-  static Nan::Persistent<v8::String> onDataCbSymbol;
-  static Nan::Persistent<v8::String> onHeaderCbSymbol;
+  static v8::Local<v8::Array> CreateV8ArrayFromHeaderParser(const HeaderParser& parser);
+  static bool SetOptValue(Easy* obj, v8::Local<v8::Value> opt, v8::Local<v8::Value> value,
+                          CURLcode& code);
 
  public:
   // operators
   bool operator==(const Easy& easy) const;
   bool operator!=(const Easy& other) const;
 
-  // js object constructor template
-  static Nan::Persistent<v8::FunctionTemplate> constructor;
+  // what is done with the body data received by WriteFunction
+  enum WriteMode {
+    WRITE_MODE_CALLBACK = 0,  // WRITEFUNCTION / onData is called for each chunk
+    WRITE_MODE_COLLECT = 1,   // chunks are stored natively, see takeCollectedData
+    WRITE_MODE_COALESCE = 2,  // chunks received in the same socket event are passed at once
+  };
+
+  // what is done with the header lines received by HeaderFunction
+  enum HeaderMode {
+    HEADER_MODE_CALLBACK = 0,  // HEADERFUNCTION / onHeader is called for each line
+    HEADER_MODE_PARSE = 1,     // lines are parsed natively, see takeParsedHeaders
+  };
 
   // members
   CURL* ch;
   bool isInsideMultiHandle = false;
+  bool isInsideThreadedMulti = false;  // the handle is being used by another thread
   bool isOpen = true;
+  WriteMode writeMode = WRITE_MODE_CALLBACK;
+  HeaderMode headerMode = HEADER_MODE_CALLBACK;
+  Multi* multi = nullptr;  // Multi instance this handle was added to
+  bool isPendingDataQueued = false;
+  // CURLPAUSE_* bits currently set, by Easy.pause, by callbacks returning a pause code, or
+  // by the components reading and writing data natively.
+  int pauseState = CURLPAUSE_CONT;
 
   // used to return callback errors when inside Multi interface
   Nan::Persistent<v8::Value> callbackError;
 
   // static members
-  static uint32_t currentOpenedHandles;
+  static std::atomic<uint32_t> currentOpenedHandles;  // of all isolates
+
+  // must be called right before a new transfer is started with this handle
+  void PrepareTransfer();
+  // status of the finished transfer, taking into account errors libcurl is not aware of
+  CURLcode GetTransferResult(CURLcode code);
+  void FlushPendingData();
+  // curl_easy_pause replaces the whole pause state, these only change the given direction,
+  // so a component resuming its side of the transfer does not undo a pause set by another one.
+  void PauseDirection(int direction);
+  void ResumeDirection(int direction);
+  // used by the Multi handle to wait for the WRITEDATA file writes before reporting the
+  // transfer as finished, returns true if the completion was deferred.
+  bool DeferCompletion(CURLcode code);
+  void OnFileSinkDrained();
+  // called by the Multi instance after removing this handle, or when it is closed
+  void OnRemovedFromMulti();
+  // must be called after the transfer finished
+  void EndTransfer();
+  // a ThreadedMulti can only run transfers that never call into js, if this returns false
+  // reason is set to what prevents it.
+  bool CanRunOnThread(const char*& reason) const;
 
   // export Easy to js
   static NAN_MODULE_INIT(Initialize);
@@ -96,7 +174,10 @@ class Easy : public Nan::ObjectWrap {
   static NAN_METHOD(New);
   static NAN_GETTER(IdGetter);
   static NAN_GETTER(IsInsideMultiHandleGetter);
+  static NAN_GETTER(PauseStateGetter);
   static NAN_METHOD(SetOpt);
+  static NAN_METHOD(SetOpts);
+  static NAN_METHOD(ApplyTemplate);
   static NAN_METHOD(GetInfo);
   static NAN_METHOD(Send);
   static NAN_METHOD(Recv);
@@ -105,11 +186,30 @@ class Easy : public Nan::ObjectWrap {
   static NAN_METHOD(Pause);
   static NAN_METHOD(Reset);
   static NAN_METHOD(DupHandle);
+  static NAN_METHOD(SetWriteMode);
+  static NAN_METHOD(TakeCollectedData);
+  static NAN_METHOD(TakeCollectedDataAsString);
+  static NAN_METHOD(TakeCollectedDataAsJson);
+  static NAN_METHOD(SetBufferPooling);
+  static NAN_METHOD(SetHeaderMode);
+  static NAN_METHOD(TakeParsedHeaders);
+  static NAN_METHOD(SetWriteDataOffset);
+  static NAN_METHOD(SetWriteRing);
+  static NAN_METHOD(WriteRingConsumed);
+  static NAN_METHOD(SetUploadBuffer);
+  static NAN_METHOD(SetUploadFile);
+  static NAN_METHOD(SetUploadQueue);
+  static NAN_METHOD(WriteUploadQueue);
+  static NAN_METHOD(EndUploadQueue);
+  static NAN_METHOD(SetDigests);
+  static NAN_METHOD(GetDigest);
   static NAN_METHOD(OnSocketEvent);
   static NAN_METHOD(MonitorSocketEvents);
   static NAN_METHOD(UnmonitorSocketEvents);
   static NAN_METHOD(Close);
   static NAN_METHOD(StrError);
+  static NAN_METHOD(GetBufferPoolStats);
+  static NAN_METHOD(ReleasePooledBuffer);
 
   // cURL callbacks
   static size_t ReadFunction(char* ptr, size_t size, size_t nmemb, void* userdata);
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "FileMapping.h"
+
+#include "IsolateData.h"
+
+#include <uv.h>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace NodeLibcurl {
+
+std::map<FileMapping::Key, std::weak_ptr<FileMapping>> FileMapping::mappings;
+std::mutex FileMapping::mappingsMutex;
+
+bool FileMapping::Key::operator<(const Key& that) const {
+  if (this->device != that.device) return this->device < that.device;
+  if (this->inode != that.inode) return this->inode < that.inode;
+  if (this->size != that.size) return this->size < that.size;
+  return this->modifiedAt < that.modifiedAt;
+}
+
+FileMapping::FileMapping(const Key& key, const char* data, size_t length)
+    : key(key), data(data), length(length) {}
+
+FileMapping::~FileMapping() {
+  {
+    std::lock_guard<std::mutex> lock(mappingsMutex);
+
+    // the file could have been mapped again after this one was released
+    auto it = mappings.find(this->key);
+    if (it != mappings.end() && it->second.expired()) {
+      mappings.erase(it);
+    }
+  }
+
+  if (this->data) {
+#ifdef _WIN32
+    UnmapViewOfFile(this->data);
+#else
+    munmap(const_cast<char*>(this->data), this->length);
+#endif
+  }
+}
+
+std::shared_ptr<FileMapping> FileMapping::Open(const std::string& path, std::string& error) {
+  uv_fs_t req;
+
+  int fd = uv_fs_open(IsolateData::Current()->loop, &req, path.c_str(), UV_FS_O_RDONLY, 0, NULL);
+  uv_fs_req_cleanup(&req);
+
+  if (fd < 0) {
+    error = uv_strerror(fd);
+    return nullptr;
+  }
+
+  std::shared_ptr<FileMapping> mapping = FileMapping::Map(fd, error);
+
+  // the mapping stays valid after the file is closed
+  uv_fs_close(IsolateData::Current()->loop, &req, fd, NULL);
+  uv_fs_req_cleanup(&req);
+
+  return mapping;
+}
+
+std::shared_ptr<FileMapping> FileMapping::Open(int fd, std::string& error) {
+  return FileMapping::Map(fd, error);
+}
+
+std::shared_ptr<FileMapping> FileMapping::Map(int fd, std::string& error) {
+  Key key;
+
+#ifdef _WIN32
+  HANDLE handle = uv_get_osfhandle(fd);
+  BY_HANDLE_FILE_INFORMATION info;
+
+  if (handle == INVALID_HANDLE_VALUE || !GetFileInformationByHandle(handle, &info)) {
+    error = "Invalid file descriptor.";
+    return nullptr;
+  }
+
+  key.device = info.dwVolumeSerialNumber;
+  key.inode = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+  key.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+  key.modifiedAt = (static_cast<int64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                   info.ftLastWriteTime.dwLowDateTime;
+#else
+  struct stat info;
+
+  if (fstat(fd, &info) != 0) {
+    error = std::strerror(errno);
+    return nullptr;
+  }
+
+  if (!S_ISREG(info.st_mode)) {
+    error = "Only regular files can be mapped.";
+    return nullptr;
+  }
+
+  key.device = static_cast<uint64_t>(info.st_dev);
+  key.inode = static_cast<uint64_t>(info.st_ino);
+  key.size = static_cast<uint64_t>(info.st_size);
+  // whole seconds would reuse the mapping of a file rewritten with the same size within a second
+#if defined(__APPLE__)
+  key.modifiedAt = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 +
+                   static_cast<int64_t>(info.st_mtimespec.tv_nsec);
+#else
+  key.modifiedAt = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 +
+                   static_cast<int64_t>(info.st_mtim.tv_nsec);
+#endif
+#endif
+
+  if (key.size > std::numeric_limits<size_t>::max()) {
+    error = "File is too big to be mapped.";
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mappingsMutex);
+
+  auto it = mappings.find(key);
+  if (it != mappings.end()) {
+    std::shared_ptr<FileMapping> mapping = it->second.lock();
+
+    if (mapping) {
+      return mapping;
+    }
+  }
+
+  size_t length = static_cast<size_t>(key.size);
+  char* data = nullptr;
+
+  // empty files cannot be mapped, there is nothing to read from them anyway
+  if (length > 0) {
+#ifdef _WIN32
+    HANDLE fileMapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (fileMapping) {
+      data = static_cast<char*>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, length));
+      // the view keeps the mapping alive
+      CloseHandle(fileMapping);
+    }
+
+    if (!data) {
+      error = "Could not map the file, error code " + std::to_string(GetLastError()) + ".";
+      return nullptr;
+    }
+#else
+    void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+
+    if (address == MAP_FAILED) {
+      error = std::strerror(errno);
+      return nullptr;
+    }
+
+    data = static_cast<char*>(address);
+
+    // uploads read the file from start to end, this makes the kernel read ahead aggressively
+    madvise(address, length, MADV_SEQUENTIAL);
+#endif
+  }
+
+  std::shared_ptr<FileMapping> mapping(new FileMapping(key, data, length));
+  mappings[key] = mapping;
+
+  return mapping;
+}
+
+}  // namespace NodeLibcurl
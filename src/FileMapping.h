@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_FILEMAPPING_H
+#define NODELIBCURL_FILEMAPPING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace NodeLibcurl {
+
+// A read-only memory mapping of a whole file, used to upload it (set with setUploadFile).
+// Mappings of the same file, which was not modified in between, are shared by all handles
+// using them, the file is unmapped when the last one releases it.
+//
+// The pages are read from the file when they are accessed, so if it is truncated while mapped,
+// reading past its new end raises SIGBUS (an access violation on Windows) inside libcurl,
+// which crashes the process. Files that can be truncated while uploaded must not be used here.
+class FileMapping {
+  // identifies the contents of a file
+  struct Key {
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    // with the best precision available, nanoseconds on POSIX, 100ns intervals on Windows
+    int64_t modifiedAt;
+
+    bool operator<(const Key& that) const;
+  };
+
+  FileMapping(const FileMapping& that);
+  FileMapping& operator=(const FileMapping& that);
+
+  FileMapping(const Key& key, const char* data, size_t length);
+
+  static std::shared_ptr<FileMapping> Map(int fd, std::string& error);
+
+  // mappings currently in use, by the file they map
+  static std::map<Key, std::weak_ptr<FileMapping>> mappings;
+  static std::mutex mappingsMutex;
+
+  Key key;
+
+ public:
+  ~FileMapping();
+
+  const char* const data;
+  const size_t length;
+
+  // on failure nullptr is returned, and error is set to the reason
+  static std::shared_ptr<FileMapping> Open(const std::string& path, std::string& error);
+  // the file descriptor is not closed, and can be closed right after this returns.
+  static std::shared_ptr<FileMapping> Open(int fd, std::string& error);
+};
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "FileSink.h"
+
+#include "Easy.h"
+#include "IsolateData.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#define FILE_SINK_SEGMENT_SIZE (64 * 1024)
+// the transfer is paused when more than this is waiting to be written
+#define FILE_SINK_MAX_QUEUED_BYTES (1024 * 1024)
+// and resumed when it goes below this
+#define FILE_SINK_RESUME_QUEUED_BYTES (256 * 1024)
+#define FILE_SINK_MAX_SPARE_SEGMENTS 16
+
+namespace NodeLibcurl {
+
+FileSink::FileSink(Easy* easy, uv_file fd, int64_t offset)
+    : easy(easy), fd(fd), initialOffset(offset), offset(offset) {
+  this->req.data = this;
+}
+
+FileSink::~FileSink() {
+  this->ReleaseSegments(this->pending);
+  this->ReleaseSegments(this->inflight);
+
+  for (size_t i = 0; i < this->spare.size(); i++) {
+    std::free(this->spare[i].data);
+  }
+}
+
+void FileSink::Prepare() {
+  this->offset = this->initialOffset;
+  this->errorCode = 0;
+}
+
+void FileSink::SetOffset(int64_t offset) {
+  this->initialOffset = offset;
+  this->offset = offset;
+}
+
+bool FileSink::IsBusy() const { return this->isWriting || this->pendingBytes > 0; }
+
+void FileSink::Detach() {
+  this->easy = nullptr;
+
+  this->ReleaseSegments(this->pending);
+  this->pendingBytes = 0;
+
+  if (!this->isWriting) {
+    delete this;
+  }
+}
+
+void FileSink::ReleaseSegments(std::vector<Segment>& segments) {
+  for (size_t i = 0; i < segments.size(); i++) {
+    if (this->spare.size() < FILE_SINK_MAX_SPARE_SEGMENTS &&
+        segments[i].capacity == FILE_SINK_SEGMENT_SIZE) {
+      segments[i].length = 0;
+      this->spare.push_back(segments[i]);
+    } else {
+      std::free(segments[i].data);
+    }
+  }
+
+  segments.clear();
+}
+
+size_t FileSink::Write(const char* data, size_t n, bool isAsync) {
+  // returning something different than n aborts the transfer
+  if (this->errorCode < 0) {
+    return 0;
+  }
+
+  if (!isAsync) {
+    return this->WriteSync(data, n);
+  }
+
+  // libcurl is going to pass this same chunk again after the transfer is unpaused
+  if (this->pendingBytes + this->inflightBytes >= FILE_SINK_MAX_QUEUED_BYTES) {
+    this->isPaused = true;
+    return CURL_WRITEFUNC_PAUSE;
+  }
+
+  size_t copied = 0;
+
+  while (copied < n) {
+    if (this->pending.empty() || this->pending.back().length == this->pending.back().capacity) {
+      Segment segment;
+
+      if (!this->spare.empty() && n - copied <= FILE_SINK_SEGMENT_SIZE) {
+        segment = this->spare.back();
+        this->spare.pop_back();
+      } else {
+        segment.capacity = std::max(static_cast<size_t>(FILE_SINK_SEGMENT_SIZE), n - copied);
+        segment.length = 0;
+        segment.data = static_cast<char*>(std::malloc(segment.capacity));
+
+        if (!segment.data) {
+          this->errorCode = UV_ENOMEM;
+          return 0;
+        }
+      }
+
+      this->pending.push_back(segment);
+    }
+
+    Segment& segment = this->pending.back();
+    size_t length = std::min(segment.capacity - segment.length, n - copied);
+
+    std::memcpy(segment.data + segment.length, data + copied, length);
+    segment.length += length;
+    copied += length;
+  }
+
+  this->pendingBytes += n;
+
+  if (!this->isWriting) {
+    this->StartWrite();
+  }
+
+  return n;
+}
+
+size_t FileSink::WriteSync(const char* data, size_t n) {
+  size_t written = 0;
+
+  while (written < n) {
+    uv_fs_t writeReq;
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data + written),
+                               static_cast<unsigned int>(n - written));
+
+    int result = uv_fs_write(IsolateData::Current()->loop, &writeReq, this->fd, &buf, 1,
+                             this->offset, NULL);
+    uv_fs_req_cleanup(&writeReq);
+
+    if (result < 0) {
+      this->errorCode = result;
+      return 0;
+    }
+
+    if (this->offset >= 0) {
+      this->offset += result;
+    }
+
+    written += static_cast<size_t>(result);
+  }
+
+  return n;
+}
+
+void FileSink::StartWrite() {
+  this->inflight.swap(this->pending);
+  this->inflightBytes = this->pendingBytes;
+  this->pendingBytes = 0;
+
+  this->bufs.clear();
+  for (size_t i = 0; i < this->inflight.size(); i++) {
+    this->bufs.push_back(uv_buf_init(this->inflight[i].data,
+                                     static_cast<unsigned int>(this->inflight[i].length)));
+  }
+
+  int result = uv_fs_write(IsolateData::Current()->loop, &this->req, this->fd, &this->bufs[0],
+                           static_cast<unsigned int>(this->bufs.size()), this->offset,
+                           FileSink::OnWrite);
+
+  if (result < 0) {
+    this->errorCode = result;
+    this->ReleaseSegments(this->inflight);
+    this->inflightBytes = 0;
+    return;
+  }
+
+  this->isWriting = true;
+}
+
+// called on the loop thread after the write ran on the threadpool
+void FileSink::OnWrite(uv_fs_t* req) {
+  FileSink* sink = static_cast<FileSink*>(req->data);
+
+  ssize_t result = req->result;
+  uv_fs_req_cleanup(req);
+
+  sink->isWriting = false;
+
+  if (!sink->easy) {
+    delete sink;
+    return;
+  }
+
+  if (result < 0) {
+    sink->errorCode = static_cast<int>(result);
+  } else {
+    size_t written = static_cast<size_t>(result);
+
+    if (sink->offset >= 0) {
+      sink->offset += static_cast<int64_t>(written);
+    }
+
+    // short write, submit what is left of the same buffers again
+    if (written > 0 && written < sink->inflightBytes) {
+      sink->inflightBytes -= written;
+
+      std::vector<uv_buf_t>::iterator it = sink->bufs.begin();
+      while (written >= it->len) {
+        written -= it->len;
+        ++it;
+      }
+      it->base += written;
+      it->len -= static_cast<unsigned int>(written);
+      sink->bufs.erase(sink->bufs.begin(), it);
+
+      int retry = uv_fs_write(req->loop, &sink->req, sink->fd, &sink->bufs[0],
+                              static_cast<unsigned int>(sink->bufs.size()), sink->offset,
+                              FileSink::OnWrite);
+
+      if (retry == 0) {
+        sink->isWriting = true;
+        return;
+      }
+
+      sink->errorCode = retry;
+    } else if (written == 0 && sink->inflightBytes > 0) {
+      sink->errorCode = UV_EIO;
+    }
+  }
+
+  sink->ReleaseSegments(sink->inflight);
+  sink->inflightBytes = 0;
+
+  if (sink->errorCode < 0) {
+    sink->ReleaseSegments(sink->pending);
+    sink->pendingBytes = 0;
+  } else if (sink->pendingBytes > 0) {
+    sink->StartWrite();
+  }
+
+  // if the write failed, resuming makes libcurl call Write again, which aborts the transfer.
+  if (sink->isPaused &&
+      (sink->errorCode < 0 ||
+       sink->pendingBytes + sink->inflightBytes < FILE_SINK_RESUME_QUEUED_BYTES)) {
+    sink->isPaused = false;
+    sink->easy->ResumeDirection(CURLPAUSE_RECV);
+  }
+
+  if (!sink->IsBusy()) {
+    sink->easy->OnFileSinkDrained();
+  }
+}
+
+}  // namespace NodeLibcurl
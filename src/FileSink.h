@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_FILESINK_H
+#define NODELIBCURL_FILESINK_H
+
+#include <curl/curl.h>
+#include <uv.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NodeLibcurl {
+
+class Easy;
+
+// Writes the body received by an Easy handle to a file descriptor (set with WRITEDATA).
+// When the handle is inside a Multi instance the chunks are queued into fixed size segments,
+// which are written with a single vectored write on the libuv threadpool, while the next ones
+// are being queued. If too much data is queued the transfer is paused until the writes catch up.
+// With Easy.perform the chunks are written synchronously.
+class FileSink {
+  struct Segment {
+    char* data;
+    size_t length;
+    size_t capacity;
+  };
+
+  FileSink(const FileSink& that);
+  FileSink& operator=(const FileSink& that);
+
+  ~FileSink();
+
+  void StartWrite();
+  void ReleaseSegments(std::vector<Segment>& segments);
+  size_t WriteSync(const char* data, size_t n);
+
+  static void OnWrite(uv_fs_t* req);
+
+  Easy* easy;
+  uv_file fd;
+  int64_t initialOffset;
+  int64_t offset;  // -1 means the current file position
+
+  std::vector<Segment> pending;
+  size_t pendingBytes = 0;
+  std::vector<Segment> inflight;
+  size_t inflightBytes = 0;
+  std::vector<Segment> spare;
+
+  uv_fs_t req;
+  std::vector<uv_buf_t> bufs;
+  bool isWriting = false;
+  bool isPaused = false;
+
+ public:
+  FileSink(Easy* easy, uv_file fd, int64_t offset);
+
+  // libuv error code of the first failed write, 0 if none failed
+  int errorCode = 0;
+
+  // must be called before each transfer starts
+  void Prepare();
+  // position of the file where the body is going to be written, -1 to use the current one
+  void SetOffset(int64_t offset);
+
+  // to be used by the WRITEFUNCTION callback, the return value has the same meaning
+  size_t Write(const char* data, size_t n, bool isAsync);
+
+  // whether there is data waiting to be written
+  bool IsBusy() const;
+
+  // the Easy handle does not need this sink anymore, pending data is dropped, and the sink
+  // is deleted as soon as the write in progress, if any, finishes.
+  void Detach();
+};
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "FileSource.h"
+
+#include "Easy.h"
+#include "IsolateData.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// same than the biggest upload buffer libcurl uses by default
+#define FILE_SOURCE_BLOCK_SIZE (64 * 1024)
+
+namespace NodeLibcurl {
+
+FileSource::FileSource(Easy* easy, uv_file fd) : easy(easy), fd(fd), offset(-1), readOffset(-1) {
+  for (int i = 0; i < 2; i++) {
+    this->blocks[i].data = nullptr;
+    this->blocks[i].length = 0;
+    this->blocks[i].position = 0;
+    this->blocks[i].state = BLOCK_EMPTY;
+  }
+
+  this->req.data = this;
+}
+
+FileSource::~FileSource() {
+  for (int i = 0; i < 2; i++) {
+    std::free(this->blocks[i].data);
+  }
+}
+
+void FileSource::Prepare() {
+  this->errorCode = 0;
+  this->Discard();
+}
+
+void FileSource::Seek(int64_t offset) {
+  this->offset = offset;
+  this->Discard();
+}
+
+// drops the data read ahead, the next read starts at the position of the next byte served
+void FileSource::Discard() {
+  this->generation++;
+
+  for (int i = 0; i < 2; i++) {
+    // the block being read is released after the read finishes
+    if (this->blocks[i].state != BLOCK_READING) {
+      this->blocks[i].state = BLOCK_EMPTY;
+    }
+  }
+
+  this->front = 0;
+  this->readOffset = this->offset;
+  this->isEof = false;
+  this->isPaused = false;
+}
+
+void FileSource::Detach() {
+  this->easy = nullptr;
+
+  if (this->readingBlock < 0) {
+    delete this;
+  }
+}
+
+size_t FileSource::Read(char* ptr, size_t n, bool isAsync) {
+  if (this->errorCode < 0) {
+    return CURL_READFUNC_ABORT;
+  }
+
+  if (!isAsync) {
+    return this->ReadSync(ptr, n);
+  }
+
+  Block& block = this->blocks[this->front];
+
+  if (block.state != BLOCK_READY) {
+    if (this->isEof) {
+      return 0;
+    }
+
+    this->StartRead();
+
+    if (this->errorCode < 0) {
+      return CURL_READFUNC_ABORT;
+    }
+
+    // libcurl is going to call this again after the transfer is unpaused
+    this->isPaused = true;
+    return CURL_READFUNC_PAUSE;
+  }
+
+  size_t length = std::min(n, block.length - block.position);
+
+  std::memcpy(ptr, block.data + block.position, length);
+  block.position += length;
+
+  if (this->offset >= 0) {
+    this->offset += static_cast<int64_t>(length);
+  }
+
+  if (block.position == block.length) {
+    block.state = BLOCK_EMPTY;
+    this->front ^= 1;
+  }
+
+  // keep the other block filling while this one is being served
+  this->StartRead();
+
+  return length;
+}
+
+size_t FileSource::ReadSync(char* ptr, size_t n) {
+  uv_fs_t readReq;
+  uv_buf_t uvbuf = uv_buf_init(ptr, static_cast<unsigned int>(n));
+
+  int result =
+      uv_fs_read(IsolateData::Current()->loop, &readReq, this->fd, &uvbuf, 1, this->offset, NULL);
+  uv_fs_req_cleanup(&readReq);
+
+  if (result < 0) {
+    this->errorCode = result;
+    return CURL_READFUNC_ABORT;
+  }
+
+  if (this->offset >= 0) {
+    this->offset += result;
+  }
+
+  // keep the position used by the async reads in sync
+  this->readOffset = this->offset;
+
+  return static_cast<size_t>(result);
+}
+
+void FileSource::StartRead() {
+  if (this->readingBlock >= 0 || this->isEof) {
+    return;
+  }
+
+  // the block served next must be filled first
+  int index = this->blocks[this->front].state == BLOCK_EMPTY
+                  ? this->front
+                  : this->blocks[this->front ^ 1].state == BLOCK_EMPTY ? this->front ^ 1 : -1;
+
+  if (index < 0) {
+    return;
+  }
+
+  Block& block = this->blocks[index];
+
+  if (!block.data) {
+    block.data = static_cast<char*>(std::malloc(FILE_SOURCE_BLOCK_SIZE));
+
+    if (!block.data) {
+      this->errorCode = UV_ENOMEM;
+      return;
+    }
+  }
+
+  this->buf = uv_buf_init(block.data, FILE_SOURCE_BLOCK_SIZE);
+
+  int result = uv_fs_read(IsolateData::Current()->loop, &this->req, this->fd, &this->buf, 1,
+                          this->readOffset, FileSource::OnRead);
+
+  if (result < 0) {
+    this->errorCode = result;
+    return;
+  }
+
+  block.state = BLOCK_READING;
+  this->readingBlock = index;
+  this->readingGeneration = this->generation;
+}
+
+// called on the loop thread after the read ran on the threadpool
+void FileSource::OnRead(uv_fs_t* req) {
+  FileSource* source = static_cast<FileSource*>(req->data);
+
+  ssize_t result = req->result;
+  uv_fs_req_cleanup(req);
+
+  Block& block = source->blocks[source->readingBlock];
+  source->readingBlock = -1;
+
+  if (!source->easy) {
+    delete source;
+    return;
+  }
+
+  // the data was discarded while it was being read, start over
+  if (source->readingGeneration != source->generation) {
+    block.state = BLOCK_EMPTY;
+  } else if (result < 0) {
+    block.state = BLOCK_EMPTY;
+    source->errorCode = static_cast<int>(result);
+  } else if (result == 0) {
+    block.state = BLOCK_EMPTY;
+    source->isEof = true;
+  } else {
+    block.state = BLOCK_READY;
+    block.length = static_cast<size_t>(result);
+    block.position = 0;
+
+    if (source->readOffset >= 0) {
+      source->readOffset += result;
+    }
+  }
+
+  // read ahead into the other block
+  if (source->errorCode == 0) {
+    source->StartRead();
+  }
+
+  // if the read failed, resuming makes libcurl call Read again, which aborts the transfer.
+  if (source->isPaused && (source->blocks[source->front].state == BLOCK_READY ||
+                           source->isEof || source->errorCode < 0)) {
+    source->isPaused = false;
+    source->easy->ResumeDirection(CURLPAUSE_SEND);
+  }
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_FILESOURCE_H
+#define NODELIBCURL_FILESOURCE_H
+
+#include <curl/curl.h>
+#include <uv.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace NodeLibcurl {
+
+class Easy;
+
+// Reads the data to be uploaded by an Easy handle from a file descriptor (set with READDATA).
+// When the handle is inside a Multi instance the file is read ahead on the libuv threadpool,
+// into two blocks, so one can be served to libcurl while the other one is being filled.
+// If no data is available yet the transfer is paused until the read in progress finishes.
+// With Easy.perform the file is read synchronously.
+class FileSource {
+  enum BlockState {
+    BLOCK_EMPTY = 0,
+    BLOCK_READING,
+    BLOCK_READY,
+  };
+
+  struct Block {
+    char* data;
+    size_t length;
+    size_t position;  // bytes already served
+    BlockState state;
+  };
+
+  FileSource(const FileSource& that);
+  FileSource& operator=(const FileSource& that);
+
+  ~FileSource();
+
+  void Discard();
+  void StartRead();
+  size_t ReadSync(char* ptr, size_t n);
+
+  static void OnRead(uv_fs_t* req);
+
+  Easy* easy;
+  uv_file fd;
+  int64_t offset;      // position of the next byte served to libcurl, -1 means the current one
+  int64_t readOffset;  // position of the next byte read from the file, -1 means the current one
+
+  Block blocks[2];
+  int front = 0;  // block being served
+
+  uv_fs_t req;
+  uv_buf_t buf;
+  int readingBlock = -1;
+  // incremented every time the data read ahead is discarded, reads from before that are ignored
+  uint32_t generation = 0;
+  uint32_t readingGeneration = 0;
+
+  bool isEof = false;
+  bool isPaused = false;
+
+ public:
+  FileSource(Easy* easy, uv_file fd);
+
+  // libuv error code of the first failed read, 0 if none failed
+  int errorCode = 0;
+
+  // must be called before each transfer starts
+  void Prepare();
+  // used by the SEEKFUNCTION callback
+  void Seek(int64_t offset);
+
+  // to be used by the READFUNCTION callback, the return value has the same meaning
+  size_t Read(char* ptr, size_t n, bool isAsync);
+
+  // the Easy handle does not need this source anymore, it is deleted as soon as the read in
+  // progress, if any, finishes.
+  void Detach();
+};
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "HeaderList.h"
+
+#include "IsolateData.h"
+
+#include <utility>
+
+namespace NodeLibcurl {
+
+HeaderList::Lines::Lines(std::vector<std::string>&& strings, std::shared_ptr<const Lines> next)
+    : strings(std::move(strings)), next(next) {
+  size_t count = this->strings.size();
+
+  this->nodes.resize(count);
+
+  for (size_t i = 0; i < count; i++) {
+    // libcurl never changes the data
+    this->nodes[i].data = &this->strings[i][0];
+    this->nodes[i].next = i + 1 < count ? &this->nodes[i + 1] : NULL;
+  }
+
+  if (count) {
+    this->nodes[count - 1].next = this->next ? this->next->Head() : NULL;
+  }
+}
+
+curl_slist* HeaderList::Lines::Head() const {
+  if (!this->nodes.empty()) {
+    return const_cast<curl_slist*>(&this->nodes[0]);
+  }
+
+  return this->next ? this->next->Head() : NULL;
+}
+
+HeaderList::HeaderList() {}
+
+bool HeaderList::ToStrings(v8::Local<v8::Value> value, std::vector<std::string>& strings) {
+  if (value->IsUndefined()) {
+    return true;
+  }
+
+  if (!value->IsArray()) {
+    Nan::ThrowTypeError("Header lines must be an Array of strings.");
+    return false;
+  }
+
+  v8::Local<v8::Array> array = value.As<v8::Array>();
+  uint32_t length = array->Length();
+
+  strings.reserve(length);
+
+  for (uint32_t i = 0; i < length; i++) {
+    v8::Local<v8::Value> line = Nan::Get(array, i).ToLocalChecked();
+
+    if (!line->IsString()) {
+      Nan::ThrowTypeError("Header lines must be an Array of strings.");
+      return false;
+    }
+
+    Nan::Utf8String lineUtf8(line);
+    strings.emplace_back(*lineUtf8, static_cast<size_t>(lineUtf8.length()));
+  }
+
+  return true;
+}
+
+NAN_MODULE_INIT(HeaderList::Initialize) {
+  Nan::HandleScope scope;
+
+  v8::Local<v8::FunctionTemplate> tmpl = Nan::New<v8::FunctionTemplate>(HeaderList::New);
+  tmpl->SetClassName(Nan::New("HeaderList").ToLocalChecked());
+  tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  // prototype methods
+  Nan::SetPrototypeMethod(tmpl, "extend", HeaderList::Extend);
+  Nan::SetPrototypeMethod(tmpl, "toArray", HeaderList::ToArray);
+
+  IsolateData::Current()->headerListConstructor.Reset(tmpl);
+
+  Nan::Set(target, Nan::New("HeaderList").ToLocalChecked(),
+           Nan::GetFunction(tmpl).ToLocalChecked());
+}
+
+NAN_METHOD(HeaderList::New) {
+  if (!info.IsConstructCall()) {
+    Nan::ThrowError("You must use \"new\" to instantiate this object.");
+    return;
+  }
+
+  std::vector<std::string> strings;
+
+  if (!HeaderList::ToStrings(info[0], strings)) {
+    return;
+  }
+
+  HeaderList* obj = new HeaderList();
+  obj->lines = std::make_shared<Lines>(std::move(strings), nullptr);
+
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+// returns a new list, with the given lines followed by the ones of this list, which are shared.
+NAN_METHOD(HeaderList::Extend) {
+  Nan::HandleScope scope;
+
+  HeaderList* obj = Nan::ObjectWrap::Unwrap<HeaderList>(info.This());
+
+  std::vector<std::string> strings;
+
+  if (!HeaderList::ToStrings(info[0], strings)) {
+    return;
+  }
+
+  // the constructor of this object is used, so the new list has the same class
+  v8::Local<v8::Value> cons =
+      Nan::Get(info.This(), Nan::New("constructor").ToLocalChecked()).ToLocalChecked();
+
+  if (!cons->IsFunction()) {
+    cons =
+        Nan::GetFunction(Nan::New(IsolateData::Current()->headerListConstructor)).ToLocalChecked();
+  }
+
+  v8::Local<v8::Object> extendedObj;
+
+  if (!Nan::NewInstance(cons.As<v8::Function>(), 0, nullptr).ToLocal(&extendedObj)) {
+    return;
+  }
+
+  if (!Nan::New(IsolateData::Current()->headerListConstructor)->HasInstance(extendedObj)) {
+    Nan::ThrowTypeError("The constructor of the list did not create a HeaderList.");
+    return;
+  }
+
+  HeaderList* extended = Nan::ObjectWrap::Unwrap<HeaderList>(extendedObj);
+  extended->lines = std::make_shared<Lines>(std::move(strings), obj->lines);
+
+  info.GetReturnValue().Set(extendedObj);
+}
+
+NAN_METHOD(HeaderList::ToArray) {
+  Nan::HandleScope scope;
+
+  HeaderList* obj = Nan::ObjectWrap::Unwrap<HeaderList>(info.This());
+
+  v8::Local<v8::Array> array = Nan::New<v8::Array>();
+  uint32_t index = 0;
+
+  for (curl_slist* node = obj->lines->Head(); node; node = node->next) {
+    Nan::Set(array, index++, Nan::New(node->data).ToLocalChecked());
+  }
+
+  info.GetReturnValue().Set(array);
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_HEADERLIST_H
+#define NODELIBCURL_HEADERLIST_H
+
+#include <curl/curl.h>
+#include <nan.h>
+#include <node.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Immutable curl_slist built once from js, which can be set on any number of handles, with the
+// list options like HTTPHEADER, without being converted again.
+// Extending a list creates a new one with only the added lines, which is linked to the original
+// list, so adding a line for a single request does not copy the others.
+class HeaderList : public Nan::ObjectWrap {
+ public:
+  // the nodes are not allocated by libcurl, so they are not freed with curl_slist_free_all.
+  class Lines {
+    Lines(const Lines& that);
+    Lines& operator=(const Lines& that);
+
+   public:
+    Lines(std::vector<std::string>&& strings, std::shared_ptr<const Lines> next);
+
+    std::vector<std::string> strings;
+    std::vector<curl_slist> nodes;
+    std::shared_ptr<const Lines> next;  // list the last node is linked to
+
+    // first node of the whole list, NULL if it is empty
+    curl_slist* Head() const;
+  };
+
+ private:
+  HeaderList();
+
+  HeaderList(const HeaderList& that);
+  HeaderList& operator=(const HeaderList& that);
+
+  // returns false if a js exception was thrown
+  static bool ToStrings(v8::Local<v8::Value> value, std::vector<std::string>& strings);
+
+ public:
+  // members
+  std::shared_ptr<const Lines> lines;
+
+  // export HeaderList to js
+  static NAN_MODULE_INIT(Initialize);
+
+  // js available methods
+  static NAN_METHOD(New);
+  static NAN_METHOD(Extend);
+  static NAN_METHOD(ToArray);
+};
+}  // namespace NodeLibcurl
+#endif
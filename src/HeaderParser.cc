@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "HeaderParser.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace NodeLibcurl {
+
+namespace {
+// same characters matched by \s in a js regex, minus the unicode ones
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool IsSetCookie(const char* key, size_t length) {
+  static const char setCookie[] = "set-cookie";
+
+  if (length != sizeof(setCookie) - 1) {
+    return false;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    char c = key[i];
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    if (c != setCookie[i]) return false;
+  }
+
+  return true;
+}
+}  // namespace
+
+HeaderParser::HeaderParser() : current(), isStatusLine(true) {}
+
+void HeaderParser::Clear() {
+  this->text.clear();
+  this->groups.clear();
+  this->current = Group();
+  this->isStatusLine = true;
+}
+
+void HeaderParser::Parse(const char* line, size_t length) {
+  // libcurl passes a full line each time, including the line terminator.
+  while (length && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+    length--;
+  }
+
+  if (this->isStatusLine) {
+    size_t offset = this->text.size();
+    this->text.append(line, length);
+    this->ParseStatusLine(offset, length);
+    this->isStatusLine = false;
+    return;
+  }
+
+  // empty line ends the current group
+  if (!length) {
+    this->groups.push_back(std::move(this->current));
+    this->current = Group();
+    this->isStatusLine = true;
+    return;
+  }
+
+  size_t offset = this->text.size();
+  this->text.append(line, length);
+  this->ParseField(offset, length);
+}
+
+void HeaderParser::Finish() {
+  // headers not followed by an empty line, like when the transfer failed midway
+  if (!this->isStatusLine) {
+    this->groups.push_back(std::move(this->current));
+    this->current = Group();
+    this->isStatusLine = true;
+  }
+}
+
+// <version> <code> <reason...>
+void HeaderParser::ParseStatusLine(size_t offset, size_t length) {
+  const char* line = this->text.data() + offset;
+  const char* end = line + length;
+
+  const char* versionEnd = static_cast<const char*>(std::memchr(line, ' ', length));
+  if (!versionEnd) versionEnd = end;
+
+  this->current.version.offset = offset;
+  this->current.version.length = static_cast<size_t>(versionEnd - line);
+
+  const char* codeStart = versionEnd < end ? versionEnd + 1 : end;
+  const char* codeEnd =
+      static_cast<const char*>(std::memchr(codeStart, ' ', static_cast<size_t>(end - codeStart)));
+  if (!codeEnd) codeEnd = end;
+
+  // parseInt(code || '0', 10)
+  if (codeStart == codeEnd) {
+    this->current.code = 0;
+  } else {
+    const char* c = codeStart;
+    bool isNegative = false;
+
+    while (c < codeEnd && IsSpace(*c)) c++;
+
+    if (c < codeEnd && (*c == '-' || *c == '+')) {
+      isNegative = *c == '-';
+      c++;
+    }
+
+    if (c < codeEnd && *c >= '0' && *c <= '9') {
+      double code = 0;
+      while (c < codeEnd && *c >= '0' && *c <= '9') {
+        code = code * 10 + (*c - '0');
+        c++;
+      }
+      this->current.code = isNegative ? -code : code;
+    } else {
+      this->current.code = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  const char* reasonStart = codeEnd < end ? codeEnd + 1 : end;
+  this->current.reason.offset = offset + static_cast<size_t>(reasonStart - line);
+  this->current.reason.length = static_cast<size_t>(end - reasonStart);
+}
+
+// <key>:<whitespace><value>, the value must have at least one character
+void HeaderParser::ParseField(size_t offset, size_t length) {
+  const char* line = this->text.data() + offset;
+  const char* end = line + length;
+  const char* colon = line;
+
+  Field field;
+  field.hasValue = false;
+
+  while ((colon = static_cast<const char*>(
+              std::memchr(colon, ':', static_cast<size_t>(end - colon))))) {
+    if (end - colon > 2 && IsSpace(colon[1])) {
+      field.hasValue = true;
+      break;
+    }
+    colon++;
+  }
+
+  if (field.hasValue) {
+    field.key.offset = offset;
+    field.key.length = static_cast<size_t>(colon - line);
+    field.value.offset = offset + field.key.length + 2;
+    field.value.length = length - field.key.length - 2;
+  } else {
+    field.key.offset = offset;
+    field.key.length = length;
+    field.value.offset = offset + length;
+    field.value.length = 0;
+  }
+
+  field.isSetCookie = IsSetCookie(line, field.key.length);
+
+  this->current.fields.push_back(field);
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_HEADERPARSER_H
+#define NODELIBCURL_HEADERPARSER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Incremental parser for the header lines received by the HEADERFUNCTION callback.
+// It follows the same rules than lib/parseHeaders.ts, each block of headers, which is ended
+// by an empty line, becomes a group with their status line and fields.
+// All text is kept inside a single string, the groups only store offsets into it.
+class HeaderParser {
+  HeaderParser(const HeaderParser& that);
+  HeaderParser& operator=(const HeaderParser& that);
+
+ public:
+  struct Slice {
+    size_t offset;
+    size_t length;
+  };
+
+  struct Field {
+    Slice key;
+    Slice value;
+    bool hasValue;
+    bool isSetCookie;
+  };
+
+  struct Group {
+    Slice version;
+    double code;  // NaN if the status code is not a number, like parseInt would return
+    Slice reason;
+    std::vector<Field> fields;
+  };
+
+  std::string text;
+  std::vector<Group> groups;
+
+  HeaderParser();
+
+  // parses a single header line, with or without the line terminator
+  void Parse(const char* line, size_t length);
+  // adds the group being parsed to the list of groups, even if it was not ended yet
+  void Finish();
+  void Clear();
+
+ private:
+  Group current;
+  bool isStatusLine;
+
+  void ParseStatusLine(size_t offset, size_t length);
+  void ParseField(size_t offset, size_t length);
+};
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "IsolateData.h"
+
+#include <node_version.h>
+
+namespace NodeLibcurl {
+
+// max amount of memory kept around by the pool backing chunks Buffers
+#define BUFFER_POOL_MAX_CACHED_BYTES (4 * 1024 * 1024)
+
+thread_local IsolateData* IsolateData::current = nullptr;
+
+IsolateData::IsolateData(v8::Isolate* isolate, uv_loop_t* loop)
+    : isolate(isolate),
+      loop(loop),
+      isMainThread(loop == uv_default_loop()),
+      bufferPool(BufferPool::Create(BUFFER_POOL_MAX_CACHED_BYTES)),
+      cleanupCallback(nullptr) {}
+
+IsolateData::~IsolateData() {
+  this->easyConstructor.Reset();
+  this->multiConstructor.Reset();
+  this->shareConstructor.Reset();
+  this->optionTemplateConstructor.Reset();
+  this->headerListConstructor.Reset();
+  this->onDataCbSymbol.Reset();
+  this->onHeaderCbSymbol.Reset();
+
+  // Buffers still backed by the pool keep it alive
+  this->bufferPool->Unref();
+
+  if (current == this) {
+    current = nullptr;
+  }
+}
+
+void IsolateData::Cleanup(void* arg) {
+  IsolateData* data = static_cast<IsolateData*>(arg);
+
+  if (data->cleanupCallback) {
+    data->cleanupCallback(data);
+  }
+
+  delete data;
+}
+
+IsolateData* IsolateData::Create(void (*callback)(IsolateData* data)) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+
+  IsolateData* data = new IsolateData(isolate, Nan::GetCurrentEventLoop());
+  data->cleanupCallback = callback;
+
+  current = data;
+
+#if NODE_MAJOR_VERSION >= 10
+  node::AddEnvironmentCleanupHook(isolate, IsolateData::Cleanup, data);
+#else
+  // workers are not available, so the main thread is the only one loading the addon
+  node::AtExit(IsolateData::Cleanup, data);
+#endif
+
+  return data;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_ISOLATEDATA_H
+#define NODELIBCURL_ISOLATEDATA_H
+
+#include "BufferPool.h"
+
+#include <nan.h>
+#include <node.h>
+#include <uv.h>
+
+namespace NodeLibcurl {
+
+// State of the addon for each isolate it is loaded in, the main thread and each worker thread
+// get their own, so the js objects and the libuv handles of one are never used by another.
+// An isolate only runs on a single thread, so the data of the current one is found through a
+// thread local pointer.
+class IsolateData {
+  IsolateData(const IsolateData& that);
+  IsolateData& operator=(const IsolateData& that);
+
+  IsolateData(v8::Isolate* isolate, uv_loop_t* loop);
+  ~IsolateData();
+
+  static void Cleanup(void* arg);
+
+  static thread_local IsolateData* current;
+
+ public:
+  v8::Isolate* isolate;
+  uv_loop_t* loop;  // event loop of the thread the isolate runs on
+  bool isMainThread;  // false for the isolates of worker threads
+
+  // js object constructor templates
+  Nan::Persistent<v8::FunctionTemplate> easyConstructor;
+  Nan::Persistent<v8::FunctionTemplate> multiConstructor;
+  Nan::Persistent<v8::FunctionTemplate> shareConstructor;
+  Nan::Persistent<v8::FunctionTemplate> optionTemplateConstructor;
+  Nan::Persistent<v8::FunctionTemplate> headerListConstructor;
+
+  Nan::Persistent<v8::String> onDataCbSymbol;
+  Nan::Persistent<v8::String> onHeaderCbSymbol;
+
+  BufferPool* bufferPool;  // backs the chunks when buffer pooling is enabled
+
+  // must be called when the addon is loaded, the data is deleted when the environment of the
+  // isolate is torn down, after callback is called with it.
+  static IsolateData* Create(void (*callback)(IsolateData* data));
+
+  // data of the isolate running on the current thread
+  static IsolateData* Current() { return current; }
+
+ private:
+  void (*cleanupCallback)(IsolateData* data);
+};
+}  // namespace NodeLibcurl
+#endif
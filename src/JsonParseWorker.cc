@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "JsonParseWorker.h"
+
+#include <cstdlib>
+
+namespace NodeLibcurl {
+
+JsonParseWorker::JsonParseWorker(Nan::Callback* callback, char* data, size_t length)
+    : Nan::AsyncWorker(callback, "trusted-curl:JsonParseWorker"), data(data), length(length) {}
+
+JsonParseWorker::~JsonParseWorker() {
+  if (this->data) {
+    std::free(this->data);
+  }
+}
+
+// runs on the threadpool
+void JsonParseWorker::Execute() {
+  if (!this->parser.Parse(this->data, this->length)) {
+    this->SetErrorMessage(this->parser.errorMessage.c_str());
+  }
+}
+
+void JsonParseWorker::HandleOKCallback() {
+  Nan::HandleScope scope;
+
+  size_t index = 0;
+  v8::Local<v8::Value> value = this->CreateValue(index);
+
+  // not needed anymore, no reason to wait for the worker to be deleted
+  this->parser.Clear();
+  std::free(this->data);
+  this->data = nullptr;
+
+  if (this->isStringTooLong) {
+    v8::Local<v8::Value> argv[] = {Nan::RangeError("JSON contains a string that is too long.")};
+    this->callback->Call(1, argv, this->async_resource);
+    return;
+  }
+
+  v8::Local<v8::Value> argv[] = {Nan::Null(), value};
+
+  this->callback->Call(2, argv, this->async_resource);
+}
+
+void JsonParseWorker::HandleErrorCallback() {
+  Nan::HandleScope scope;
+
+  v8::Local<v8::Value> argv[] = {Nan::SyntaxError(this->ErrorMessage())};
+
+  this->callback->Call(1, argv, this->async_resource);
+}
+
+// creates the value starting at the given tape index, which is moved past it.
+// The depth of the recursion is limited by JsonParser::MAX_DEPTH.
+v8::Local<v8::Value> JsonParseWorker::CreateValue(size_t& index) {
+  Nan::EscapableHandleScope scope;
+
+  const JsonParser::Entry& entry = this->parser.tape[index++];
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Local<v8::Context> context = Nan::GetCurrentContext();
+
+  switch (entry.type) {
+    case JsonParser::TYPE_NULL:
+      return scope.Escape(Nan::Null());
+    case JsonParser::TYPE_FALSE:
+      return scope.Escape(Nan::False());
+    case JsonParser::TYPE_TRUE:
+      return scope.Escape(Nan::True());
+    case JsonParser::TYPE_NUMBER:
+      return scope.Escape(Nan::New<v8::Number>(entry.number));
+    case JsonParser::TYPE_STRING: {
+      const char* text = this->parser.GetString(entry);
+      int textLength = static_cast<int>(entry.size);
+      v8::MaybeLocal<v8::String> string =
+          entry.isAscii
+              ? v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(text),
+                                           v8::NewStringType::kNormal, textLength)
+              : v8::String::NewFromUtf8(isolate, text, v8::NewStringType::kNormal, textLength);
+
+      // bigger than v8::String::kMaxLength
+      if (string.IsEmpty()) {
+        this->isStringTooLong = true;
+        return scope.Escape(Nan::Undefined());
+      }
+
+      return scope.Escape(string.ToLocalChecked());
+    }
+    case JsonParser::TYPE_ARRAY: {
+      v8::Local<v8::Array> array = Nan::New<v8::Array>(static_cast<int>(entry.size));
+
+      for (uint32_t i = 0; i < entry.size && !this->isStringTooLong; i++) {
+        array->CreateDataProperty(context, i, this->CreateValue(index)).FromJust();
+      }
+
+      return scope.Escape(array);
+    }
+    case JsonParser::TYPE_OBJECT: {
+      v8::Local<v8::Object> object = Nan::New<v8::Object>();
+
+      for (uint32_t i = 0; i < entry.size && !this->isStringTooLong; i++) {
+        const JsonParser::Entry& keyEntry = this->parser.tape[index++];
+        const char* key = this->parser.GetString(keyEntry);
+
+        // keys repeat a lot, internalized strings are deduplicated by V8
+        v8::MaybeLocal<v8::String> keyString = v8::String::NewFromUtf8(
+            isolate, key, v8::NewStringType::kInternalized, static_cast<int>(keyEntry.size));
+
+        if (keyString.IsEmpty()) {
+          this->isStringTooLong = true;
+          return scope.Escape(Nan::Undefined());
+        }
+
+        // like JSON.parse, this does not call setters, like the __proto__ one
+        object->CreateDataProperty(context, keyString.ToLocalChecked(), this->CreateValue(index))
+            .FromJust();
+      }
+
+      return scope.Escape(object);
+    }
+  }
+
+  return scope.Escape(Nan::Undefined());
+}
+
+}  // namespace NodeLibcurl
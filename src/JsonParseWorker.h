@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_JSONPARSEWORKER_H
+#define NODELIBCURL_JSONPARSEWORKER_H
+
+#include "JsonParser.h"
+
+#include <nan.h>
+
+#include <cstddef>
+
+namespace NodeLibcurl {
+
+// Parses a body as JSON on the libuv threadpool, only the js values are created on the main thread.
+// The callback is called with a SyntaxError, or with null and the parsed value.
+class JsonParseWorker : public Nan::AsyncWorker {
+  JsonParseWorker(const JsonParseWorker& that);
+  JsonParseWorker& operator=(const JsonParseWorker& that);
+
+  v8::Local<v8::Value> CreateValue(size_t& index);
+
+  char* data;
+  size_t length;
+  JsonParser parser;
+  bool isStringTooLong = false;
+
+ public:
+  // takes ownership of data, which must have been allocated with malloc
+  JsonParseWorker(Nan::Callback* callback, char* data, size_t length);
+
+  ~JsonParseWorker();
+
+  void Execute();
+
+ protected:
+  void HandleOKCallback();
+  void HandleErrorCallback();
+};
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,529 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "JsonParser.h"
+
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace NodeLibcurl {
+
+namespace {
+// powers of ten that are exactly representable as a double
+const double exactPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void AppendUtf8(std::string& out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    out += static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    out += static_cast<char>(0xC0 | (codePoint >> 6));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    out += static_cast<char>(0xE0 | (codePoint >> 12));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (codePoint >> 18));
+    out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+}
+}  // namespace
+
+JsonParser::JsonParser() : input(nullptr), length(0), position(0) {}
+
+void JsonParser::Clear() {
+  this->tape.clear();
+  this->unescaped.clear();
+  this->errorMessage.clear();
+  this->input = nullptr;
+  this->length = 0;
+  this->position = 0;
+}
+
+const char* JsonParser::GetString(const Entry& entry) const {
+  return (entry.isEscaped ? this->unescaped.data() : this->input) + entry.offset;
+}
+
+bool JsonParser::Parse(const char* input, size_t length) {
+  this->Clear();
+
+  this->input = input;
+  this->length = length;
+
+  // index in the tape of the arrays and objects that were not closed yet
+  std::vector<size_t> containers;
+
+  this->SkipWhitespace();
+
+  for (;;) {
+    // a value is expected here
+    if (this->position >= this->length) {
+      return this->Fail();
+    }
+
+    char c = this->input[this->position];
+    bool isValueComplete = true;
+
+    if (c == '{' || c == '[') {
+      if (containers.size() >= JsonParser::MAX_DEPTH) {
+        this->errorMessage = "Maximum nesting depth exceeded in JSON";
+        return false;
+      }
+
+      Entry entry;
+      entry.type = c == '{' ? TYPE_OBJECT : TYPE_ARRAY;
+      entry.isAscii = false;
+      entry.isEscaped = false;
+      entry.size = 0;
+      entry.offset = 0;
+
+      containers.push_back(this->tape.size());
+      this->tape.push_back(entry);
+
+      this->position++;
+      this->SkipWhitespace();
+
+      if (this->position < this->length &&
+          this->input[this->position] == (c == '{' ? '}' : ']')) {
+        // empty, it is closed right away
+        this->position++;
+        containers.pop_back();
+      } else if (c == '{') {
+        // the first key
+        if (this->position >= this->length || this->input[this->position] != '"' ||
+            !this->ParseString()) {
+          return this->Fail();
+        }
+
+        this->SkipWhitespace();
+
+        if (this->position >= this->length || this->input[this->position] != ':') {
+          return this->Fail();
+        }
+
+        this->position++;
+        this->SkipWhitespace();
+        isValueComplete = false;
+      } else {
+        isValueComplete = false;
+      }
+    } else if (c == '"') {
+      if (!this->ParseString()) return false;
+    } else if (c == 't') {
+      if (!this->ParseLiteral("true", 4, TYPE_TRUE)) return false;
+    } else if (c == 'f') {
+      if (!this->ParseLiteral("false", 5, TYPE_FALSE)) return false;
+    } else if (c == 'n') {
+      if (!this->ParseLiteral("null", 4, TYPE_NULL)) return false;
+    } else if (c == '-' || IsDigit(c)) {
+      if (!this->ParseNumber()) return false;
+    } else {
+      return this->Fail();
+    }
+
+    if (!isValueComplete) {
+      continue;
+    }
+
+    // a value was completed, see what comes after it
+    for (;;) {
+      this->SkipWhitespace();
+
+      if (containers.empty()) {
+        // only whitespace is allowed after the root value
+        if (this->position != this->length) {
+          return this->Fail();
+        }
+
+        return true;
+      }
+
+      Entry& parent = this->tape[containers.back()];
+      parent.size++;
+
+      if (this->position >= this->length) {
+        return this->Fail();
+      }
+
+      c = this->input[this->position];
+
+      if (c == ',') {
+        this->position++;
+        this->SkipWhitespace();
+
+        if (parent.type == TYPE_OBJECT) {
+          if (this->position >= this->length || this->input[this->position] != '"' ||
+              !this->ParseString()) {
+            return this->Fail();
+          }
+
+          this->SkipWhitespace();
+
+          if (this->position >= this->length || this->input[this->position] != ':') {
+            return this->Fail();
+          }
+
+          this->position++;
+          this->SkipWhitespace();
+        }
+
+        break;
+      }
+
+      if (c != (parent.type == TYPE_OBJECT ? '}' : ']')) {
+        return this->Fail();
+      }
+
+      // the container itself is the value that was completed now
+      this->position++;
+      containers.pop_back();
+    }
+  }
+}
+
+void JsonParser::SkipWhitespace() {
+  while (this->position < this->length) {
+    char c = this->input[this->position];
+
+    if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+      return;
+    }
+
+    this->position++;
+  }
+}
+
+bool JsonParser::ParseLiteral(const char* literal, size_t literalLength, Type type) {
+  if (this->length - this->position < literalLength ||
+      std::memcmp(this->input + this->position, literal, literalLength) != 0) {
+    return this->Fail();
+  }
+
+  this->position += literalLength;
+
+  Entry entry;
+  entry.type = type;
+  entry.isAscii = false;
+  entry.isEscaped = false;
+  entry.size = 0;
+  entry.offset = 0;
+
+  this->tape.push_back(entry);
+
+  return true;
+}
+
+bool JsonParser::ParseString() {
+  // skip the opening quote
+  size_t start = ++this->position;
+  bool isAscii = true;
+  bool isEscaped = false;
+  size_t unescapedStart = this->unescaped.size();
+
+  for (;;) {
+    // fast path, copy nothing until something different is found
+    size_t runStart = this->position;
+    while (this->position < this->length) {
+      unsigned char c = static_cast<unsigned char>(this->input[this->position]);
+
+      if (c == '"' || c == '\\' || c < 0x20) {
+        break;
+      }
+
+      if (c >= 0x80) {
+        isAscii = false;
+      }
+
+      this->position++;
+    }
+
+    if (this->position >= this->length) {
+      return this->Fail();
+    }
+
+    char c = this->input[this->position];
+
+    if (isEscaped) {
+      this->unescaped.append(this->input + runStart, this->position - runStart);
+    }
+
+    if (c == '"') {
+      break;
+    }
+
+    // control characters must be escaped
+    if (c != '\\') {
+      return this->Fail();
+    }
+
+    if (!isEscaped) {
+      isEscaped = true;
+      this->unescaped.append(this->input + start, this->position - start);
+    }
+
+    this->position++;
+
+    if (this->position >= this->length) {
+      return this->Fail();
+    }
+
+    c = this->input[this->position++];
+
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        this->unescaped += c;
+        break;
+      case 'b':
+        this->unescaped += '\b';
+        break;
+      case 'f':
+        this->unescaped += '\f';
+        break;
+      case 'n':
+        this->unescaped += '\n';
+        break;
+      case 'r':
+        this->unescaped += '\r';
+        break;
+      case 't':
+        this->unescaped += '\t';
+        break;
+      case 'u': {
+        uint32_t codeUnits[2] = {0, 0};
+        size_t codeUnitsCount = 0;
+
+        // a surrogate pair is made of two consecutive escape sequences
+        for (; codeUnitsCount < 2; codeUnitsCount++) {
+          if (codeUnitsCount == 1 &&
+              (codeUnits[0] < 0xD800 || codeUnits[0] > 0xDBFF ||
+               this->length - this->position < 6 || this->input[this->position] != '\\' ||
+               this->input[this->position + 1] != 'u')) {
+            break;
+          }
+
+          size_t hexStart = this->position + (codeUnitsCount == 1 ? 2 : 0);
+
+          if (this->length - hexStart < 4) {
+            this->position = this->length;
+            return this->Fail();
+          }
+
+          uint32_t codeUnit = 0;
+          for (size_t i = 0; i < 4; i++) {
+            int value = HexValue(this->input[hexStart + i]);
+
+            if (value < 0) {
+              this->position = hexStart + i;
+              return this->Fail();
+            }
+
+            codeUnit = (codeUnit << 4) | static_cast<uint32_t>(value);
+          }
+
+          if (codeUnitsCount == 1 && (codeUnit < 0xDC00 || codeUnit > 0xDFFF)) {
+            break;
+          }
+
+          codeUnits[codeUnitsCount] = codeUnit;
+          this->position = hexStart + 4;
+        }
+
+        if (codeUnitsCount == 2) {
+          AppendUtf8(this->unescaped,
+                     0x10000 + ((codeUnits[0] - 0xD800) << 10) + (codeUnits[1] - 0xDC00));
+        } else {
+          // lone surrogates are kept as they are, which V8 replaces with U+FFFD later on
+          AppendUtf8(this->unescaped, codeUnits[0]);
+        }
+
+        if (codeUnits[0] >= 0x80) {
+          isAscii = false;
+        }
+        break;
+      }
+      default:
+        this->position--;
+        return this->Fail();
+    }
+  }
+
+  Entry entry;
+  entry.type = TYPE_STRING;
+  entry.isAscii = isAscii;
+  entry.isEscaped = isEscaped;
+
+  if (isEscaped) {
+    entry.offset = unescapedStart;
+    entry.size = static_cast<uint32_t>(this->unescaped.size() - unescapedStart);
+  } else {
+    entry.offset = start;
+    entry.size = static_cast<uint32_t>(this->position - start);
+  }
+
+  // skip the closing quote
+  this->position++;
+
+  this->tape.push_back(entry);
+
+  return true;
+}
+
+bool JsonParser::ParseNumber() {
+  size_t start = this->position;
+  bool isNegative = false;
+
+  if (this->input[this->position] == '-') {
+    isNegative = true;
+    this->position++;
+  }
+
+  uint64_t mantissa = 0;
+  int significantDigits = 0;
+  int exponent = 0;
+
+  // leading zeros are not allowed, except for the zero itself
+  if (this->position < this->length && this->input[this->position] == '0') {
+    this->position++;
+  } else if (this->position < this->length && IsDigit(this->input[this->position])) {
+    while (this->position < this->length && IsDigit(this->input[this->position])) {
+      if (significantDigits < 19) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(this->input[this->position] - '0');
+        significantDigits++;
+      } else {
+        exponent++;
+        significantDigits++;
+      }
+      this->position++;
+    }
+  } else {
+    return this->Fail();
+  }
+
+  if (this->position < this->length && this->input[this->position] == '.') {
+    this->position++;
+
+    if (this->position >= this->length || !IsDigit(this->input[this->position])) {
+      return this->Fail();
+    }
+
+    while (this->position < this->length && IsDigit(this->input[this->position])) {
+      char digit = this->input[this->position];
+
+      if (mantissa == 0 && digit == '0') {
+        exponent--;
+      } else if (significantDigits < 19) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(digit - '0');
+        significantDigits++;
+        exponent--;
+      } else {
+        significantDigits++;
+      }
+      this->position++;
+    }
+  }
+
+  if (this->position < this->length &&
+      (this->input[this->position] == 'e' || this->input[this->position] == 'E')) {
+    this->position++;
+
+    bool isExponentNegative = false;
+
+    if (this->position < this->length &&
+        (this->input[this->position] == '+' || this->input[this->position] == '-')) {
+      isExponentNegative = this->input[this->position] == '-';
+      this->position++;
+    }
+
+    if (this->position >= this->length || !IsDigit(this->input[this->position])) {
+      return this->Fail();
+    }
+
+    int explicitExponent = 0;
+    while (this->position < this->length && IsDigit(this->input[this->position])) {
+      if (explicitExponent < 100000) {
+        explicitExponent = explicitExponent * 10 + (this->input[this->position] - '0');
+      }
+      this->position++;
+    }
+
+    exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+  }
+
+  double value;
+
+  // both the mantissa and the power of ten are exact, so a single operation is correctly rounded
+  if (significantDigits <= 15 && exponent >= -22 && exponent <= 22) {
+    value = static_cast<double>(mantissa);
+
+    if (exponent < 0) {
+      value /= exactPowersOfTen[-exponent];
+    } else {
+      value *= exactPowersOfTen[exponent];
+    }
+
+    if (isNegative) {
+      value = -value;
+    }
+  } else {
+    // strtod depends on the current locale, which can be changed on the main thread
+    std::istringstream stream(std::string(this->input + start, this->position - start));
+    stream.imbue(std::locale::classic());
+    stream >> value;
+
+    // out of range
+    if (stream.fail()) {
+      value = exponent > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+
+      if (isNegative) {
+        value = -value;
+      }
+    }
+  }
+
+  Entry entry;
+  entry.type = TYPE_NUMBER;
+  entry.isAscii = false;
+  entry.isEscaped = false;
+  entry.size = 0;
+  entry.number = value;
+
+  this->tape.push_back(entry);
+
+  return true;
+}
+
+// same messages used by JSON.parse
+bool JsonParser::Fail() {
+  if (this->position >= this->length) {
+    this->errorMessage = "Unexpected end of JSON input";
+  } else {
+    std::ostringstream message;
+    message << "Unexpected token " << this->input[this->position] << " in JSON at position "
+            << this->position;
+    this->errorMessage = message.str();
+  }
+
+  return false;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_JSONPARSER_H
+#define NODELIBCURL_JSONPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Validating JSON parser that does not depend on V8, so it can run outside the main thread.
+// It follows the same grammar than JSON.parse, and produces a flat tape, with the values in
+// the same order they appear in the input, which can be turned into js values later on.
+// Strings without escape sequences are not copied, they point to the input, which must be
+// kept alive while the tape is being used.
+class JsonParser {
+  JsonParser(const JsonParser& that);
+  JsonParser& operator=(const JsonParser& that);
+
+ public:
+  enum Type : uint8_t {
+    TYPE_NULL = 0,
+    TYPE_FALSE,
+    TYPE_TRUE,
+    TYPE_NUMBER,
+    TYPE_STRING,
+    TYPE_ARRAY,   // followed by size values
+    TYPE_OBJECT,  // followed by size pairs of a string key and a value
+  };
+
+  struct Entry {
+    Type type;
+    bool isAscii;    // strings only
+    bool isEscaped;  // strings only, if true offset is into unescaped, otherwise into input
+    uint32_t size;   // length of strings, number of items of arrays and objects
+    union {
+      double number;
+      size_t offset;
+    };
+  };
+
+  static const size_t MAX_DEPTH = 1000;
+
+  std::vector<Entry> tape;
+  std::string unescaped;  // strings that had escape sequences
+
+  // set when Parse fails
+  std::string errorMessage;
+
+  JsonParser();
+
+  bool Parse(const char* input, size_t length);
+  void Clear();
+
+  const char* GetString(const Entry& entry) const;
+
+ private:
+  const char* input;
+  size_t length;
+  size_t position;
+
+  void SkipWhitespace();
+  bool ParseString();
+  bool ParseNumber();
+  bool ParseLiteral(const char* literal, size_t literalLength, Type type);
+  bool Fail();
+};
+}  // namespace NodeLibcurl
+#endif
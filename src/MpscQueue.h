@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_MPSCQUEUE_H
+#define NODELIBCURL_MPSCQUEUE_H
+
+#include <atomic>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Lock free queue with any number of producers and a single consumer.
+// Items are pushed to the front of a linked list, and the consumer takes the whole list at once,
+// so neither side ever waits for the other.
+template <typename T>
+class MpscQueue {
+  struct Node {
+    T value;
+    Node* next;
+  };
+
+  MpscQueue(const MpscQueue& that);
+  MpscQueue& operator=(const MpscQueue& that);
+
+  std::atomic<Node*> head;
+
+ public:
+  MpscQueue() : head(nullptr) {}
+
+  ~MpscQueue() {
+    Node* node = this->head.exchange(nullptr);
+
+    while (node) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  // can be called from any thread
+  void Push(const T& value) {
+    Node* node = new Node{value, this->head.load(std::memory_order_relaxed)};
+
+    while (!this->head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+    }
+  }
+
+  // must only be called by the consumer, appends the items to the given vector, in the
+  // order they were pushed.
+  void PopAll(std::vector<T>& items) {
+    Node* node = this->head.exchange(nullptr, std::memory_order_acquire);
+
+    // the list is in the reverse order
+    Node* reversed = nullptr;
+
+    while (node) {
+      Node* next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+
+    while (reversed) {
+      Node* next = reversed->next;
+      items.push_back(reversed->value);
+      delete reversed;
+      reversed = next;
+    }
+  }
+};
+}  // namespace NodeLibcurl
+#endif
@@ -7,23 +7,26 @@
 #include "Multi.h"
 
 #include "Easy.h"
+#include "IsolateData.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 // 85233 was allocated on Win64
 #define MEMORY_PER_HANDLE 60000
 
-namespace NodeLibcurl {
+#define SOCKET_CONTEXTS_PER_SLAB 16
 
-Nan::Persistent<v8::FunctionTemplate> Multi::constructor;
+namespace NodeLibcurl {
 
-Multi::Multi() {
+Multi::Multi() : socketContextPool(new CurlSocketContextPool()) {
   // init uv timer to be used with HandleTimeout
   this->timeout = deleted_unique_ptr<uv_timer_t>(new uv_timer_t, [&](uv_timer_t* timerhandl) {
     uv_close(reinterpret_cast<uv_handle_t*>(timerhandl), Multi::OnTimerClose);
   });
 
-  int timerStatus = uv_timer_init(uv_default_loop(), this->timeout.get());
+  int timerStatus = uv_timer_init(IsolateData::Current()->loop, this->timeout.get());
   assert(timerStatus == 0 && "Could not initialize libuv timer");
 
   this->timeout->data = this;
@@ -44,6 +47,13 @@ Multi::~Multi() {
   if (this->isOpen) {
     this->Dispose();
   }
+
+  // sockets removed by curl_multi_cleanup may still be closing
+  this->socketContextPool->isOrphan = true;
+
+  if (this->socketContextPool->inUse == 0) {
+    delete this->socketContextPool;
+  }
 }
 
 void Multi::Dispose() {
@@ -59,6 +69,33 @@ void Multi::Dispose() {
   }
 
   uv_timer_stop(this->timeout.get());
+
+  this->pendingDataHandles.clear();
+
+  // curl_multi_cleanup already removed them, and writes to the WRITEDATA file that are still
+  // running must not call back into this instance when they finish.
+  for (Easy* easy : this->handles) {
+    easy->OnRemovedFromMulti();
+    easy->isPendingDataQueued = false;
+  }
+
+  this->handles.clear();
+}
+
+void Multi::QueuePendingData(Easy* easy) { this->pendingDataHandles.push_back(easy); }
+
+void Multi::FlushPendingData() {
+  // the js callbacks can queue handles again (by unpausing them, for example), or remove them,
+  // so the list is read by index and removed handles are left as null.
+  for (size_t i = 0; i < this->pendingDataHandles.size(); i++) {
+    Easy* easy = this->pendingDataHandles[i];
+
+    if (easy) {
+      easy->FlushPendingData();
+    }
+  }
+
+  this->pendingDataHandles.clear();
 }
 
 // The curl_multi_socket_action(3) function informs the application about
@@ -94,8 +131,21 @@ int Multi::HandleSocket(CURL* easy, curl_socket_t s, int action, void* userp, vo
         break;
     }
 
+    // libcurl calls this again for sockets it's already waiting on, restarting the poll handle
+    // with the same events would only change its callback to the one it already has.
+    if (events == ctx->events) {
+      ++obj->pollStartsSkipped;
+      return 0;
+    }
+
+    ++obj->pollStarts;
+
     // start polling the socket.
-    return uv_poll_start(&ctx->pollHandle, events, Multi::OnSocket);
+    int ret = uv_poll_start(&ctx->pollHandle, events, Multi::OnSocket);
+
+    ctx->events = ret == 0 ? events : -1;
+
+    return ret;
   }
 
   if (action == CURL_POLL_REMOVE && socketp) {
@@ -149,6 +199,11 @@ void Multi::OnSocket(uv_poll_t* handle, int status, int events) {
 
   Multi::CurlSocketContext* ctx = static_cast<Multi::CurlSocketContext*>(handle->data);
 
+  // libuv stops the poll handle when there is an error
+  if (status < 0) {
+    ctx->events = -1;
+  }
+
   // Check comment on node_libcurl.cc
   SETLOCALE_WRAPPER(
       // Before version 7.20.0: If you receive CURLM_CALL_MULTI_PERFORM, this
@@ -163,6 +218,8 @@ void Multi::OnSocket(uv_poll_t* handle, int status, int events) {
                                         &ctx->multi->runningHandles);
       } while (code == CURLM_CALL_MULTI_PERFORM););  // NOLINT(whitespace/newline)
 
+  ctx->multi->FlushPendingData();
+
   if (code != CURLM_OK) {
     std::string errorMsg;
 
@@ -185,6 +242,8 @@ UV_TIMER_CB(Multi::OnTimeout) {
                         obj->mh, CURL_SOCKET_TIMEOUT, 0,
                         &obj->runningHandles););  // NOLINT(whitespace/newline)
 
+  obj->FlushPendingData();
+
   if (code != CURLM_OK) {
     std::string errorMsg;
 
@@ -204,6 +263,27 @@ void Multi::ProcessMessages() {
   CURLMsg* msg = NULL;
   int pending = 0;
 
+  if (this->cbOnMessages) {
+    // the messages are invalidated when their handles are removed, so all of them are read first
+    std::vector<Completion> completions;
+
+    while ((msg = curl_multi_info_read(this->mh, &pending))) {
+      if (msg->msg == CURLMSG_DONE) {
+        Easy* easy = Multi::GetEasy(msg->easy_handle);
+
+        if (easy) {
+          completions.push_back({easy, msg->data.result});
+        }
+      }
+    }
+
+    if (!completions.empty()) {
+      this->CallOnMessagesCallback(completions);
+    }
+
+    return;
+  }
+
   while ((msg = curl_multi_info_read(this->mh, &pending))) {
     if (msg->msg == CURLMSG_DONE) {
       CURLcode statusCode = msg->data.result;
@@ -213,22 +293,58 @@ void Multi::ProcessMessages() {
   }
 }
 
+CURLMcode Multi::RemoveEasy(Easy* easy) {
+  CURLMcode code = curl_multi_remove_handle(this->mh, easy->ch);
+
+  if (code != CURLM_OK) {
+    return code;
+  }
+
+  --this->amountOfHandles;
+  easy->OnRemovedFromMulti();
+  this->handles.erase(easy);
+
+  // data not flushed yet is discarded
+  if (easy->isPendingDataQueued) {
+    easy->isPendingDataQueued = false;
+    std::replace(this->pendingDataHandles.begin(), this->pendingDataHandles.end(), easy,
+                 static_cast<Easy*>(nullptr));
+  }
+
+  return code;
+}
+
 // Creates a Context to be used to store data between events
 Multi::CurlSocketContext* Multi::CreateCurlSocketContext(curl_socket_t sockfd, Multi* multi) {
   int r;
-  Multi::CurlSocketContext* ctx = NULL;
+  Multi::CurlSocketContextPool* pool = multi->socketContextPool;
 
-  ctx = static_cast<Multi::CurlSocketContext*>(malloc(sizeof(*ctx)));
-  assert(ctx && "Not enough memory to allocate a new Multi::CurlSocketContext.");
+  if (!pool->freeList) {
+    Multi::CurlSocketContext* slab = new Multi::CurlSocketContext[SOCKET_CONTEXTS_PER_SLAB];
+    pool->slabs.emplace_back(slab);
+
+    for (int i = SOCKET_CONTEXTS_PER_SLAB - 1; i >= 0; i--) {
+      slab[i].pool = pool;
+      slab[i].nextFree = pool->freeList;
+      pool->freeList = &slab[i];
+    }
+  }
+
+  Multi::CurlSocketContext* ctx = pool->freeList;
+  pool->freeList = ctx->nextFree;
+  ++pool->inUse;
+  ++multi->socketContextsAcquired;
 
   ctx->sockfd = sockfd;
   ctx->multi = multi;
+  ctx->events = -1;
+  ctx->nextFree = nullptr;
 
   // uv_poll simply watches file descriptors using the operating system
   // notification mechanism
   //   whenever the OS notices a change of state in file descriptors being
   //   polled, libuv will invoke the associated callback.
-  r = uv_poll_init_socket(uv_default_loop(), &ctx->pollHandle, sockfd);
+  r = uv_poll_init_socket(IsolateData::Current()->loop, &ctx->pollHandle, sockfd);
 
   assert(r == 0);
 
@@ -244,19 +360,22 @@ void Multi::DestroyCurlSocketContext(Multi::CurlSocketContext* ctx) {
   uv_close(handle, Multi::OnSocketClose);
 }
 
+// returns the context to the pool
 void Multi::OnSocketClose(uv_handle_t* handle) {
   Multi::CurlSocketContext* ctx = static_cast<Multi::CurlSocketContext*>(handle->data);
-  free(ctx);
-}
+  Multi::CurlSocketContextPool* pool = ctx->pool;
 
-void Multi::CallOnMessageCallback(CURL* easy, CURLcode statusCode) {
-  Nan::HandleScope scope;
+  ctx->multi = nullptr;
+  ctx->nextFree = pool->freeList;
+  pool->freeList = ctx;
+  --pool->inUse;
 
-  // we don't have an on message callback, just return.
-  if (this->cbOnMessage == nullptr) {
-    return;
+  if (pool->isOrphan && pool->inUse == 0) {
+    delete pool;
   }
+}
 
+Easy* Multi::GetEasy(CURL* easy) {
   // From https://curl.haxx.se/libcurl/c/CURLINFO_PRIVATE.html
   // > Please note that for internal reasons, the value is returned as a char
   // pointer, although effectively being a 'void *'.
@@ -264,13 +383,50 @@ void Multi::CallOnMessageCallback(CURL* easy, CURLcode statusCode) {
   CURLcode code = curl_easy_getinfo(easy, CURLINFO_PRIVATE, &ptr);
   assert(ptr != nullptr && "Invalid handle returned from CURLINFO_PRIVATE.");
 
-  Easy* obj = reinterpret_cast<Easy*>(ptr);
-
   if (code != CURLE_OK) {
     Nan::ThrowError("Error retrieving current handle instance.");
+    return nullptr;
+  }
+
+  return reinterpret_cast<Easy*>(ptr);
+}
+
+void Multi::CallOnMessageCallback(CURL* easy, CURLcode statusCode) {
+  Nan::HandleScope scope;
+
+  // completions deferred by the WRITEDATA file are delivered alone
+  if (this->cbOnMessages) {
+    Easy* obj = Multi::GetEasy(easy);
+
+    if (obj) {
+      this->CallOnMessagesCallback({{obj, statusCode}});
+    }
+
+    return;
+  }
+
+  Easy* obj = Multi::GetEasy(easy);
+
+  if (!obj) {
+    return;
+  }
+
+  // the data is still being written to the WRITEDATA file, this is going to be called again
+  // after it finishes.
+  if (obj->DeferCompletion(statusCode)) {
+    return;
+  }
+
+  // even if nobody is going to be told, the write ring consumer must know it finished
+  obj->EndTransfer();
+
+  // we don't have an on message callback, just return.
+  if (this->cbOnMessage == nullptr) {
     return;
   }
 
+  statusCode = obj->GetTransferResult(statusCode);
+
   v8::Local<v8::Object> easyArg = obj->handle();
 
   v8::Local<v8::Value> err = Nan::Null();
@@ -288,6 +444,84 @@ void Multi::CallOnMessageCallback(CURL* easy, CURLcode statusCode) {
   Nan::Call(*(this->cbOnMessage), obj->handle(), argc, argv);
 }
 
+void Multi::CallOnMessagesCallback(const std::vector<Completion>& completions) {
+  Nan::HandleScope scope;
+
+  v8::Local<v8::Array> handles = Nan::New<v8::Array>();
+  v8::Local<v8::Array> errors;
+  std::vector<int32_t> codes;
+
+  codes.reserve(completions.size());
+
+  for (const Completion& completion : completions) {
+    Easy* obj = completion.easy;
+
+    // the data is still being written to the WRITEDATA file, this is going to be called again
+    // after it finishes.
+    if (obj->DeferCompletion(completion.code)) {
+      continue;
+    }
+
+    obj->EndTransfer();
+
+    CURLcode statusCode = obj->GetTransferResult(completion.code);
+
+    // if it could not be removed, it's reported anyway, removeHandle can still be called
+    this->RemoveEasy(obj);
+
+    uint32_t index = static_cast<uint32_t>(codes.size());
+
+    // errors are only created when some transfer failed, with null for the others
+    if (statusCode != CURLE_OK && errors.IsEmpty()) {
+      errors = Nan::New<v8::Array>();
+
+      for (uint32_t i = 0; i < index; i++) {
+        Nan::Set(errors, i, Nan::Null());
+      }
+    }
+
+    if (!errors.IsEmpty()) {
+      v8::Local<v8::Value> err = Nan::Null();
+
+      if (statusCode != CURLE_OK) {
+        bool hasError = !obj->callbackError.IsEmpty();
+
+        err = hasError ? Nan::New(obj->callbackError) : Nan::Error(curl_easy_strerror(statusCode));
+      }
+
+      Nan::Set(errors, index, err);
+    }
+
+    Nan::Set(handles, index, obj->handle());
+    codes.push_back(static_cast<int32_t>(statusCode));
+  }
+
+  if (codes.empty() || this->cbOnMessages == nullptr) {
+    return;
+  }
+
+  v8::Local<v8::ArrayBuffer> buffer =
+      v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), codes.size() * sizeof(int32_t));
+  v8::Local<v8::Int32Array> errorCodes = v8::Int32Array::New(buffer, 0, codes.size());
+
+  Nan::TypedArrayContents<int32_t> errorCodesContents(errorCodes);
+  std::memcpy(*errorCodesContents, codes.data(), codes.size() * sizeof(int32_t));
+
+  v8::Local<v8::Value> errorsArg = Nan::Null();
+
+  if (!errors.IsEmpty()) {
+    errorsArg = errors;
+  }
+
+  v8::Local<v8::Value> argv[] = {handles, errorCodes, errorsArg};
+  const int argc = 3;
+
+  // keeps the callback alive if it's replaced while being called
+  std::shared_ptr<Nan::Callback> cb = this->cbOnMessages;
+
+  Nan::Call(*cb, this->handle(), argc, argv);
+}
+
 // Add Curl constructor to the module exports
 NAN_MODULE_INIT(Multi::Initialize) {
   Nan::HandleScope scope;
@@ -301,14 +535,16 @@ NAN_MODULE_INIT(Multi::Initialize) {
   Nan::SetPrototypeMethod(tmpl, "setOpt", Multi::SetOpt);
   Nan::SetPrototypeMethod(tmpl, "addHandle", Multi::AddHandle);
   Nan::SetPrototypeMethod(tmpl, "onMessage", Multi::OnMessage);
+  Nan::SetPrototypeMethod(tmpl, "onMessages", Multi::OnMessages);
   Nan::SetPrototypeMethod(tmpl, "removeHandle", Multi::RemoveHandle);
   Nan::SetPrototypeMethod(tmpl, "getCount", Multi::GetCount);
+  Nan::SetPrototypeMethod(tmpl, "getSocketStats", Multi::GetSocketStats);
   Nan::SetPrototypeMethod(tmpl, "close", Multi::Close);
 
   // static methods
   Nan::SetMethod(tmpl, "strError", Multi::StrError);
 
-  Multi::constructor.Reset(tmpl);
+  IsolateData::Current()->multiConstructor.Reset(tmpl);
 
   Nan::Set(target, Nan::New("Multi").ToLocalChecked(), Nan::GetFunction(tmpl).ToLocalChecked());
 }
@@ -340,15 +576,16 @@ NAN_METHOD(Multi::SetOpt) {
 
   CURLMcode setOptRetCode = CURLM_UNKNOWN_OPTION;
 
-  int optionId;
+  int32_t optionId = 0;
+  int optionTable = curlMultiOptionIndex.Find(opt, optionId);
 
   // array of strings option
-  if ((optionId = IsInsideCurlConstantStruct(curlMultiOptionNotImplemented, opt))) {
+  if (optionTable == CURL_MULTI_OPTION_NOT_IMPLEMENTED) {
     Nan::ThrowError(
         "Unsupported option, probably because it's too complex to implement "
         "using javascript or unecessary when using javascript.");
     return;
-  } else if ((optionId = IsInsideCurlConstantStruct(curlMultiOptionStringArray, opt))) {
+  } else if (optionTable == CURL_MULTI_OPTION_STRING_ARRAY) {
     if (value->IsNull()) {
       setOptRetCode = curl_multi_setopt(obj->mh, static_cast<CURLMoption>(optionId), NULL);
 
@@ -372,7 +609,7 @@ NAN_METHOD(Multi::SetOpt) {
     }
 
     // check if option is integer, and the value is correct
-  } else if ((optionId = IsInsideCurlConstantStruct(curlMultiOptionInteger, opt))) {
+  } else if (optionTable == CURL_MULTI_OPTION_INTEGER) {
     // If not an integer, throw error
     if (!value->IsInt32()) {
       Nan::ThrowTypeError("Option value must be an integer.");
@@ -419,6 +656,38 @@ NAN_METHOD(Multi::OnMessage) {
   info.GetReturnValue().Set(info.This());
 }
 
+NAN_METHOD(Multi::OnMessages) {
+  Nan::HandleScope scope;
+
+  Multi* obj = Nan::ObjectWrap::Unwrap<Multi>(info.This());
+
+  if (!info.Length()) {
+    Nan::ThrowError(
+        "You must specify the callback function. If you want to remove the "
+        "current one you can pass null.");
+    return;
+  }
+
+  v8::Local<v8::Value> arg = info[0];
+
+  bool isNull = arg->IsNull();
+
+  if (!arg->IsFunction() && !isNull) {
+    Nan::ThrowTypeError(
+        "Argument must be a Function. If you want to remove the current one "
+        "you can pass null.");
+    return;
+  }
+
+  if (isNull) {
+    obj->cbOnMessages = nullptr;
+  } else {
+    obj->cbOnMessages.reset(new Nan::Callback(arg.As<v8::Function>()));
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
 NAN_METHOD(Multi::AddHandle) {
   Nan::HandleScope scope;
 
@@ -431,7 +700,8 @@ NAN_METHOD(Multi::AddHandle) {
 
   v8::Local<v8::Value> handle = info[0];
 
-  if (!handle->IsObject() || !Nan::New(Easy::constructor)->HasInstance(handle)) {
+  if (!handle->IsObject() ||
+      !Nan::New(IsolateData::Current()->easyConstructor)->HasInstance(handle)) {
     Nan::ThrowError(Nan::TypeError("Argument must be an instance of an Easy handle."));
     return;
   } else {
@@ -441,6 +711,8 @@ NAN_METHOD(Multi::AddHandle) {
       Nan::ThrowError("Cannot add an Easy handle that is closed.");
       return;
     }
+    easy->PrepareTransfer();
+
     // Check comment on node_libcurl.cc
     SETLOCALE_WRAPPER(CURLMcode code =
                           curl_multi_add_handle(obj->mh, easy->ch););  // NOLINT(whitespace/newline)
@@ -452,6 +724,8 @@ NAN_METHOD(Multi::AddHandle) {
 
     ++obj->amountOfHandles;
     easy->isInsideMultiHandle = true;
+    easy->multi = obj;
+    obj->handles.insert(easy);
 
     v8::Local<v8::Int32> ret = Nan::New(static_cast<int32_t>(code));
 
@@ -471,22 +745,20 @@ NAN_METHOD(Multi::RemoveHandle) {
 
   v8::Local<v8::Value> handle = info[0];
 
-  if (!handle->IsObject() || !Nan::New(Easy::constructor)->HasInstance(handle)) {
+  if (!handle->IsObject() ||
+      !Nan::New(IsolateData::Current()->easyConstructor)->HasInstance(handle)) {
     Nan::ThrowError(Nan::TypeError("Argument must be an instance of an Easy handle."));
     return;
   } else {
     Easy* easy = Nan::ObjectWrap::Unwrap<Easy>(handle.As<v8::Object>());
 
-    CURLMcode code = curl_multi_remove_handle(obj->mh, easy->ch);
+    CURLMcode code = obj->RemoveEasy(easy);
 
     if (code != CURLM_OK) {
       Nan::ThrowError(Nan::TypeError("Could not remove easy handle from multi handle."));
       return;
     }
 
-    --obj->amountOfHandles;
-    easy->isInsideMultiHandle = false;
-
     v8::Local<v8::Int32> ret = Nan::New(static_cast<int32_t>(code));
 
     info.GetReturnValue().Set(ret);
@@ -503,6 +775,27 @@ NAN_METHOD(Multi::GetCount) {
   info.GetReturnValue().Set(ret);
 }
 
+NAN_METHOD(Multi::GetSocketStats) {
+  Nan::HandleScope scope;
+
+  Multi* obj = Nan::ObjectWrap::Unwrap<Multi>(info.This());
+  Multi::CurlSocketContextPool* pool = obj->socketContextPool;
+
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+
+  Nan::Set(ret, Nan::New("socketContexts").ToLocalChecked(), Nan::New(pool->inUse));
+  Nan::Set(ret, Nan::New("socketContextsAllocated").ToLocalChecked(),
+           Nan::New(static_cast<uint32_t>(pool->slabs.size() * SOCKET_CONTEXTS_PER_SLAB)));
+  Nan::Set(ret, Nan::New("socketContextsAcquired").ToLocalChecked(),
+           Nan::New(static_cast<double>(obj->socketContextsAcquired)));
+  Nan::Set(ret, Nan::New("pollStarts").ToLocalChecked(),
+           Nan::New(static_cast<double>(obj->pollStarts)));
+  Nan::Set(ret, Nan::New("pollStartsSkipped").ToLocalChecked(),
+           Nan::New(static_cast<double>(obj->pollStartsSkipped)));
+
+  info.GetReturnValue().Set(ret);
+}
+
 NAN_METHOD(Multi::Close) {
   Nan::HandleScope scope;
 
@@ -17,9 +17,13 @@
 
 #include <functional>
 #include <memory>
+#include <set>
+#include <vector>
 
 namespace NodeLibcurl {
 
+class Easy;
+
 class Multi : public Nan::ObjectWrap {
   // instance methods
   Multi();
@@ -28,17 +32,38 @@ class Multi : public Nan::ObjectWrap {
   Multi(const Multi& that);
   Multi& operator=(const Multi& that);
 
+  // a finished transfer, delivered with others to cbOnMessages
+  struct Completion {
+    Easy* easy;
+    CURLcode code;
+  };
+
   void Dispose();
   void ProcessMessages();
-  void CallOnMessageCallback(CURL* easy, CURLcode statusCode);
+  void FlushPendingData();
+  void CallOnMessagesCallback(const std::vector<Completion>& completions);
+
+  struct CurlSocketContextPool;
 
   // context used with curl_multi_assign to create a relationship between the
   // socket being used and the poll handle.
   struct CurlSocketContext {
-    uv_mutex_t mutex;
     uv_poll_t pollHandle;
     curl_socket_t sockfd;
     Multi* multi;
+    CurlSocketContextPool* pool;
+    int events;                   // events the poll handle was started with, -1 if it's stopped
+    CurlSocketContext* nextFree;  // only used while it's inside the pool
+  };
+
+  // contexts are allocated in slabs and reused, since short lived connections can open and close
+  // sockets at a high rate. The pool outlives the Multi if contexts are still being closed by
+  // libuv when it's destroyed, and is deleted when the last one returns.
+  struct CurlSocketContextPool {
+    std::vector<std::unique_ptr<CurlSocketContext[]>> slabs;
+    CurlSocketContext* freeList = nullptr;
+    uint32_t inUse = 0;
+    bool isOrphan = false;
   };
 
   // members
@@ -47,17 +72,35 @@ class Multi : public Nan::ObjectWrap {
   int amountOfHandles = 0;
   int runningHandles = 0;
 
+  CurlSocketContextPool* socketContextPool;
+
+  // exposed by getSocketStats
+  uint64_t socketContextsAcquired = 0;
+  uint64_t pollStarts = 0;
+  uint64_t pollStartsSkipped = 0;
+
   std::shared_ptr<Nan::Callback> cbOnMessage;
+  // when set, finished handles are removed here and delivered in a single call, instead
+  // of a call to cbOnMessage for each one.
+  std::shared_ptr<Nan::Callback> cbOnMessages;
+
+  // handles using WRITE_MODE_COALESCE that received data during the current socket event
+  std::vector<Easy*> pendingDataHandles;
+
+  // handles added and not removed yet, detached from this instance when it's closed
+  std::set<Easy*> handles;
 
   deleted_unique_ptr<uv_timer_t> timeout;
 
   // static helper methods
   static CurlSocketContext* CreateCurlSocketContext(curl_socket_t sockfd, Multi* multi);
   static void DestroyCurlSocketContext(CurlSocketContext* ctx);
+  static Easy* GetEasy(CURL* easy);
 
  public:
-  // js object constructor template
-  static Nan::Persistent<v8::FunctionTemplate> constructor;
+  void QueuePendingData(Easy* easy);
+  void CallOnMessageCallback(CURL* easy, CURLcode statusCode);
+  CURLMcode RemoveEasy(Easy* easy);
 
   // export Multi to js
   static NAN_MODULE_INIT(Initialize);
@@ -67,8 +110,10 @@ class Multi : public Nan::ObjectWrap {
   static NAN_METHOD(SetOpt);
   static NAN_METHOD(AddHandle);
   static NAN_METHOD(OnMessage);
+  static NAN_METHOD(OnMessages);
   static NAN_METHOD(RemoveHandle);
   static NAN_METHOD(GetCount);
+  static NAN_METHOD(GetSocketStats);
   static NAN_METHOD(Close);
   static NAN_METHOD(StrError);
 
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "OptionTemplate.h"
+
+#include "Curl.h"
+#include "IsolateData.h"
+
+namespace NodeLibcurl {
+
+OptionTemplate::Options::~Options() {
+  for (size_t i = 0; i < this->entries.size(); i++) {
+    if (this->entries[i].kind == Entry::KIND_LIST) {
+      curl_slist_free_all(this->entries[i].list);
+    }
+  }
+}
+
+OptionTemplate::OptionTemplate() {}
+
+CURLcode OptionTemplate::Apply(CURL* ch, size_t& appliedCount) const {
+  appliedCount = 0;
+
+  for (const Entry& entry : this->options->entries) {
+    CURLcode code = CURLE_OK;
+
+    switch (entry.kind) {
+      case Entry::KIND_NULL:
+        code = curl_easy_setopt(ch, entry.id, NULL);
+        break;
+      case Entry::KIND_STRING:
+        code = curl_easy_setopt(ch, entry.id, entry.string.c_str());
+        break;
+      case Entry::KIND_LONG:
+        code = curl_easy_setopt(ch, entry.id, static_cast<long>(entry.number));  // NOLINT
+        break;
+      case Entry::KIND_OFF_T:
+        code = curl_easy_setopt(ch, entry.id, entry.number);
+        break;
+      case Entry::KIND_LIST:
+        code = curl_easy_setopt(ch, entry.id, entry.list);
+        break;
+      case Entry::KIND_HEADER_LIST:
+        code = curl_easy_setopt(ch, entry.id, entry.headerList->Head());
+        break;
+    }
+
+    if (code != CURLE_OK) {
+      return code;
+    }
+
+    appliedCount++;
+  }
+
+  return CURLE_OK;
+}
+
+bool OptionTemplate::AddEntry(Options& options, v8::Local<v8::Value> opt,
+                              v8::Local<v8::Value> value) {
+  int32_t optionId = 0;
+  int optionTable = curlOptionIndex.Find(opt, optionId);
+
+  Entry entry;
+  entry.id = static_cast<CURLoption>(optionId);
+  entry.kind = Entry::KIND_NULL;
+  entry.number = 0;
+  entry.list = NULL;
+
+  if (optionTable < 0) {
+    Nan::ThrowError("Unknown option given to the template.");
+    return false;
+  }
+
+  if (optionTable == CURL_OPTION_STRING) {
+    if (!value->IsString() && !value->IsNull()) {
+      Nan::ThrowTypeError("Option value must be a string.");
+      return false;
+    }
+
+    // the template is not kept alive by the handles for strings, so this one must be copied too
+    if (entry.id == CURLOPT_POSTFIELDS) {
+      entry.id = CURLOPT_COPYPOSTFIELDS;
+    }
+
+    if (value->IsString()) {
+      Nan::Utf8String valueUtf8(value);
+
+      entry.kind = Entry::KIND_STRING;
+      entry.string = std::string(*valueUtf8, static_cast<size_t>(valueUtf8.length()));
+    }
+  } else if (optionTable == CURL_OPTION_INTEGER && entry.id != CURLOPT_READDATA &&
+             entry.id != CURLOPT_WRITEDATA) {
+    if (!value->IsNumber() && !value->IsBoolean() && !value->IsNull()) {
+      Nan::ThrowTypeError("Option value must be a number.");
+      return false;
+    }
+
+    switch (entry.id) {
+      case CURLOPT_INFILESIZE_LARGE:
+      case CURLOPT_MAXFILESIZE_LARGE:
+      case CURLOPT_MAX_RECV_SPEED_LARGE:
+      case CURLOPT_MAX_SEND_SPEED_LARGE:
+      case CURLOPT_POSTFIELDSIZE_LARGE:
+      case CURLOPT_RESUME_FROM_LARGE:
+        entry.kind = Entry::KIND_OFF_T;
+        entry.number = static_cast<curl_off_t>(Nan::To<double>(value).FromJust());
+        break;
+      default:
+        entry.kind = Entry::KIND_LONG;
+        entry.number = Nan::To<int32_t>(value).FromJust();
+        break;
+    }
+  } else if (optionTable == CURL_OPTION_LINKED_LIST && entry.id != CURLOPT_HTTPPOST) {
+    bool isHeaderList =
+        value->IsObject() &&
+        Nan::New(IsolateData::Current()->headerListConstructor)->HasInstance(value);
+
+    if (!value->IsArray() && !value->IsNull() && !isHeaderList) {
+      Nan::ThrowTypeError("Option value must be an Array.");
+      return false;
+    }
+
+    if (isHeaderList) {
+      entry.kind = Entry::KIND_HEADER_LIST;
+      entry.headerList =
+          Nan::ObjectWrap::Unwrap<HeaderList>(Nan::To<v8::Object>(value).ToLocalChecked())->lines;
+    } else if (value->IsArray()) {
+      v8::Local<v8::Array> array = value.As<v8::Array>();
+
+      entry.kind = Entry::KIND_LIST;
+
+      for (uint32_t i = 0, len = array->Length(); i < len; ++i) {
+        entry.list =
+            curl_slist_append(entry.list, *Nan::Utf8String(Nan::Get(array, i).ToLocalChecked()));
+      }
+
+      // empty lists are the same than unsetting the option
+      if (!entry.list) {
+        entry.kind = Entry::KIND_NULL;
+      }
+    }
+  } else {
+    Nan::ThrowTypeError(
+        "Option can not be used in a template, only options whose value is a string, a number or "
+        "an Array of strings can. It must be set with setOpt instead.");
+    return false;
+  }
+
+  // the Options destructor takes care of the list
+  options.entries.push_back(entry);
+
+  return true;
+}
+
+NAN_MODULE_INIT(OptionTemplate::Initialize) {
+  Nan::HandleScope scope;
+
+  v8::Local<v8::FunctionTemplate> tmpl = Nan::New<v8::FunctionTemplate>(OptionTemplate::New);
+  tmpl->SetClassName(Nan::New("OptionTemplate").ToLocalChecked());
+  tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  IsolateData::Current()->optionTemplateConstructor.Reset(tmpl);
+
+  Nan::Set(target, Nan::New("OptionTemplate").ToLocalChecked(),
+           Nan::GetFunction(tmpl).ToLocalChecked());
+}
+
+// the options can be given the same way than to Easy.setOpts, an object, or an array of
+// [option, value] pairs, which are applied in the given order.
+NAN_METHOD(OptionTemplate::New) {
+  if (!info.IsConstructCall()) {
+    Nan::ThrowError("You must use \"new\" to instantiate this object.");
+    return;
+  }
+
+  v8::Local<v8::Value> optionsValue = info[0];
+  bool isArray = optionsValue->IsArray();
+
+  if (!isArray && (!optionsValue->IsObject() || optionsValue->IsFunction())) {
+    Nan::ThrowTypeError("Options should be an Object or an Array of [option, value] pairs.");
+    return;
+  }
+
+  v8::Local<v8::Object> optionsObj = Nan::To<v8::Object>(optionsValue).ToLocalChecked();
+  v8::Local<v8::Array> keys;
+
+  if (isArray) {
+    keys = optionsObj.As<v8::Array>();
+  } else if (!Nan::GetOwnPropertyNames(optionsObj).ToLocal(&keys)) {
+    return;
+  }
+
+  std::shared_ptr<Options> options = std::make_shared<Options>();
+  uint32_t length = keys->Length();
+
+  options->entries.reserve(length);
+
+  for (uint32_t i = 0; i < length; i++) {
+    v8::Local<v8::Value> opt;
+    v8::Local<v8::Value> value;
+
+    if (isArray) {
+      v8::Local<v8::Value> pair = Nan::Get(keys, i).ToLocalChecked();
+
+      if (!pair->IsArray()) {
+        Nan::ThrowTypeError("Options should be an Object or an Array of [option, value] pairs.");
+        return;
+      }
+
+      v8::Local<v8::Object> pairObj = Nan::To<v8::Object>(pair).ToLocalChecked();
+      opt = Nan::Get(pairObj, 0).ToLocalChecked();
+      value = Nan::Get(pairObj, 1).ToLocalChecked();
+    } else {
+      opt = Nan::Get(keys, i).ToLocalChecked();
+
+      if (!Nan::Get(optionsObj, opt).ToLocal(&value)) {
+        return;
+      }
+    }
+
+    if (!OptionTemplate::AddEntry(*options, opt, value)) {
+      return;
+    }
+  }
+
+  OptionTemplate* obj = new OptionTemplate();
+  obj->options = options;
+
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+}  // namespace NodeLibcurl
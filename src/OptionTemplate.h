@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_OPTIONTEMPLATE_H
+#define NODELIBCURL_OPTIONTEMPLATE_H
+
+#include "HeaderList.h"
+
+#include <curl/curl.h>
+#include <nan.h>
+#include <node.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Immutable set of options, converted to their C representation once, when the template is
+// created, so it can be applied to many Easy handles without converting them again.
+// Only options whose value is a string, a number or a list of strings can be used, the ones
+// that need per handle state, like the callbacks, must still be set with setOpt.
+class OptionTemplate : public Nan::ObjectWrap {
+ public:
+  struct Entry {
+    enum Kind {
+      KIND_NULL = 0,
+      KIND_STRING,
+      KIND_LONG,
+      KIND_OFF_T,
+      KIND_LIST,
+      KIND_HEADER_LIST,  // a HeaderList, which is shared, not copied
+    };
+
+    CURLoption id;
+    Kind kind;
+    std::string string;
+    curl_off_t number;
+    curl_slist* list;
+    std::shared_ptr<const HeaderList::Lines> headerList;
+  };
+
+  // the converted options, shared with the handles using lists from it, since libcurl does not
+  // copy them.
+  class Options {
+    Options(const Options& that);
+    Options& operator=(const Options& that);
+
+   public:
+    Options() {}
+    ~Options();
+
+    std::vector<Entry> entries;
+  };
+
+ private:
+  OptionTemplate();
+
+  OptionTemplate(const OptionTemplate& that);
+  OptionTemplate& operator=(const OptionTemplate& that);
+
+  // converts a single option, returns false if a js exception was thrown
+  static bool AddEntry(Options& options, v8::Local<v8::Value> opt, v8::Local<v8::Value> value);
+
+ public:
+  // members
+  std::shared_ptr<const Options> options;
+
+  // sets all options on the handle, in the order they were given, stopping on the first one
+  // libcurl rejects. appliedCount is set to the number of entries that were set.
+  CURLcode Apply(CURL* ch, size_t& appliedCount) const;
+
+  // export OptionTemplate to js
+  static NAN_MODULE_INIT(Initialize);
+
+  // js available methods
+  static NAN_METHOD(New);
+};
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,283 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "RingSink.h"
+
+#include "Easy.h"
+#include "IsolateData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+// how often, in milliseconds, a paused transfer checks if the consumer made room for the chunk,
+// the interval doubles after each check that fails, up to the max one.
+#define RING_SINK_POLL_INTERVAL 1
+#define RING_SINK_MAX_POLL_INTERVAL 50
+// with Easy.perform, the longest time, in milliseconds, the thread waits for the consumer before
+// the transfer is aborted.
+#define RING_SINK_PERFORM_TIMEOUT 5000
+
+// values of the state in the header
+#define RING_SINK_STATE_RUNNING 0
+#define RING_SINK_STATE_ENDED 1
+#define RING_SINK_STATE_ABORTED 2
+
+namespace NodeLibcurl {
+
+RingSink::RingSink(Easy* easy, char* contents, size_t byteLength) : easy(easy) {
+  std::atomic<int32_t>* values = reinterpret_cast<std::atomic<int32_t>*>(contents);
+
+  this->head = &values[0];
+  this->tail = &values[1];
+  this->state = &values[2];
+  this->waiting = &values[3];
+  this->ring = contents + RingSink::HEADER_SIZE;
+  this->capacity = static_cast<uint32_t>(byteLength - RingSink::HEADER_SIZE);
+
+  uv_timer_init(IsolateData::Current()->loop, &this->timer);
+  this->timer.data = this;
+}
+
+RingSink::~RingSink() {
+  this->sharedArrayBuffer.Reset();
+  this->header.Reset();
+  this->atomicsNotify.Reset();
+  this->atomics.Reset();
+}
+
+RingSink* RingSink::Create(Easy* easy, v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer) {
+#if V8_MAJOR_VERSION >= 8
+  std::shared_ptr<v8::BackingStore> backingStore = sharedArrayBuffer->GetBackingStore();
+  char* contents = static_cast<char*>(backingStore->Data());
+  size_t byteLength = backingStore->ByteLength();
+#else
+  v8::SharedArrayBuffer::Contents backingStore = sharedArrayBuffer->GetContents();
+  char* contents = static_cast<char*>(backingStore.Data());
+  size_t byteLength = backingStore.ByteLength();
+#endif
+
+  size_t capacity = byteLength > RingSink::HEADER_SIZE ? byteLength - RingSink::HEADER_SIZE : 0;
+
+  // libcurl never passes chunks bigger than CURL_MAX_WRITE_SIZE to the WRITEFUNCTION
+  if (capacity < CURL_MAX_WRITE_SIZE || capacity > 0x80000000 ||
+      (capacity & (capacity - 1)) != 0) {
+    Nan::ThrowRangeError(
+        "The SharedArrayBuffer must have 16 bytes for the header plus a power of two, of at least "
+        "16384 bytes, for the data.");
+    return nullptr;
+  }
+
+  v8::Local<v8::Object> global = Nan::GetCurrentContext()->Global();
+  v8::Local<v8::Value> atomics = Nan::Get(global, Nan::New("Atomics").ToLocalChecked())
+                                     .FromMaybe(v8::Local<v8::Value>(Nan::Undefined()));
+
+  if (!atomics->IsObject()) {
+    Nan::ThrowError("Atomics is not available.");
+    return nullptr;
+  }
+
+  v8::Local<v8::Object> atomicsObj = Nan::To<v8::Object>(atomics).ToLocalChecked();
+  v8::Local<v8::Value> notify = Nan::Get(atomicsObj, Nan::New("notify").ToLocalChecked())
+                                    .FromMaybe(v8::Local<v8::Value>(Nan::Undefined()));
+
+  // older V8 versions call it wake
+  if (!notify->IsFunction()) {
+    notify = Nan::Get(atomicsObj, Nan::New("wake").ToLocalChecked())
+                 .FromMaybe(v8::Local<v8::Value>(Nan::Undefined()));
+  }
+
+  if (!notify->IsFunction()) {
+    Nan::ThrowError("Atomics.notify is not available.");
+    return nullptr;
+  }
+
+  RingSink* sink = new RingSink(easy, contents, byteLength);
+
+  sink->sharedArrayBuffer.Reset(sharedArrayBuffer);
+  sink->header.Reset(v8::Int32Array::New(sharedArrayBuffer, 0, 4));
+  sink->atomicsNotify.Reset(notify.As<v8::Function>());
+  sink->atomics.Reset(atomicsObj);
+
+  return sink;
+}
+
+void RingSink::Prepare() {
+  this->StopWaiting();
+
+  // the consumer of a previous transfer that was aborted was not woken up yet
+  if (this->isAbortNotifyPending) {
+    this->isAbortNotifyPending = false;
+    this->Notify();
+  }
+
+  this->state->store(RING_SINK_STATE_RUNNING);
+}
+
+void RingSink::End() {
+  this->StopWaiting();
+  this->state->store(RING_SINK_STATE_ENDED);
+  this->Notify();
+}
+
+void RingSink::Abort() {
+  this->StopWaiting();
+
+  int32_t running = RING_SINK_STATE_RUNNING;
+
+  if (this->state->compare_exchange_strong(running, RING_SINK_STATE_ABORTED)) {
+    this->isAbortNotifyPending = true;
+    uv_timer_start(&this->timer, RingSink::OnTimer, 0, 0);
+  }
+}
+
+void RingSink::StartWaiting() {
+  this->isPaused = true;
+  this->pollInterval = RING_SINK_POLL_INTERVAL;
+  uv_timer_start(&this->timer, RingSink::OnTimer, this->pollInterval, 0);
+}
+
+void RingSink::StopWaiting() {
+  uv_timer_stop(&this->timer);
+  this->isPaused = false;
+  this->requiredBytes = 0;
+}
+
+bool RingSink::HasRoom() const {
+  uint32_t used = static_cast<uint32_t>(this->head->load(std::memory_order_relaxed)) -
+                  static_cast<uint32_t>(this->tail->load());
+
+  // if the tail is invalid resuming makes libcurl call Write again, which aborts the transfer.
+  return used > this->capacity || this->capacity - used >= this->requiredBytes;
+}
+
+void RingSink::OnConsumed() {
+  if (!this->isPaused || !this->easy || !this->easy->multi || !this->HasRoom()) {
+    return;
+  }
+
+  this->StopWaiting();
+  this->easy->ResumeDirection(CURLPAUSE_RECV);
+}
+
+size_t RingSink::Write(const char* data, size_t n, bool isAsync) {
+  uint32_t head = static_cast<uint32_t>(this->head->load(std::memory_order_relaxed));
+
+  // returning something different than n aborts the transfer
+  if (n > this->capacity) {
+    return 0;
+  }
+
+  std::chrono::steady_clock::time_point deadline;
+  int interval = RING_SINK_POLL_INTERVAL;
+
+  for (;;) {
+    uint32_t used = head - static_cast<uint32_t>(this->tail->load());
+
+    if (used > this->capacity) {
+      return 0;
+    }
+
+    if (this->capacity - used >= n) {
+      break;
+    }
+
+    // libcurl is going to pass this same chunk again after the transfer is unpaused
+    if (isAsync) {
+      this->requiredBytes = n;
+      this->StartWaiting();
+      return CURL_WRITEFUNC_PAUSE;
+    }
+
+    // Easy.perform blocks the loop thread, the consumer must be running on another one.
+    // It cannot be unpaused from here, so it waits a bounded time, checking less often the
+    // longer it takes, and aborts the transfer if the consumer does not make room.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (interval == RING_SINK_POLL_INTERVAL) {
+      deadline = now + std::chrono::milliseconds(RING_SINK_PERFORM_TIMEOUT);
+    } else if (now >= deadline) {
+      return 0;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+    interval = std::min(interval * 2, RING_SINK_MAX_POLL_INTERVAL);
+  }
+
+  uint32_t position = head & (this->capacity - 1);
+  size_t first = std::min(n, static_cast<size_t>(this->capacity - position));
+
+  std::memcpy(this->ring + position, data, first);
+  std::memcpy(this->ring, data + first, n - first);
+
+  this->head->store(static_cast<int32_t>(head + static_cast<uint32_t>(n)));
+
+  this->Notify();
+
+  return n;
+}
+
+// only calls Atomics.notify if the consumer said it is waiting
+void RingSink::Notify() {
+  if (this->waiting->load() == 0) {
+    return;
+  }
+
+  Nan::HandleScope scope;
+
+  v8::Local<v8::Value> argv[] = {Nan::New(this->header), Nan::New<v8::Int32>(0)};
+
+  Nan::Call(Nan::New(this->atomicsNotify), Nan::New(this->atomics), 2, argv);
+}
+
+void RingSink::Detach() {
+  this->Abort();
+  this->easy = nullptr;
+
+  uv_timer_stop(&this->timer);
+  uv_close(reinterpret_cast<uv_handle_t*>(&this->timer), RingSink::OnTimerClose);
+}
+
+void RingSink::OnTimer(uv_timer_t* timer) {
+  RingSink* sink = static_cast<RingSink*>(timer->data);
+
+  if (sink->isAbortNotifyPending) {
+    sink->isAbortNotifyPending = false;
+    sink->Notify();
+    return;
+  }
+
+  // the handle was removed from the Multi instance while paused
+  if (!sink->easy || !sink->easy->multi) {
+    sink->StopWaiting();
+    return;
+  }
+
+  if (!sink->HasRoom()) {
+    sink->pollInterval =
+        std::min(sink->pollInterval * 2, static_cast<uint64_t>(RING_SINK_MAX_POLL_INTERVAL));
+    uv_timer_start(timer, RingSink::OnTimer, sink->pollInterval, 0);
+    return;
+  }
+
+  sink->StopWaiting();
+  sink->easy->ResumeDirection(CURLPAUSE_RECV);
+}
+
+void RingSink::OnTimerClose(uv_handle_t* handle) {
+  RingSink* sink = static_cast<RingSink*>(handle->data);
+
+  // Detach can be called while v8 collects garbage, the consumer is woken up from here instead
+  if (sink->isAbortNotifyPending) {
+    sink->Notify();
+  }
+
+  delete sink;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_RINGSINK_H
+#define NODELIBCURL_RINGSINK_H
+
+#include <curl/curl.h>
+#include <nan.h>
+#include <uv.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace NodeLibcurl {
+
+class Easy;
+
+// Copies the body received by an Easy handle into a SharedArrayBuffer (set with setWriteRing)
+// used as a single producer / single consumer ring, so it can be read by another thread.
+//
+// The SharedArrayBuffer starts with a header of 4 int32 values, followed by the ring data,
+// which size must be a power of two:
+//   [0] head, total bytes written by the producer, wraps around at 2^32
+//   [1] tail, total bytes read by the consumer, wraps around at 2^32
+//   [2] state, 0 while the transfer is running, 1 after it finishes, 2 if the handle stopped
+//       writing to it before that (it was removed from the Multi instance, closed or reset,
+//       or the ring was replaced)
+//   [3] set by the consumer to 1 before calling Atomics.wait on the head, so it is notified
+// Chunks are only written if they fit entirely, otherwise the transfer is paused until the
+// consumer advances the tail enough. That is checked with a timer backing off up to 50ms, or
+// right away when the consumer calls Easy.writeRingConsumed.
+class RingSink {
+  RingSink(Easy* easy, char* contents, size_t byteLength);
+
+  RingSink(const RingSink& that);
+  RingSink& operator=(const RingSink& that);
+
+  ~RingSink();
+
+  void Notify();
+  void StopWaiting();
+  void StartWaiting();
+  bool HasRoom() const;
+
+  static void OnTimer(uv_timer_t* timer);
+  static void OnTimerClose(uv_handle_t* handle);
+
+  Easy* easy;
+
+  Nan::Persistent<v8::SharedArrayBuffer> sharedArrayBuffer;
+  Nan::Persistent<v8::Int32Array> header;
+  Nan::Persistent<v8::Function> atomicsNotify;
+  Nan::Persistent<v8::Object> atomics;
+
+  std::atomic<int32_t>* head;
+  std::atomic<int32_t>* tail;
+  std::atomic<int32_t>* state;
+  std::atomic<int32_t>* waiting;
+  char* ring;
+  uint32_t capacity;
+
+  // used to check if the consumer made room for the chunk that paused the transfer, and to
+  // notify the consumer from the loop when the transfer is aborted.
+  uv_timer_t timer;
+  uint64_t pollInterval = 0;
+  size_t requiredBytes = 0;
+  bool isPaused = false;
+  bool isAbortNotifyPending = false;
+
+ public:
+  static const size_t HEADER_SIZE = 16;
+
+  // returns nullptr, with a js exception thrown, if the SharedArrayBuffer cannot be used
+  static RingSink* Create(Easy* easy, v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer);
+
+  // must be called before each transfer starts
+  void Prepare();
+  // marks the transfer as finished, waking up the consumer
+  void End();
+  // marks the transfer as aborted if it did not finish yet. It can be called while v8 collects
+  // garbage, so the consumer is woken up later, from the loop.
+  void Abort();
+  // the consumer advanced the tail, resumes the transfer if the paused chunk fits now
+  void OnConsumed();
+
+  // to be used by the WRITEFUNCTION callback, the return value has the same meaning
+  size_t Write(const char* data, size_t n, bool isAsync);
+
+  // the Easy handle does not need this sink anymore, the transfer is aborted if it did not
+  // finish, and it is deleted after the timer is closed.
+  void Detach();
+};
+}  // namespace NodeLibcurl
+#endif
@@ -7,6 +7,8 @@
 
 #include "Share.h"
 
+#include "IsolateData.h"
+
 #include <iostream>
 
 // 464 was allocated on Win64
@@ -15,18 +17,45 @@
 
 namespace NodeLibcurl {
 
-Nan::Persistent<v8::FunctionTemplate> Share::constructor;
-
 Share::Share() : isOpen(true) {
   this->sh = curl_share_init();
 
   assert(this->sh);
+
+  for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+    uv_mutex_init(&this->locks[i]);
+  }
+
+  curl_share_setopt(this->sh, CURLSHOPT_LOCKFUNC, Share::LockFunction);
+  curl_share_setopt(this->sh, CURLSHOPT_UNLOCKFUNC, Share::UnlockFunction);
+  curl_share_setopt(this->sh, CURLSHOPT_USERDATA, this);
 }
 
 Share::~Share(void) {
   if (this->isOpen) {
     this->Dispose();
   }
+
+  for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+    uv_mutex_destroy(&this->locks[i]);
+  }
+}
+
+// shared and single access are not distinguished, libcurl holds the locks only briefly
+void Share::LockFunction(CURL* handle, curl_lock_data data, curl_lock_access access,
+                         void* userptr) {
+  (void)handle;
+  (void)access;
+
+  Share* obj = static_cast<Share*>(userptr);
+  uv_mutex_lock(&obj->locks[data]);
+}
+
+void Share::UnlockFunction(CURL* handle, curl_lock_data data, void* userptr) {
+  (void)handle;
+
+  Share* obj = static_cast<Share*>(userptr);
+  uv_mutex_unlock(&obj->locks[data]);
 }
 
 void Share::Dispose() {
@@ -54,7 +83,7 @@ NAN_MODULE_INIT(Share::Initialize) {
   // static methods
   Nan::SetMethod(tmpl, "strError", Share::StrError);
 
-  Share::constructor.Reset(tmpl);
+  IsolateData::Current()->shareConstructor.Reset(tmpl);
 
   Nan::Set(target, Nan::New("Share").ToLocalChecked(), Nan::GetFunction(tmpl).ToLocalChecked());
 }
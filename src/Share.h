@@ -11,6 +11,7 @@
 #include <curl/curl.h>
 #include <nan.h>
 #include <node.h>
+#include <uv.h>
 
 namespace NodeLibcurl {
 
@@ -25,10 +26,16 @@ class Share : public Nan::ObjectWrap {
   // instance methods
   void Dispose();
 
- public:
-  // js object constructor template
-  static Nan::Persistent<v8::FunctionTemplate> constructor;
+  // the handles using the share can be running on different threads, like the ones of a
+  // ThreadedMulti, so each kind of shared data has its own lock.
+  uv_mutex_t locks[CURL_LOCK_DATA_LAST];
+
+  // libcurl share callbacks
+  static void LockFunction(CURL* handle, curl_lock_data data, curl_lock_access access,
+                           void* userptr);
+  static void UnlockFunction(CURL* handle, curl_lock_data data, void* userptr);
 
+ public:
   // members
   CURLSH* sh;
   bool isOpen;
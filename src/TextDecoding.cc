@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "TextDecoding.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// smaller bodies are copied into a regular string, the external one is not worth it
+#define TEXT_DECODING_MIN_EXTERNAL_LENGTH 1024
+
+namespace NodeLibcurl {
+
+namespace {
+class ExternalOneByteString : public v8::String::ExternalOneByteStringResource {
+  char* data_;
+  size_t length_;
+
+ public:
+  ExternalOneByteString(char* data, size_t length) : data_(data), length_(length) {}
+
+  ~ExternalOneByteString() { std::free(this->data_); }
+
+  const char* data() const { return this->data_; }
+  size_t length() const { return this->length_; }
+};
+}  // namespace
+
+bool IsAscii(const char* data, size_t length) {
+  const uint64_t highBits = 0x8080808080808080ULL;
+  size_t i = 0;
+
+  // 4 words at a time, compilers turn this into vector instructions when available
+  for (; i + 32 <= length; i += 32) {
+    uint64_t words[4];
+    std::memcpy(words, data + i, sizeof(words));
+
+    if ((words[0] | words[1] | words[2] | words[3]) & highBits) {
+      return false;
+    }
+  }
+
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+
+    if (word & highBits) {
+      return false;
+    }
+  }
+
+  for (; i < length; i++) {
+    if (static_cast<unsigned char>(data[i]) >= 0x80) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Nan::MaybeLocal<v8::String> NewStringFromBody(char* data, size_t length, TextEncoding encoding) {
+  if (length == 0) {
+    std::free(data);
+    return Nan::EmptyString();
+  }
+
+  if (length > static_cast<size_t>(v8::String::kMaxLength)) {
+    std::free(data);
+    return Nan::MaybeLocal<v8::String>();
+  }
+
+  bool isOneByte = encoding == TEXT_ENCODING_LATIN1 || IsAscii(data, length);
+
+  if (isOneByte && length >= TEXT_DECODING_MIN_EXTERNAL_LENGTH) {
+    // v8 owns the resource now, and deletes it when the string is garbage collected
+    ExternalOneByteString* resource = new ExternalOneByteString(data, length);
+    Nan::MaybeLocal<v8::String> string = Nan::New<v8::String>(resource);
+
+    if (string.IsEmpty()) {
+      delete resource;
+    }
+
+    return string;
+  }
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::MaybeLocal<v8::String> string =
+      isOneByte ? v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(data),
+                                             v8::NewStringType::kNormal, static_cast<int>(length))
+                : v8::String::NewFromUtf8(isolate, data, v8::NewStringType::kNormal,
+                                          static_cast<int>(length));
+
+  std::free(data);
+
+  return string;
+}
+
+}  // namespace NodeLibcurl
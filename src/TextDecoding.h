@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_TEXTDECODING_H
+#define NODELIBCURL_TEXTDECODING_H
+
+#include <nan.h>
+
+#include <cstddef>
+
+namespace NodeLibcurl {
+
+enum TextEncoding {
+  TEXT_ENCODING_UTF8 = 0,
+  TEXT_ENCODING_LATIN1 = 1,
+};
+
+// whether all bytes are below 0x80, checks a machine word at a time
+bool IsAscii(const char* data, size_t length);
+
+// Creates a js string from a body, taking ownership of data, which must have been allocated with
+// malloc. ASCII and latin1 bodies become external strings backed by data itself, so no copy is
+// made, other UTF-8 bodies are transcoded by V8, with invalid sequences replaced by U+FFFD.
+// Returns an empty handle if the body is too big to fit into a string.
+Nan::MaybeLocal<v8::String> NewStringFromBody(char* data, size_t length, TextEncoding encoding);
+
+}  // namespace NodeLibcurl
+#endif
@@ -0,0 +1,443 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "ThreadedMulti.h"
+
+#include "Easy.h"
+#include "IsolateData.h"
+
+#include <set>
+
+// 85233 was allocated on Win64
+#define MEMORY_PER_HANDLE 60000
+
+// max time the thread waits in curl_multi_poll, it's woken up earlier by curl_multi_wakeup
+#define THREADED_MULTI_MAX_WAIT_MS 1000
+
+namespace NodeLibcurl {
+
+ThreadedMulti::ThreadedMulti() : isStopping(false) {
+  this->mh = curl_multi_init();
+  assert(this->mh && "Could not initialize libcurl multi handle.");
+
+  NODE_LIBCURL_ADJUST_MEM(MEMORY_PER_HANDLE);
+
+  this->async = new uv_async_t;
+
+  int asyncStatus =
+      uv_async_init(IsolateData::Current()->loop, this->async, ThreadedMulti::OnAsync);
+  assert(asyncStatus == 0 && "Could not initialize libuv async handle");
+
+  this->async->data = this;
+
+  // the loop is only kept alive while there are transfers running
+  uv_unref(reinterpret_cast<uv_handle_t*>(this->async));
+
+  int threadStatus = uv_thread_create(&this->thread, ThreadedMulti::Run, this);
+  assert(threadStatus == 0 && "Could not create the multi thread");
+}
+
+ThreadedMulti::~ThreadedMulti() {
+  if (this->isOpen) {
+    this->Dispose();
+  }
+}
+
+void ThreadedMulti::Dispose() {
+  assert(this->isOpen);
+
+  this->isOpen = false;
+
+  this->isStopping = true;
+
+#if NODE_LIBCURL_VER_GE(7, 68, 0)
+  curl_multi_wakeup(this->mh);
+#endif
+
+  // the thread removes the handles it was still running before returning
+  uv_thread_join(&this->thread);
+
+  // this can be running from the garbage collector, where js cannot be called, and
+  // the handles are removed without onMessage being called for them anyway.
+  this->ProcessCompletions(true);
+
+  this->async->data = nullptr;
+  uv_close(reinterpret_cast<uv_handle_t*>(this->async), ThreadedMulti::OnAsyncClose);
+  this->async = nullptr;
+
+  CURLMcode code = curl_multi_cleanup(this->mh);
+  assert(code == CURLM_OK);
+
+  NODE_LIBCURL_ADJUST_MEM(-MEMORY_PER_HANDLE);
+}
+
+// runs on the multi thread, no v8 or libuv loop function can be called here.
+// setlocale is not used like on the main thread, since it's not thread safe.
+void ThreadedMulti::Run(void* arg) {
+#if NODE_LIBCURL_VER_GE(7, 68, 0)
+  ThreadedMulti* obj = static_cast<ThreadedMulti*>(arg);
+
+  // handles added to the multi handle
+  std::set<Easy*> running;
+  std::vector<Command> commands;
+
+  int runningHandles = 0;
+
+  while (!obj->isStopping) {
+    bool hasCompletions = false;
+
+    obj->commands.PopAll(commands);
+
+    for (const Command& command : commands) {
+      if (command.type == COMMAND_ADD) {
+        if (curl_multi_add_handle(obj->mh, command.easy->ch) == CURLM_OK) {
+          running.insert(command.easy);
+        } else {
+          obj->completions.Push(Completion{command.easy, CURLE_FAILED_INIT, false});
+          hasCompletions = true;
+        }
+        // the transfer could have finished already, its completion is on the way then
+      } else if (running.erase(command.easy)) {
+        curl_multi_remove_handle(obj->mh, command.easy->ch);
+
+        obj->completions.Push(Completion{command.easy, CURLE_OK, true});
+        hasCompletions = true;
+      }
+    }
+
+    commands.clear();
+
+    curl_multi_perform(obj->mh, &runningHandles);
+
+    CURLMsg* msg = NULL;
+    int pending = 0;
+
+    while ((msg = curl_multi_info_read(obj->mh, &pending))) {
+      if (msg->msg != CURLMSG_DONE) {
+        continue;
+      }
+
+      char* ptr = nullptr;
+      curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &ptr);
+      assert(ptr != nullptr && "Invalid handle returned from CURLINFO_PRIVATE.");
+
+      Easy* easy = reinterpret_cast<Easy*>(ptr);
+      CURLcode code = msg->data.result;
+
+      // msg is not valid after the handle is removed
+      curl_multi_remove_handle(obj->mh, easy->ch);
+      running.erase(easy);
+
+      obj->completions.Push(Completion{easy, code, false});
+      hasCompletions = true;
+    }
+
+    if (hasCompletions) {
+      uv_async_send(obj->async);
+    }
+
+    curl_multi_poll(obj->mh, NULL, 0, THREADED_MULTI_MAX_WAIT_MS, NULL);
+  }
+
+  // added handles that were not sent to the thread yet are handled like the running ones
+  obj->commands.PopAll(commands);
+
+  for (const Command& command : commands) {
+    if (command.type == COMMAND_ADD) {
+      obj->completions.Push(Completion{command.easy, CURLE_OK, true});
+    } else if (running.erase(command.easy)) {
+      curl_multi_remove_handle(obj->mh, command.easy->ch);
+      obj->completions.Push(Completion{command.easy, CURLE_OK, true});
+    }
+  }
+
+  for (Easy* easy : running) {
+    curl_multi_remove_handle(obj->mh, easy->ch);
+    obj->completions.Push(Completion{easy, CURLE_OK, true});
+  }
+#else
+  (void)arg;
+#endif
+}
+
+void ThreadedMulti::OnAsync(uv_async_t* handle) {
+  ThreadedMulti* obj = static_cast<ThreadedMulti*>(handle->data);
+
+  if (obj) {
+    obj->ProcessCompletions(false);
+  }
+}
+
+void ThreadedMulti::OnAsyncClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_async_t*>(handle);
+}
+
+void ThreadedMulti::ProcessCompletions(bool isDisposing) {
+  std::vector<Completion> finished;
+
+  this->completions.PopAll(finished);
+
+  for (const Completion& completion : finished) {
+    std::map<Easy*, Entry>::iterator it = this->entries.find(completion.easy);
+    assert(it != this->entries.end() && "Completion of a handle that was not added.");
+
+    Easy* easy = completion.easy;
+
+    if (isDisposing) {
+      it->second.handle->Reset();
+      this->entries.erase(it);
+
+      easy->isInsideMultiHandle = false;
+      easy->isInsideThreadedMulti = false;
+      easy->EndTransfer();
+      continue;
+    }
+
+    Nan::HandleScope scope;
+
+    // the js object must stay alive until the callback returns
+    v8::Local<v8::Object> easyObj = Nan::New(*it->second.handle);
+    bool isRemoved = completion.isRemoved || it->second.isRemoving;
+
+    it->second.handle->Reset();
+    this->entries.erase(it);
+
+    easy->isInsideMultiHandle = false;
+    easy->isInsideThreadedMulti = false;
+
+    if (this->entries.empty() && this->async) {
+      uv_unref(reinterpret_cast<uv_handle_t*>(this->async));
+    }
+
+    if (!isRemoved) {
+      this->CallOnMessageCallback(easy, completion.code);
+    }
+  }
+}
+
+void ThreadedMulti::CallOnMessageCallback(Easy* easy, CURLcode statusCode) {
+  Nan::HandleScope scope;
+
+  easy->EndTransfer();
+
+  // we don't have an on message callback, just return.
+  if (this->cbOnMessage == nullptr) {
+    return;
+  }
+
+  statusCode = easy->GetTransferResult(statusCode);
+
+  v8::Local<v8::Value> err = Nan::Null();
+  v8::Local<v8::Int32> errCode = Nan::New(static_cast<int32_t>(statusCode));
+
+  if (statusCode != CURLE_OK) {
+    err = Nan::Error(curl_easy_strerror(statusCode));
+  }
+
+  v8::Local<v8::Value> argv[] = {err, easy->handle(), errCode};
+  const int argc = 3;
+
+  Nan::Call(*(this->cbOnMessage), easy->handle(), argc, argv);
+}
+
+NAN_MODULE_INIT(ThreadedMulti::Initialize) {
+  Nan::HandleScope scope;
+
+  // ThreadedMulti js "class" function template initialization
+  v8::Local<v8::FunctionTemplate> tmpl = Nan::New<v8::FunctionTemplate>(ThreadedMulti::New);
+  tmpl->SetClassName(Nan::New("ThreadedMulti").ToLocalChecked());
+  tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  // prototype methods
+  Nan::SetPrototypeMethod(tmpl, "addHandle", ThreadedMulti::AddHandle);
+  Nan::SetPrototypeMethod(tmpl, "removeHandle", ThreadedMulti::RemoveHandle);
+  Nan::SetPrototypeMethod(tmpl, "onMessage", ThreadedMulti::OnMessage);
+  Nan::SetPrototypeMethod(tmpl, "getCount", ThreadedMulti::GetCount);
+  Nan::SetPrototypeMethod(tmpl, "close", ThreadedMulti::Close);
+
+  Nan::Set(target, Nan::New("ThreadedMulti").ToLocalChecked(),
+           Nan::GetFunction(tmpl).ToLocalChecked());
+}
+
+NAN_METHOD(ThreadedMulti::New) {
+  if (!info.IsConstructCall()) {
+    Nan::ThrowError("You must use \"new\" to instantiate this object.");
+    return;
+  }
+
+#if NODE_LIBCURL_VER_GE(7, 68, 0)
+  ThreadedMulti* obj = new ThreadedMulti();
+
+  obj->Wrap(info.This());
+
+  info.GetReturnValue().Set(info.This());
+#else
+  Nan::ThrowError("ThreadedMulti requires libcurl 7.68.0 or newer.");
+#endif
+}
+
+NAN_METHOD(ThreadedMulti::AddHandle) {
+  Nan::HandleScope scope;
+
+  ThreadedMulti* obj = Nan::ObjectWrap::Unwrap<ThreadedMulti>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Multi handle is closed.");
+    return;
+  }
+
+  v8::Local<v8::Value> handle = info[0];
+
+  if (!handle->IsObject() ||
+      !Nan::New(IsolateData::Current()->easyConstructor)->HasInstance(handle)) {
+    Nan::ThrowError(Nan::TypeError("Argument must be an instance of an Easy handle."));
+    return;
+  }
+
+  Easy* easy = Nan::ObjectWrap::Unwrap<Easy>(handle.As<v8::Object>());
+
+  if (!easy->isOpen) {
+    Nan::ThrowError("Cannot add an Easy handle that is closed.");
+    return;
+  }
+
+  if (easy->isInsideMultiHandle) {
+    Nan::ThrowError("Cannot add an Easy handle that is already inside a Multi instance.");
+    return;
+  }
+
+  const char* reason = nullptr;
+
+  if (!easy->CanRunOnThread(reason)) {
+    Nan::ThrowError(
+        (std::string("Easy handle cannot be used by a ThreadedMulti, ") + reason).c_str());
+    return;
+  }
+
+  // libcurl must not use signals when the handle runs on another thread, the timeouts of
+  // the synchronous resolver would interrupt any thread of the process otherwise.
+  curl_easy_setopt(easy->ch, CURLOPT_NOSIGNAL, 1L);
+
+  easy->PrepareTransfer();
+
+  Entry& entry = obj->entries[easy];
+  entry.handle = std::make_shared<Nan::Persistent<v8::Object>>(handle.As<v8::Object>());
+  entry.isRemoving = false;
+
+  easy->isInsideMultiHandle = true;
+  easy->isInsideThreadedMulti = true;
+
+  uv_ref(reinterpret_cast<uv_handle_t*>(obj->async));
+
+  obj->commands.Push(Command{COMMAND_ADD, easy});
+
+#if NODE_LIBCURL_VER_GE(7, 68, 0)
+  curl_multi_wakeup(obj->mh);
+#endif
+
+  info.GetReturnValue().Set(Nan::New(static_cast<int32_t>(CURLM_OK)));
+}
+
+// the handle is only released after the thread stops using it, isInsideMultiHandle is still
+// true until then, and onMessage is not called for it.
+NAN_METHOD(ThreadedMulti::RemoveHandle) {
+  Nan::HandleScope scope;
+
+  ThreadedMulti* obj = Nan::ObjectWrap::Unwrap<ThreadedMulti>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Multi handle is closed.");
+    return;
+  }
+
+  v8::Local<v8::Value> handle = info[0];
+
+  if (!handle->IsObject() ||
+      !Nan::New(IsolateData::Current()->easyConstructor)->HasInstance(handle)) {
+    Nan::ThrowError(Nan::TypeError("Argument must be an instance of an Easy handle."));
+    return;
+  }
+
+  Easy* easy = Nan::ObjectWrap::Unwrap<Easy>(handle.As<v8::Object>());
+
+  std::map<Easy*, Entry>::iterator it = obj->entries.find(easy);
+
+  if (it == obj->entries.end()) {
+    Nan::ThrowError(Nan::TypeError("Could not remove easy handle from multi handle."));
+    return;
+  }
+
+  if (!it->second.isRemoving) {
+    it->second.isRemoving = true;
+
+    obj->commands.Push(Command{COMMAND_REMOVE, easy});
+
+#if NODE_LIBCURL_VER_GE(7, 68, 0)
+    curl_multi_wakeup(obj->mh);
+#endif
+  }
+
+  info.GetReturnValue().Set(Nan::New(static_cast<int32_t>(CURLM_OK)));
+}
+
+NAN_METHOD(ThreadedMulti::OnMessage) {
+  Nan::HandleScope scope;
+
+  ThreadedMulti* obj = Nan::ObjectWrap::Unwrap<ThreadedMulti>(info.This());
+
+  if (!info.Length()) {
+    Nan::ThrowError(
+        "You must specify the callback function. If you want to remove the "
+        "current one you can pass null.");
+    return;
+  }
+
+  v8::Local<v8::Value> arg = info[0];
+
+  bool isNull = arg->IsNull();
+
+  if (!arg->IsFunction() && !isNull) {
+    Nan::ThrowTypeError(
+        "Argument must be a Function. If you want to remove the current one "
+        "you can pass null.");
+    return;
+  }
+
+  if (isNull) {
+    obj->cbOnMessage = nullptr;
+  } else {
+    obj->cbOnMessage.reset(new Nan::Callback(arg.As<v8::Function>()));
+  }
+
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(ThreadedMulti::GetCount) {
+  Nan::HandleScope scope;
+
+  ThreadedMulti* obj = Nan::ObjectWrap::Unwrap<ThreadedMulti>(info.This());
+
+  v8::Local<v8::Uint32> ret = Nan::New(static_cast<uint32_t>(obj->entries.size()));
+
+  info.GetReturnValue().Set(ret);
+}
+
+// stops the thread, the handles still inside this instance are removed without onMessage
+// being called for them.
+NAN_METHOD(ThreadedMulti::Close) {
+  Nan::HandleScope scope;
+
+  ThreadedMulti* obj = Nan::ObjectWrap::Unwrap<ThreadedMulti>(info.This());
+
+  if (!obj->isOpen) {
+    Nan::ThrowError("Multi handle already closed.");
+    return;
+  }
+
+  obj->Dispose();
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_THREADEDMULTI_H
+#define NODELIBCURL_THREADEDMULTI_H
+
+#include "Curl.h"
+#include "MpscQueue.h"
+#include "macros.h"
+
+#include <curl/curl.h>
+#include <nan.h>
+#include <node.h>
+#include <uv.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace NodeLibcurl {
+
+class Easy;
+
+// Multi handle driven by its own native thread, with curl_multi_poll, instead of the libuv loop.
+// The socket I/O, TLS and decompression done by libcurl run on that thread, the main thread is
+// only woken up when transfers finish.
+// Since no js can run on the thread, only handles whose data never goes through js can be added,
+// see Easy::CanRunOnThread. Handles are passed to the thread through a lock free queue, and
+// curl_multi_wakeup interrupts the poll, so adding one never waits for the thread.
+class ThreadedMulti : public Nan::ObjectWrap {
+  enum CommandType {
+    COMMAND_ADD = 0,
+    COMMAND_REMOVE,
+  };
+
+  // sent from the main thread to the multi thread
+  struct Command {
+    CommandType type;
+    Easy* easy;
+  };
+
+  // sent from the multi thread to the main thread, once for each added handle
+  struct Completion {
+    Easy* easy;
+    CURLcode code;
+    bool isRemoved;  // the transfer did not finish, removeHandle or close was called
+  };
+
+  // handles added to this instance, only used by the main thread
+  struct Entry {
+    std::shared_ptr<Nan::Persistent<v8::Object>> handle;  // keeps the js object alive
+    bool isRemoving;
+  };
+
+  ThreadedMulti();
+  ~ThreadedMulti();
+
+  ThreadedMulti(const ThreadedMulti& that);
+  ThreadedMulti& operator=(const ThreadedMulti& that);
+
+  void Dispose();
+  // isDisposing is true when called by Dispose, no js is called then
+  void ProcessCompletions(bool isDisposing);
+  void CallOnMessageCallback(Easy* easy, CURLcode statusCode);
+
+  // members
+  CURLM* mh = nullptr;
+  bool isOpen = true;
+
+  uv_thread_t thread;
+  uv_async_t* async = nullptr;  // wakes up the main thread when there are completions
+  std::atomic<bool> isStopping;
+
+  MpscQueue<Command> commands;
+  MpscQueue<Completion> completions;
+
+  std::map<Easy*, Entry> entries;
+
+  std::shared_ptr<Nan::Callback> cbOnMessage;
+
+  // the multi thread
+  static void Run(void* arg);
+
+  // libuv events
+  static void OnAsync(uv_async_t* handle);
+  static void OnAsyncClose(uv_handle_t* handle);
+
+ public:
+  // export ThreadedMulti to js
+  static NAN_MODULE_INIT(Initialize);
+
+  // js available Methods
+  static NAN_METHOD(New);
+  static NAN_METHOD(AddHandle);
+  static NAN_METHOD(RemoveHandle);
+  static NAN_METHOD(OnMessage);
+  static NAN_METHOD(GetCount);
+  static NAN_METHOD(Close);
+};
+
+}  // namespace NodeLibcurl
+#endif
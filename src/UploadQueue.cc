@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "UploadQueue.h"
+
+#include "Easy.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace NodeLibcurl {
+
+UploadQueue::UploadQueue(Easy* easy, size_t highWaterMark, size_t lowWaterMark,
+                         v8::Local<v8::Function> onDrain)
+    : easy(easy), highWaterMark(highWaterMark), lowWaterMark(lowWaterMark), onDrain(onDrain) {}
+
+UploadQueue::~UploadQueue() {}
+
+void UploadQueue::Prepare() { this->isPaused = false; }
+
+bool UploadQueue::Write(v8::Local<v8::Value> view) {
+  Chunk chunk;
+  chunk.contents = ViewContents::Create(view);
+  chunk.length = chunk.contents->length;
+  chunk.position = 0;
+
+  if (chunk.length > 0) {
+    this->chunks.push_back(chunk);
+    this->queuedLength += chunk.length;
+
+    this->Resume();
+  }
+
+  if (this->queuedLength >= this->highWaterMark) {
+    this->isAboveHighWaterMark = true;
+  }
+
+  return !this->isAboveHighWaterMark;
+}
+
+void UploadQueue::End(bool isAborted) {
+  this->isEnded = true;
+  this->isAborted = isAborted;
+
+  this->Resume();
+}
+
+void UploadQueue::Resume() {
+  if (this->isPaused) {
+    // libcurl can call Read again from inside this call
+    this->isPaused = false;
+    this->easy->ResumeDirection(CURLPAUSE_SEND);
+  }
+}
+
+size_t UploadQueue::Read(char* ptr, size_t n, bool isAsync) {
+  if (this->isAborted) {
+    return CURL_READFUNC_ABORT;
+  }
+
+  if (this->chunks.empty()) {
+    if (this->isEnded) {
+      return 0;
+    }
+
+    // there is nobody to write more data while Easy.perform is blocking
+    if (!isAsync) {
+      return CURL_READFUNC_ABORT;
+    }
+
+    // libcurl is going to call this again after the transfer is unpaused
+    this->isPaused = true;
+    return CURL_READFUNC_PAUSE;
+  }
+
+  size_t copied = 0;
+
+  while (copied < n && !this->chunks.empty()) {
+    Chunk& chunk = this->chunks.front();
+    size_t length = std::min(n - copied, chunk.length - chunk.position);
+
+    std::memcpy(ptr + copied, chunk.contents->data + chunk.position, length);
+    copied += length;
+    chunk.position += length;
+
+    // the memory is released with it
+    if (chunk.position == chunk.length) {
+      this->chunks.pop_front();
+    }
+  }
+
+  this->queuedLength -= copied;
+
+  if (this->isAboveHighWaterMark && this->queuedLength <= this->lowWaterMark) {
+    this->isAboveHighWaterMark = false;
+    this->hasDrained = true;
+  }
+
+  return copied;
+}
+
+bool UploadQueue::TakeDrain() {
+  bool hasDrained = this->hasDrained;
+  this->hasDrained = false;
+
+  return hasDrained;
+}
+
+}  // namespace NodeLibcurl
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_UPLOADQUEUE_H
+#define NODELIBCURL_UPLOADQUEUE_H
+
+#include "ViewContents.h"
+
+#include <curl/curl.h>
+#include <nan.h>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+namespace NodeLibcurl {
+
+class Easy;
+
+// Data to be uploaded by an Easy handle that is pushed from js while the transfer is running
+// (set with setUploadQueue), usually coming from a Readable stream.
+// The chunks are served straight from their memory, and kept alive until they are fully sent.
+// When the queue is empty the transfer is paused, writing more data or ending it resumes it.
+// Writes return false once the queued data reaches the high watermark, the drain callback is
+// called after it goes back to the low watermark.
+class UploadQueue {
+  struct Chunk {
+    std::shared_ptr<ViewContents> contents;
+    size_t length;
+    size_t position;  // bytes already served
+  };
+
+  UploadQueue(const UploadQueue& that);
+  UploadQueue& operator=(const UploadQueue& that);
+
+  void Resume();
+
+  Easy* easy;
+  std::deque<Chunk> chunks;
+  size_t queuedLength = 0;
+  size_t highWaterMark;
+  size_t lowWaterMark;
+
+  bool isEnded = false;
+  bool isAborted = false;
+  bool isPaused = false;
+  bool isAboveHighWaterMark = false;  // a write returned false, and drain was not called yet
+  bool hasDrained = false;
+
+ public:
+  UploadQueue(Easy* easy, size_t highWaterMark, size_t lowWaterMark,
+              v8::Local<v8::Function> onDrain);
+
+  ~UploadQueue();
+
+  Nan::Callback onDrain;
+
+  // must be called before each transfer starts
+  void Prepare();
+
+  // view must be an ArrayBufferView, returns false if the queue is full
+  bool Write(v8::Local<v8::Value> view);
+  // no more data is coming, if isAborted is true the transfer fails
+  void End(bool isAborted);
+  bool IsEnded() const { return this->isEnded; }
+
+  // to be used by the READFUNCTION callback, the return value has the same meaning
+  size_t Read(char* ptr, size_t n, bool isAsync);
+  // returns true, only once, if the queue went back to the low watermark
+  bool TakeDrain();
+};
+}  // namespace NodeLibcurl
+#endif
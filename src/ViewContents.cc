@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "ViewContents.h"
+
+namespace NodeLibcurl {
+
+// libcurl treats some null pointers differently, like POSTFIELDS, so empty views get this
+static const char emptyData[] = "";
+
+ViewContents::ViewContents() : data(emptyData), length(0) {}
+
+std::shared_ptr<ViewContents> ViewContents::Create(v8::Local<v8::Value> value) {
+  v8::Local<v8::ArrayBufferView> view = value.As<v8::ArrayBufferView>();
+
+  std::shared_ptr<ViewContents> contents(new ViewContents());
+  contents->length = view->ByteLength();
+
+  if (contents->length == 0) {
+    return contents;
+  }
+
+#if V8_MAJOR_VERSION >= 8
+  // this also moves the contents of small typed arrays out of the v8 heap,
+  // so the address does not change while the data is being used.
+  contents->backingStore = view->Buffer()->GetBackingStore();
+  contents->data = static_cast<const char*>(contents->backingStore->Data()) + view->ByteOffset();
+#else
+  const char* data = node::Buffer::Data(value);
+  contents->copy.assign(data, data + contents->length);
+  contents->data = contents->copy.data();
+#endif
+
+  return contents;
+}
+
+}  // namespace NodeLibcurl
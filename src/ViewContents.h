@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#ifndef NODELIBCURL_VIEWCONTENTS_H
+#define NODELIBCURL_VIEWCONTENTS_H
+
+#include <nan.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace NodeLibcurl {
+
+// Memory of a Buffer / TypedArray / DataView that is read by libcurl after the js call that
+// passed it returns. It stays valid while this is alive, even if the ArrayBuffer is detached,
+// or transferred to another thread with postMessage, since the backing store is shared.
+// Before v8 8 the backing store cannot be shared, so the data is copied instead.
+class ViewContents {
+  ViewContents(const ViewContents& that);
+  ViewContents& operator=(const ViewContents& that);
+
+#if V8_MAJOR_VERSION >= 8
+  std::shared_ptr<v8::BackingStore> backingStore;
+#else
+  std::vector<char> copy;
+#endif
+
+ public:
+  ViewContents();
+
+  const char* data;
+  size_t length;
+
+  // value must be an ArrayBufferView
+  static std::shared_ptr<ViewContents> Create(v8::Local<v8::Value> value);
+};
+}  // namespace NodeLibcurl
+#endif
@@ -39,13 +39,20 @@
   (LIBCURL_VERSION_NUM >= NODE_LIBCURL_MAKE_VERSION(MAJ, MIN, PAT))
 
 #if !defined(NODE_LIBCURL_NO_SETLOCALE) && !defined(_WIN32)
-#define SETLOCALE_WRAPPER(code)                         \
-  std::string localeOriginal = setlocale(LC_ALL, NULL); \
-  bool hasLocaleChanged = false;                        \
-  if (localeOriginal == "C") {                          \
-    hasLocaleChanged = true;                            \
-    setlocale(LC_ALL, "");                              \
-  }                                                     \
+// setlocale changes the locale of the whole process and is not thread safe, so it's only
+// swapped on the main thread, otherwise transfers running at the same time on worker threads
+// could restore each other's locale in the middle of them. The files using this macro must
+// include IsolateData.h.
+#define SETLOCALE_WRAPPER(code)                                    \
+  std::string localeOriginal;                                      \
+  bool hasLocaleChanged = false;                                   \
+  if (NodeLibcurl::IsolateData::Current()->isMainThread) {         \
+    localeOriginal = setlocale(LC_ALL, NULL);                      \
+    if (localeOriginal == "C") {                                   \
+      hasLocaleChanged = true;                                     \
+      setlocale(LC_ALL, "");                                       \
+    }                                                              \
+  }                                                                \
   code if (hasLocaleChanged) { setlocale(LC_ALL, localeOriginal.c_str()); }
 #else
 #define SETLOCALE_WRAPPER(code) code
@@ -7,8 +7,12 @@
 #include "Curl.h"
 #include "CurlVersionInfo.h"
 #include "Easy.h"
+#include "HeaderList.h"
+#include "IsolateData.h"
 #include "Multi.h"
+#include "OptionTemplate.h"
 #include "Share.h"
+#include "ThreadedMulti.h"
 
 #include <curl/curl.h>
 #include <nan.h>
@@ -18,10 +22,11 @@
 
 namespace NodeLibcurl {
 
-static void AtExitCallback(void* arg) {
-  (void)arg;
+// each isolate calls globalInit when loading the addon, this balances it
+static void CleanupCallback(IsolateData* data) {
+  (void)data;
 
-  curl_global_cleanup();
+  CleanupGlobalState();
 }
 
 NAN_MODULE_INIT(Init) {
@@ -44,16 +49,24 @@ NAN_MODULE_INIT(Init) {
   // That code is behind a DEFINE guard, which the user can disable by passing
   //  `node_libcurl_no_setlocale` option when building, this will define
   //  NODE_LIBCURL_NO_SETLOCALE.
+  // Since setlocale is process wide and not thread safe, it's only called on the
+  //  main thread, transfers started by worker threads (and by ThreadedMulti) use
+  //  whatever locale the process has, so IDN hostnames may need the application
+  //  to set one.
   // https://docs.microsoft.com/en-us/cpp/c-runtime-library/reference/setlocale-wsetlocale?view=vs-2019
   // setlocale(AC_ALL, "")
+  IsolateData::Create(CleanupCallback);
+
   Initialize(target);
   Easy::Initialize(target);
   Multi::Initialize(target);
+  ThreadedMulti::Initialize(target);
   Share::Initialize(target);
+  OptionTemplate::Initialize(target);
+  HeaderList::Initialize(target);
   CurlVersionInfo::Initialize(target);
-
-  node::AtExit(AtExitCallback, NULL);
 }
 
-NODE_MODULE(node_libcurl, Init);
+// the addon can be loaded by worker threads, all its state is kept per isolate
+NAN_MODULE_WORKER_ENABLED(node_libcurl, Init)
 }  // namespace NodeLibcurl
@@ -6,6 +6,8 @@
  */
 import 'should'
 
+import { MessageChannel } from 'worker_threads'
+
 import { app, host, port, server } from '../helper/server'
 import { Curl } from '../../lib'
 
@@ -56,4 +58,71 @@ describe('Binary Data', () => {
 
     curl.perform()
   })
+
+  it('should upload a Buffer without converting it', done => {
+    const curl = new Curl()
+    curl.setOpt('URL', `http://${host}:${port}`)
+    curl.setOpt('POSTFIELDS', buffer)
+    curl.setOpt('HTTPHEADER', ['Content-Type: application/trusted-curl.raw'])
+
+    let isFirstRequest = true
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+
+      if (isFirstRequest) {
+        parseInt(data as string, 10).should.be.equal(size)
+
+        // the size of the Buffer must not be used for a string
+        isFirstRequest = false
+        curl.setOpt('POSTFIELDS', 'abc')
+        curl.perform()
+        return
+      }
+
+      curl.close()
+      parseInt(data as string, 10).should.be.equal(3)
+      done()
+    })
+
+    curl.on('error', error => {
+      curl.close()
+      done(error)
+    })
+
+    curl.perform()
+  })
+
+  it('should upload a Buffer whose ArrayBuffer was transferred', done => {
+    // with its own ArrayBuffer, so it can be transferred
+    const view = new Uint8Array(size)
+    view.set(buffer)
+
+    const curl = new Curl()
+    curl.setOpt('URL', `http://${host}:${port}`)
+    curl.setOpt('POSTFIELDS', view)
+    curl.setOpt('HTTPHEADER', ['Content-Type: application/trusted-curl.raw'])
+
+    // detaches the ArrayBuffer
+    const { port1, port2 } = new MessageChannel()
+    port1.postMessage(view.buffer, [view.buffer])
+    port1.close()
+    port2.close()
+
+    curl.on('end', (status, data) => {
+      curl.close()
+
+      status.should.be.equal(200)
+      parseInt(data as string, 10).should.be.equal(size)
+
+      done()
+    })
+
+    curl.on('error', error => {
+      curl.close()
+      done(error)
+    })
+
+    curl.perform()
+  })
 })
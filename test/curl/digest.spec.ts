@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import crypto from 'crypto'
+
+import { app, host, port, server } from '../helper/server'
+import { Curl, CurlFeature, EasyDigest } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const responseData = crypto.randomBytes(1024 * 1024 + 13)
+
+const crc32c = (data: Buffer) => {
+  let crc = 0xffffffff
+
+  for (const byte of data) {
+    crc ^= byte
+    for (let i = 0; i < 8; i++) {
+      crc = crc & 1 ? (crc >>> 1) ^ 0x82f63b78 : crc >>> 1
+    }
+  }
+
+  return ((crc ^ 0xffffffff) >>> 0).toString(16).padStart(8, '0')
+}
+
+const hash = (algorithm: string) =>
+  crypto
+    .createHash(algorithm)
+    .update(responseData)
+    .digest('hex')
+
+let curl: Curl
+
+describe('Digests', () => {
+  beforeEach(() => {
+    curl = new Curl()
+    curl.setOpt('URL', url)
+  })
+
+  afterEach(() => {
+    curl.close()
+  })
+
+  before(done => {
+    app.get('/', (_req, res) => {
+      res.send(responseData)
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    app._router.stack.pop()
+    server.close()
+  })
+
+  it('should compute the enabled digests of the body', done => {
+    curl.setDigests(
+      EasyDigest.Md5 | EasyDigest.Sha1 | EasyDigest.Sha256 | EasyDigest.Crc32c,
+    )
+
+    curl.on('end', () => {
+      curl.getDigest(EasyDigest.Md5).should.be.equal(hash('md5'))
+      curl.getDigest(EasyDigest.Sha1).should.be.equal(hash('sha1'))
+      curl.getDigest(EasyDigest.Sha256).should.be.equal(hash('sha256'))
+      curl.getDigest(EasyDigest.Crc32c).should.be.equal(crc32c(responseData))
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should compute digests when the data is stored natively', done => {
+    curl.enable(CurlFeature.NativeDataStorage | CurlFeature.NoDataParsing)
+    curl.setDigests(EasyDigest.Sha256)
+
+    curl.on('end', (_status, data) => {
+      ;(data as Buffer).equals(responseData).should.be.true()
+      curl.getDigest(EasyDigest.Sha256).should.be.equal(hash('sha256'))
+      ;(() => curl.getDigest(EasyDigest.Md5)).should.throw()
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+})
@@ -7,10 +7,21 @@
 import 'should'
 
 import { app, host, port, server } from '../helper/server'
-import { Curl, CurlFeature } from '../../lib'
+import { BufferPoolStats, Curl, CurlFeature, Easy, Multi } from '../../lib'
 
 const responseData = 'Ok'
 const responseLength = responseData.length
+const responseJson = {
+  id: 1,
+  name: 'caf\u00e9 \ud83d\ude00',
+  tags: ['a', 'b'],
+  nested: { value: -1.5e-3, isEnabled: true, parent: null },
+}
+
+// sent as separate chunks of a chunked response, which libcurl passes one by one
+// to the write callback, all of them are read from the socket at once.
+const chunkCount = 500
+const chunkData = 'chunk-data'
 
 const url = `http://${host}:${port}/`
 
@@ -36,11 +47,30 @@ describe('Features', () => {
       // @ts-ignore
       headerLength = res._header.length
     })
+
+    app.get('/json', (_req, res) => {
+      res.send(JSON.stringify(responseJson))
+    })
+
+    app.get('/chunked', (_req, res) => {
+      res.cork()
+
+      for (let i = 0; i < chunkCount; i++) {
+        res.write(chunkData)
+      }
+
+      process.nextTick(() => {
+        res.uncork()
+        res.end()
+      })
+    })
   })
 
   after(() => {
     server.close()
     app._router.stack.pop()
+    app._router.stack.pop()
+    app._router.stack.pop()
   })
 
   it('should not store data when NoDataStorage is set', done => {
@@ -89,6 +119,233 @@ describe('Features', () => {
     curl.perform()
   })
 
+  it('should store data natively when NativeDataStorage is set', done => {
+    curl.enable(CurlFeature.NativeDataStorage)
+
+    let dataEventsCount = 0
+
+    curl.on('data', () => {
+      dataEventsCount += 1
+    })
+
+    curl.on('end', (_status, data, headers) => {
+      dataEventsCount.should.be.equal(0)
+      data.should.be.equal(responseData)
+      headers.should.be.an.instanceOf(Array).and.have.property('length', 1)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should decode natively stored data as UTF-8 when NativeDataStorage is set', done => {
+    curl.setOpt('URL', `${url}json`)
+    curl.enable(CurlFeature.NativeDataStorage)
+
+    curl.on('end', (_status, data) => {
+      data.should.be.equal(JSON.stringify(responseJson))
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should pass the natively stored data as a Buffer when NoDataParsing is set', done => {
+    curl.enable(CurlFeature.NativeDataStorage | CurlFeature.NoDataParsing)
+
+    curl.on('end', (_status, data) => {
+      data.should.be.an.instanceOf(Buffer)
+      data.toString().should.be.equal(responseData)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should emit data and headers when BufferPooling is set', done => {
+    curl.enable(CurlFeature.BufferPooling)
+
+    let headersCount = 0
+
+    curl.on('header', chunk => {
+      chunk.should.be.an.instanceOf(Buffer)
+      headersCount += 1
+    })
+
+    curl.on('end', (_status, data, headers) => {
+      headersCount.should.be.above(0)
+      data.should.be.equal(responseData)
+      headers.should.be.an.instanceOf(Array).and.have.property('length', 1)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should reuse the pooled memory given back with releasePooledBuffer', done => {
+    const multi = new Multi()
+    const handle = new Easy()
+    let released: BufferPoolStats | null = null
+
+    const finish = (error?: Error) => {
+      handle.close()
+      multi.close()
+      done(error)
+    }
+
+    const release = (buffer: Buffer, size: number, nmemb: number) => {
+      Easy.releasePooledBuffer(buffer).should.be.true()
+      buffer.length.should.be.equal(0)
+
+      return size * nmemb
+    }
+
+    handle.setOpt('URL', url)
+    handle.setBufferPooling(true)
+    handle.setOpt('WRITEFUNCTION', release)
+    handle.setOpt('HEADERFUNCTION', release)
+
+    multi.onMessage(error => {
+      multi.removeHandle(handle)
+
+      if (error) {
+        finish(error)
+        return
+      }
+
+      // node gives the blocks back from a native immediate, which runs first
+      setImmediate(() => {
+        if (!released) {
+          released = Easy.getBufferPoolStats()
+          released.cachedBytes.should.be.above(0)
+
+          multi.addHandle(handle)
+          return
+        }
+
+        Easy.getBufferPoolStats().blocksReused.should.be.above(
+          released.blocksReused,
+        )
+        finish()
+      })
+    })
+
+    multi.addHandle(handle)
+  })
+
+  it('should emit the same data when CoalesceData is set', done => {
+    curl.enable(CurlFeature.CoalesceData)
+
+    let dataLength = 0
+
+    curl.on('data', chunk => {
+      dataLength += chunk.length
+    })
+
+    curl.on('end', (_status, data) => {
+      dataLength.should.be.equal(responseLength)
+      data.should.be.equal(responseData)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should call the data callback fewer times when CoalesceData is set', done => {
+    curl.setOpt('URL', `${url}chunked`)
+    curl.enable(CurlFeature.CoalesceData)
+
+    let dataEventsCount = 0
+    let dataLength = 0
+
+    curl.on('data', chunk => {
+      dataEventsCount += 1
+      dataLength += chunk.length
+    })
+
+    curl.on('end', () => {
+      dataLength.should.be.equal(chunkCount * chunkData.length)
+      dataEventsCount.should.be.above(0)
+      dataEventsCount.should.be.below(chunkCount)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should parse headers natively when NativeHeaderParsing is set', done => {
+    curl.enable(CurlFeature.NativeHeaderParsing)
+
+    let headerEventsCount = 0
+
+    curl.on('header', () => {
+      headerEventsCount += 1
+    })
+
+    curl.on('end', (_status, _data, headers) => {
+      headerEventsCount.should.be.equal(0)
+      headers.should.be.an.instanceOf(Array).and.have.property('length', 1)
+      headers[0].should.have
+        .property('result')
+        .which.match({ version: 'HTTP/1.1', code: 200, reason: 'OK' })
+      headers[0].should.have.property('Content-Length', `${responseLength}`)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should parse data as JSON natively when NativeJsonParsing is set', done => {
+    curl.setOpt('URL', `${url}json`)
+    curl.enable(CurlFeature.NativeJsonParsing)
+
+    let dataEventsCount = 0
+
+    curl.on('data', () => {
+      dataEventsCount += 1
+    })
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+      dataEventsCount.should.be.equal(0)
+      data.should.be.eql(responseJson)
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should emit an error when NativeJsonParsing is set and data is not JSON', done => {
+    curl.enable(CurlFeature.NativeJsonParsing)
+
+    curl.on('end', () => {
+      done(new Error('end event should not have been emitted'))
+    })
+
+    curl.on('error', error => {
+      error.should.be.an.instanceOf(SyntaxError)
+      done()
+    })
+
+    curl.perform()
+  })
+
   it('should not parse headers when NoHeaderParsing is set', done => {
     curl.enable(CurlFeature.NoHeaderParsing)
 
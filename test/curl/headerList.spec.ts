@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import { app, host, port, server } from '../helper/server'
+import { Curl, HeaderList } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const request = (headers: HeaderList) =>
+  new Promise<{ [key: string]: string }>((resolve, reject) => {
+    const curl = new Curl()
+    curl.setOpt('URL', url)
+    curl.setOpt('HTTPHEADER', headers)
+
+    curl.on('end', (_statusCode, data) => {
+      curl.close()
+      resolve(JSON.parse(data as string))
+    })
+
+    curl.on('error', error => {
+      curl.close()
+      reject(error)
+    })
+
+    curl.perform()
+  })
+
+describe('HeaderList', () => {
+  before(done => {
+    app.get('/', (req, res) => {
+      res.send(req.headers)
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+  })
+
+  it('should be shared by multiple handles', async () => {
+    const headers = new HeaderList(['X-First: 1', 'X-Second: 2'])
+
+    const results = await Promise.all([request(headers), request(headers)])
+
+    for (const result of results) {
+      result.should.have.properties({ 'x-first': '1', 'x-second': '2' })
+    }
+  })
+
+  it('should extend a list without changing it', async () => {
+    const headers = new HeaderList(['X-First: 1'])
+    const extended = headers.extend(['Authorization: Bearer abc'])
+
+    extended.should.be.instanceof(HeaderList)
+    extended
+      .toArray()
+      .should.be.eql(['Authorization: Bearer abc', 'X-First: 1'])
+    headers.toArray().should.be.eql(['X-First: 1'])
+
+    const result = await request(extended)
+
+    result.should.have.properties({
+      authorization: 'Bearer abc',
+      'x-first': '1',
+    })
+  })
+
+  it('should not accept lines that are not strings', () => {
+    // @ts-ignore
+    ;(() => new HeaderList([1])).should.throw(TypeError)
+  })
+})
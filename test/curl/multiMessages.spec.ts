@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import { app, host, port, server } from '../helper/server'
+import { CurlCode, Easy, EasyWriteMode, Multi } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const createHandle = (path = '') => {
+  const handle = new Easy()
+  handle.setOpt('URL', url + path)
+  handle.setOpt('FAILONERROR', true)
+  handle.setWriteMode(EasyWriteMode.Collect)
+
+  return handle
+}
+
+describe('Multi.onMessages', () => {
+  let multi: Multi
+
+  before(done => {
+    app.get('/', (_req, res) => {
+      res.send('Hello World!')
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+  })
+
+  beforeEach(() => {
+    multi = new Multi()
+  })
+
+  afterEach(() => {
+    multi.close()
+  })
+
+  it('should deliver the finished handles already removed', done => {
+    const handles = [createHandle(), createHandle(), createHandle()]
+    let finished = 0
+
+    multi.onMessage(() => {
+      done(new Error('onMessage should not be called.'))
+    })
+
+    multi.onMessages((easyHandles, errorCodes, errors) => {
+      try {
+        ;(errors === null).should.be.true()
+        errorCodes.should.be.instanceOf(Int32Array)
+        errorCodes.length.should.be.equal(easyHandles.length)
+
+        for (let i = 0; i < easyHandles.length; i++) {
+          errorCodes[i].should.be.equal(CurlCode.CURLE_OK)
+          easyHandles[i].isInsideMultiHandle.should.be.false()
+          easyHandles[i]
+            .takeCollectedData()
+            .toString()
+            .should.be.equal('Hello World!')
+
+          easyHandles[i].close()
+          finished += 1
+        }
+      } catch (error) {
+        done(error)
+        return
+      }
+
+      if (finished === handles.length) {
+        multi.getCount().should.be.equal(0)
+        done()
+      }
+    })
+
+    for (const handle of handles) {
+      multi.addHandle(handle)
+    }
+  })
+
+  it('should only create errors when a transfer fails', done => {
+    const handles = [createHandle(), createHandle('not-found')]
+    let finished = 0
+    let hasFailed = false
+
+    multi.onMessages((easyHandles, errorCodes, errors) => {
+      try {
+        for (let i = 0; i < easyHandles.length; i++) {
+          if (errorCodes[i] === CurlCode.CURLE_OK) {
+            if (errors) {
+              ;(errors[i] === null).should.be.true()
+            }
+          } else {
+            errorCodes[i].should.be.equal(CurlCode.CURLE_HTTP_RETURNED_ERROR)
+            errors![i]!.should.be.instanceOf(Error)
+            hasFailed = true
+          }
+
+          easyHandles[i].close()
+          finished += 1
+        }
+      } catch (error) {
+        done(error)
+        return
+      }
+
+      if (finished === handles.length) {
+        hasFailed.should.be.true()
+        done()
+      }
+    })
+
+    for (const handle of handles) {
+      multi.addHandle(handle)
+    }
+  })
+})
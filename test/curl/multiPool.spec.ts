@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import { app, host, port, server } from '../helper/server'
+import {
+  Curl,
+  CurlCode,
+  Easy,
+  EasyHeaderMode,
+  EasyWriteMode,
+  MultiPool,
+} from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const createHandle = () => {
+  const handle = new Easy()
+  handle.setOpt('URL', url)
+  handle.setWriteMode(EasyWriteMode.Collect)
+  handle.setHeaderMode(EasyHeaderMode.Parse)
+
+  return handle
+}
+
+describe('MultiPool', () => {
+  let pool: MultiPool
+
+  before(function(done) {
+    // ThreadedMulti
+    if (Curl.VERSION_NUM < 0x074400) {
+      this.skip()
+    }
+
+    app.get('/', (_req, res) => {
+      res.send('Hello World!')
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+  })
+
+  afterEach(() => {
+    pool.close()
+  })
+
+  it('should spread the transfers across the threads', done => {
+    pool = new MultiPool({ threads: 2 })
+
+    const handles = [createHandle(), createHandle(), createHandle()]
+    let finished = 0
+
+    pool.onMessage((error, handle, errorCode) => {
+      try {
+        ;(error === null).should.be.true()
+        errorCode.should.be.equal(CurlCode.CURLE_OK)
+        handle.takeCollectedData().toString().should.be.equal('Hello World!')
+
+        handle.close()
+      } catch (error) {
+        done(error)
+        return
+      }
+
+      if (++finished === handles.length) {
+        pool.getCount().should.be.equal(0)
+        done()
+      }
+    })
+
+    for (const handle of handles) {
+      pool.addHandle(handle)
+    }
+
+    pool.getCounts().should.be.eql([2, 1])
+  })
+
+  it('should use the same thread for the same host', done => {
+    pool = new MultiPool({ threads: 4, strategy: 'host' })
+
+    const handles = [createHandle(), createHandle(), createHandle()]
+    let finished = 0
+
+    pool.onMessage((_error, handle) => {
+      handle.close()
+
+      if (++finished === handles.length) {
+        done()
+      }
+    })
+
+    for (const handle of handles) {
+      pool.addHandle(handle, host)
+    }
+
+    pool
+      .getCounts()
+      .filter(count => count > 0)
+      .should.be.eql([handles.length])
+  })
+})
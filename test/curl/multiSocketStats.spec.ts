@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import { app, host, port, server } from '../helper/server'
+import { CurlCode, Easy, Multi } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+describe('Multi.getSocketStats', () => {
+  let multi: Multi
+
+  before(done => {
+    app.get('/', (_req, res) => {
+      res.send('Hello World!')
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+  })
+
+  beforeEach(() => {
+    multi = new Multi()
+  })
+
+  afterEach(() => {
+    multi.close()
+  })
+
+  it('should reuse the socket contexts', done => {
+    const transfers = 20
+    let finished = 0
+
+    const handle = new Easy()
+    handle.setOpt('URL', url)
+    // each transfer opens a new socket
+    handle.setOpt('FORBID_REUSE', true)
+    handle.setOpt('WRITEFUNCTION', (buf: Buffer) => buf.length)
+
+    multi.onMessages((easyHandles, errorCodes) => {
+      try {
+        errorCodes[0].should.be.equal(CurlCode.CURLE_OK)
+
+        if (++finished < transfers) {
+          // the socket contexts are returned after libuv closes them
+          setImmediate(() => multi.addHandle(easyHandles[0]))
+          return
+        }
+
+        const stats = multi.getSocketStats()
+
+        stats.socketContextsAcquired.should.be.greaterThanOrEqual(transfers)
+        stats.socketContextsAllocated.should.be.lessThan(transfers)
+        stats.pollStarts.should.be.greaterThan(0)
+        stats.pollStartsSkipped.should.be.greaterThanOrEqual(0)
+
+        handle.close()
+        done()
+      } catch (error) {
+        done(error)
+      }
+    })
+
+    multi.addHandle(handle)
+  })
+})
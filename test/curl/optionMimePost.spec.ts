@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import fs from 'fs'
+import path from 'path'
+import crypto from 'crypto'
+import { Readable } from 'stream'
+
+import multiparty from 'multiparty'
+
+import { app, host, port, server } from '../helper/server'
+import { Curl, CurlPause } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const fileSize = 256 * 1024
+const filePath = path.resolve(__dirname, 'upload-mime.test')
+const fileData = crypto.randomBytes(fileSize)
+
+const sha1 = (data: Buffer) =>
+  crypto
+    .createHash('sha1')
+    .update(data)
+    .digest('hex')
+
+let curl: Curl
+
+describe('Option MIMEPOST', () => {
+  beforeEach(() => {
+    curl = new Curl()
+    curl.setOpt('URL', url)
+  })
+
+  afterEach(() => {
+    curl.close()
+  })
+
+  before(done => {
+    server.listen(port, host, () => {
+      fs.writeFile(filePath, fileData, done)
+    })
+
+    app.post('/', (req, res) => {
+      const form = new multiparty.Form()
+      const response: { [key: string]: any } = {}
+
+      form.on('part', part => {
+        const chunks: Buffer[] = []
+
+        part.on('data', (chunk: Buffer) => chunks.push(chunk))
+        part.on('end', () => {
+          response[part.name] = {
+            hash: sha1(Buffer.concat(chunks)),
+            filename: part.filename,
+            type: part.headers['content-type'],
+          }
+        })
+      })
+
+      form.on('close', () => {
+        res.send(JSON.stringify(response))
+      })
+
+      form.parse(req)
+    })
+  })
+
+  after(done => {
+    server.close()
+    app._router.stack.pop()
+    fs.unlink(filePath, done)
+  })
+
+  it('should upload strings, buffers and files', done => {
+    const buffer = crypto.randomBytes(100 * 1024)
+
+    curl.setOpt('MIMEPOST', [
+      { name: 'string', data: 'some value' },
+      {
+        name: 'buffer',
+        data: new Uint8Array(buffer.buffer, buffer.byteOffset, buffer.length),
+        type: 'application/octet-stream',
+        filename: 'buffer.bin',
+      },
+      { name: 'file', file: filePath, type: 'image/png' },
+    ])
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+
+      const result = JSON.parse(data as string)
+
+      result.string.hash.should.be.equal(sha1(Buffer.from('some value')))
+      result.buffer.hash.should.be.equal(sha1(buffer))
+      result.buffer.filename.should.be.equal('buffer.bin')
+      result.file.hash.should.be.equal(sha1(fileData))
+      result.file.filename.should.be.equal(path.basename(filePath))
+      result.file.type.should.be.equal('image/png')
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should upload parts read from a callback', done => {
+    let position = 0
+
+    curl.setOpt('MIMEPOST', [
+      {
+        name: 'read',
+        size: fileData.length,
+        read: (buffer: Buffer) => {
+          const written = fileData.copy(buffer, 0, position)
+          position += written
+          return written
+        },
+      },
+    ])
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+
+      const result = JSON.parse(data as string)
+
+      result.read.hash.should.be.equal(sha1(fileData))
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should upload parts read from a stream', done => {
+    curl.setOpt('MIMEPOST', [
+      {
+        name: 'stream',
+        // small chunks, so the transfer is paused waiting for them
+        stream: fs.createReadStream(filePath, { highWaterMark: 16 * 1024 }),
+      },
+    ])
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+
+      const result = JSON.parse(data as string)
+
+      result.stream.hash.should.be.equal(sha1(fileData))
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should keep a receive pause while reading parts from a stream', done => {
+    const stream = new Readable({ read() {} })
+    let isResumed = false
+
+    curl.setOpt('MIMEPOST', [{ name: 'stream', stream }])
+
+    curl.on('end', (status, data) => {
+      isResumed.should.be.true()
+      status.should.be.equal(200)
+
+      const result = JSON.parse(data as string)
+
+      result.stream.hash.should.be.equal(sha1(fileData))
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+    curl.pause(CurlPause.Recv)
+
+    // each chunk resumes sending the form, the response must stay paused
+    const half = fileData.length / 2
+    setTimeout(() => stream.push(fileData.slice(0, half)), 50)
+    setTimeout(() => {
+      stream.push(fileData.slice(half))
+      stream.push(null)
+    }, 100)
+
+    setTimeout(() => {
+      isResumed = true
+      curl.pause(CurlPause.Cont)
+    }, 400)
+  })
+
+  it('should reuse the same form for multiple requests', done => {
+    curl.setOpt('MIMEPOST', [{ name: 'buffer', data: fileData }])
+
+    let requests = 0
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+
+      const result = JSON.parse(data as string)
+
+      result.buffer.hash.should.be.equal(sha1(fileData))
+
+      if (++requests === 2) {
+        done()
+      } else {
+        setImmediate(() => curl.perform())
+      }
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+})
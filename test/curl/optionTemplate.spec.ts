@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import { app, host, port, server } from '../helper/server'
+import { Curl, OptionTemplate } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+describe('OptionTemplate', () => {
+  before(done => {
+    app.post('/', (req, res) => {
+      let body = ''
+
+      req.on('data', chunk => {
+        body += chunk
+      })
+
+      req.on('end', () => {
+        res.send({
+          header: req.headers['x-template'],
+          body,
+        })
+      })
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+  })
+
+  it('should apply the same options to multiple handles', done => {
+    const template = new OptionTemplate({
+      url,
+      httpHeader: ['X-Template: yes'],
+      POSTFIELDS: 'a=b',
+      timeoutMs: 5000,
+    })
+
+    let remaining = 3
+
+    for (let i = 0; i < 3; i++) {
+      const curl = new Curl()
+      curl.applyTemplate(template)
+
+      curl.on('end', (statusCode, data) => {
+        curl.close()
+
+        statusCode.should.be.equal(200)
+        JSON.parse(data as string).should.be.eql({
+          header: 'yes',
+          body: 'a=b',
+        })
+
+        remaining -= 1
+
+        if (!remaining) {
+          done()
+        }
+      })
+
+      curl.on('error', error => {
+        curl.close()
+        done(error)
+      })
+
+      curl.perform()
+    }
+  })
+
+  it('should not use the size of a previous Buffer POSTFIELDS', done => {
+    const curl = new Curl()
+    curl.setOpt('POSTFIELDS', Buffer.alloc(64 * 1024, 'x'))
+    curl.applyTemplate(new OptionTemplate({ url, POSTFIELDS: 'a=b' }))
+
+    curl.on('end', (statusCode, data) => {
+      curl.close()
+
+      statusCode.should.be.equal(200)
+      JSON.parse(data as string).body.should.be.equal('a=b')
+
+      done()
+    })
+
+    curl.on('error', error => {
+      curl.close()
+      done(error)
+    })
+
+    curl.perform()
+  })
+
+  it('should keep working after the template is not referenced anymore', done => {
+    const curl = new Curl()
+    curl.applyTemplate(
+      new OptionTemplate([
+        ['URL', url],
+        ['HTTPHEADER', ['X-Template: kept']],
+        ['POSTFIELDS', ''],
+      ]),
+    )
+
+    curl.on('end', (_statusCode, data) => {
+      curl.close()
+      JSON.parse(data as string).header.should.be.equal('kept')
+      done()
+    })
+
+    curl.on('error', error => {
+      curl.close()
+      done(error)
+    })
+
+    curl.perform()
+  })
+
+  it('should not accept options that need per handle state', () => {
+    ;(() => new OptionTemplate({ WRITEFUNCTION: () => 0 })).should.throw(
+      /template/,
+    )
+    ;(() => new OptionTemplate({ URL: 1 })).should.throw(TypeError)
+  })
+})
@@ -9,16 +9,21 @@ import 'should'
 import path from 'path'
 import fs from 'fs'
 import crypto from 'crypto'
+import { Readable } from 'stream'
+import { MessageChannel } from 'worker_threads'
 
 import express from 'express'
 
 import { app, host, port, server } from '../helper/server'
-import { Curl } from '../../lib'
+import { Curl, CurlCode, CurlPause } from '../../lib'
 
 const url = `http://${host}:${port}`
 
 const fileSize = 10 * 1024 //10K
 const fileName = path.resolve(__dirname, 'upload.test')
+// big enough to be read ahead in multiple blocks
+const largeFileSize = 512 * 1024 //512K
+const largeFileName = path.resolve(__dirname, 'upload-large.test')
 
 let fileHash = ''
 let uploadLocation = ''
@@ -136,6 +141,194 @@ describe('Put Upload', () => {
     curl.perform()
   })
 
+  it('should upload a file read ahead in multiple blocks using put', done => {
+    fs.writeFileSync(largeFileName, crypto.randomBytes(largeFileSize))
+
+    const fd = fs.openSync(largeFileName, 'r')
+
+    const cleanup = () => {
+      fs.closeSync(fd)
+      fs.unlinkSync(largeFileName)
+    }
+
+    hashOfFile(largeFileName, (hashError, largeFileHash) => {
+      if (hashError) {
+        cleanup()
+        done(hashError)
+        return
+      }
+
+      curl.setOpt('UPLOAD', 1)
+      curl.setOpt('READDATA', fd)
+
+      curl.on('end', (statusCode, body) => {
+        cleanup()
+
+        statusCode.should.be.equal(200)
+        body.should.be.equal(largeFileHash)
+
+        done()
+      })
+
+      curl.on('error', error => {
+        cleanup()
+        done(error)
+      })
+
+      curl.perform()
+    })
+  })
+
+  it('should upload data correctly using an upload buffer', done => {
+    const data = fs.readFileSync(fileName)
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('INFILESIZE', data.length)
+    // split in multiple views, with an empty one in the middle
+    curl.setUploadBuffer([
+      data.slice(0, 1000),
+      new Uint8Array(0),
+      new Uint8Array(data.buffer, data.byteOffset + 1000, data.length - 1000),
+    ])
+
+    curl.on('end', (statusCode, body) => {
+      statusCode.should.be.equal(200)
+      body.should.be.equal(fileHash)
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should upload an upload buffer whose ArrayBuffer was transferred', done => {
+    const data = fs.readFileSync(fileName)
+    // with its own ArrayBuffer, so it can be transferred
+    const view = new Uint8Array(data.length)
+    view.set(data)
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('INFILESIZE', view.length)
+    curl.setUploadBuffer(view)
+
+    // detaches the ArrayBuffer
+    const { port1, port2 } = new MessageChannel()
+    port1.postMessage(view.buffer, [view.buffer])
+    port1.close()
+    port2.close()
+
+    view.length.should.be.equal(0)
+
+    curl.on('end', (statusCode, body) => {
+      statusCode.should.be.equal(200)
+      body.should.be.equal(fileHash)
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should upload data correctly using an upload file', done => {
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('INFILESIZE', fs.statSync(fileName).size)
+    curl.setUploadFile(fileName)
+
+    curl.on('end', (statusCode, body) => {
+      statusCode.should.be.equal(200)
+      body.should.be.equal(fileHash)
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should upload data correctly using an upload stream', done => {
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('INFILESIZE', fs.statSync(fileName).size)
+    // small enough for the backpressure to kick in
+    curl.setUploadStream(
+      fs.createReadStream(fileName, { highWaterMark: 16 * 1024 }),
+      32 * 1024,
+    )
+
+    curl.on('end', (statusCode, body) => {
+      statusCode.should.be.equal(200)
+      body.should.be.equal(fileHash)
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should keep a receive pause while the upload stream is written', done => {
+    const data = fs.readFileSync(fileName)
+    const stream = new Readable({ read() {} })
+    let isResumed = false
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setOpt('INFILESIZE', data.length)
+    curl.setUploadStream(stream)
+
+    curl.on('end', (statusCode, body) => {
+      isResumed.should.be.true()
+      statusCode.should.be.equal(200)
+      body.should.be.equal(fileHash)
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+    curl.pause(CurlPause.Recv)
+
+    // each chunk written unpauses the upload, the response must stay paused
+    const half = data.length / 2
+    setTimeout(() => stream.push(data.slice(0, half)), 50)
+    setTimeout(() => {
+      stream.push(data.slice(half))
+      stream.push(null)
+    }, 100)
+
+    setTimeout(() => {
+      isResumed = true
+      curl.pause(CurlPause.Cont)
+    }, 400)
+  })
+
+  it('should fail the upload if the upload stream emits an error', done => {
+    const stream = new Readable({ read() {} })
+
+    curl.setOpt('UPLOAD', 1)
+    curl.setUploadStream(stream)
+
+    curl.on('end', () => {
+      done(new Error('Request should have failed.'))
+    })
+
+    curl.on('error', (error, errorCode) => {
+      errorCode.should.be.equal(CurlCode.CURLE_ABORTED_BY_CALLBACK)
+
+      done()
+    })
+
+    curl.perform()
+
+    stream.push(Buffer.from('some data'))
+    setTimeout(() => stream.emit('error', new Error('Stream failed')), 100)
+  })
+
   it('should upload data correctly using READFUNCTION callback option', done => {
     const CURL_READFUNC_PAUSE = 0x10000001
     const CURL_READFUNC_ABORT = 0x10000000
@@ -118,6 +118,64 @@ describe('setOpt()', () => {
     curl.perform()
   })
 
+  describe('setOpts()', () => {
+    it('should set the options from an object', done => {
+      curl.setOpts({
+        followLocation: true,
+        CUSTOMREQUEST: 'GET',
+        TIMEOUT_MS: 5000,
+      })
+
+      curl.on('end', (statusCode, data) => {
+        statusCode.should.be.equal(200)
+        data.should.be.equal('Hello World!')
+        done()
+      })
+
+      curl.on('error', done)
+
+      curl.perform()
+    })
+
+    it('should set the options from an array, in order', done => {
+      curl.setOpts([
+        ['URL', 'http://invalid.localhost/'],
+        [Curl.option.URL, url],
+      ])
+
+      curl.on('end', statusCode => {
+        statusCode.should.be.equal(200)
+        done()
+      })
+
+      curl.on('error', done)
+
+      curl.perform()
+    })
+
+    it('should report the first option not set by libcurl', () => {
+      const options: any[] = [
+        ['VERBOSE', false],
+        ['INVALID_OPTION_NAME', 1],
+      ]
+
+      ;(() => {
+        curl.setOpts(options)
+      }).should.throw(/INVALID_OPTION_NAME/)
+    })
+
+    it('should not accept invalid argument type', () => {
+      ;(() => {
+        // @ts-ignore
+        curl.setOpts([['URL', 0]])
+      }).should.throw()
+      ;(() => {
+        // @ts-ignore
+        curl.setOpts([1])
+      }).should.throw(/pairs/)
+    })
+  })
+
   describe('HTTPPOST', () => {
     it('should not accept invalid arrays', () => {
       try {
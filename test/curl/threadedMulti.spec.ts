@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import { app, host, port, server } from '../helper/server'
+import {
+  Curl,
+  CurlCode,
+  Easy,
+  EasyHeaderMode,
+  EasyWriteMode,
+  ThreadedMulti,
+} from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const createHandle = (path = '') => {
+  const handle = new Easy()
+  handle.setOpt('URL', url + path)
+  handle.setWriteMode(EasyWriteMode.Collect)
+  handle.setHeaderMode(EasyHeaderMode.Parse)
+
+  return handle
+}
+
+describe('ThreadedMulti', () => {
+  let multi: ThreadedMulti
+
+  before(function(done) {
+    // curl_multi_poll / curl_multi_wakeup
+    if (Curl.VERSION_NUM < 0x074400) {
+      this.skip()
+    }
+
+    app.get('/', (_req, res) => {
+      res.send('Hello World!')
+    })
+
+    app.get('/delayed', (_req, res) => {
+      setTimeout(() => res.send('Delayed'), 1000)
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+    app._router.stack.pop()
+  })
+
+  beforeEach(() => {
+    multi = new ThreadedMulti()
+  })
+
+  afterEach(() => {
+    multi.close()
+  })
+
+  it('should run the transfers on its thread', done => {
+    const handles = [createHandle(), createHandle(), createHandle()]
+    let finished = 0
+
+    multi.onMessage((error, handle, errorCode) => {
+      try {
+        ;(error === null).should.be.true()
+        errorCode.should.be.equal(CurlCode.CURLE_OK)
+        handle.getInfo('RESPONSE_CODE').data!.should.be.equal(200)
+        handle.takeCollectedData().toString().should.be.equal('Hello World!')
+        handle.takeParsedHeaders().length.should.be.equal(1)
+        handle.isInsideMultiHandle.should.be.false()
+
+        handle.close()
+      } catch (error) {
+        done(error)
+        return
+      }
+
+      if (++finished === handles.length) {
+        multi.getCount().should.be.equal(0)
+        done()
+      }
+    })
+
+    for (const handle of handles) {
+      multi.addHandle(handle)
+    }
+
+    multi.getCount().should.be.equal(handles.length)
+  })
+
+  it('should not allow the handle to be used while it is on the thread', done => {
+    const handle = createHandle()
+
+    multi.onMessage(() => {
+      handle.close()
+      done()
+    })
+
+    multi.addHandle(handle)
+
+    handle.isInsideMultiHandle.should.be.true()
+    ;(() => handle.setOpt('URL', url)).should.throw(/ThreadedMulti/)
+    ;(() => handle.getInfo('RESPONSE_CODE')).should.throw(/ThreadedMulti/)
+  })
+
+  it('should not accept handles whose data goes through js', () => {
+    const handle = new Easy()
+    handle.setOpt('URL', url)
+
+    try {
+      ;(() => multi.addHandle(handle)).should.throw(/write mode/)
+
+      handle.setWriteMode(EasyWriteMode.Collect)
+      ;(() => multi.addHandle(handle)).should.throw(/header mode/)
+
+      handle.setHeaderMode(EasyHeaderMode.Parse)
+      handle.setOpt('XFERINFOFUNCTION', () => 0)
+      ;(() => multi.addHandle(handle)).should.throw(/callbacks/)
+    } finally {
+      handle.close()
+    }
+  })
+
+  it('should not call onMessage for the handles removed by close', done => {
+    const closingMulti = new ThreadedMulti()
+    const handle = createHandle('delayed')
+
+    closingMulti.onMessage(() => {
+      done(new Error('onMessage should not be called.'))
+    })
+
+    closingMulti.addHandle(handle)
+    closingMulti.close()
+
+    handle.isInsideMultiHandle.should.be.false()
+    handle.close()
+
+    setTimeout(done, 100)
+  })
+
+  it('should remove a handle without calling onMessage', done => {
+    const handle = createHandle('delayed')
+
+    multi.onMessage(() => {
+      done(new Error('onMessage should not be called.'))
+    })
+
+    multi.addHandle(handle)
+    multi.removeHandle(handle)
+
+    const waitRemoval = () => {
+      if (handle.isInsideMultiHandle) {
+        setTimeout(waitRemoval, 10)
+        return
+      }
+
+      multi.getCount().should.be.equal(0)
+      handle.close()
+      done()
+    }
+
+    waitRemoval()
+  })
+})
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import path from 'path'
+import { Worker } from 'worker_threads'
+
+import binary from 'node-pre-gyp'
+
+import { app, host, port, server } from '../helper/server'
+import { curly } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+const bindingPath = binary.find(
+  path.resolve(path.join(__dirname, './../../package.json')),
+)
+
+// runs a transfer with a Multi handle, using the event loop of the worker
+const workerCode = `
+const { parentPort, workerData } = require('worker_threads')
+
+const { Curl, Easy, Multi } = require(workerData.bindingPath)
+
+Curl.globalInit(3)
+
+const multi = new Multi()
+const easy = new Easy()
+const chunks = []
+
+easy.setOpt(Curl.option.URL, workerData.url)
+easy.setOpt(Curl.option.WRITEFUNCTION, chunk => {
+  chunks.push(Buffer.from(chunk))
+  return chunk.length
+})
+
+multi.onMessage((error, handle, errorCode) => {
+  const statusCode = handle.getInfo(Curl.info.RESPONSE_CODE).data
+
+  multi.removeHandle(handle)
+  handle.close()
+  multi.close()
+
+  parentPort.postMessage({
+    errorCode,
+    statusCode,
+    data: Buffer.concat(chunks).toString(),
+  })
+})
+
+multi.addHandle(easy)
+`
+
+const runWorker = () =>
+  new Promise<{ errorCode: number; statusCode: number; data: string }>(
+    (resolve, reject) => {
+      const worker = new Worker(workerCode, {
+        eval: true,
+        workerData: { bindingPath, url },
+      })
+
+      worker.once('message', resolve)
+      worker.once('error', reject)
+    },
+  )
+
+describe('worker_threads', () => {
+  before(done => {
+    app.get('/', (_req, res) => {
+      res.send('Hello World!')
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    server.close()
+    app._router.stack.pop()
+  })
+
+  it('should run transfers in multiple workers at the same time', async () => {
+    const results = await Promise.all([runWorker(), runWorker(), runWorker()])
+
+    for (const result of results) {
+      result.errorCode.should.be.equal(0)
+      result.statusCode.should.be.equal(200)
+      result.data.should.be.equal('Hello World!')
+    }
+  })
+
+  it('should keep working on the main thread after the workers exit', async () => {
+    await runWorker()
+
+    const { statusCode, data } = await curly.get(url)
+
+    statusCode.should.be.equal(200)
+    data.should.be.equal('Hello World!')
+  })
+})
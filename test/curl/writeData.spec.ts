@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import path from 'path'
+import fs from 'fs'
+import crypto from 'crypto'
+
+import { app, host, port, server } from '../helper/server'
+import { Curl, Easy, Multi } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+// big enough to pause the transfer while the writes catch up
+const responseData = crypto.randomBytes(4 * 1024 * 1024)
+const fileName = path.resolve(__dirname, 'download.test')
+
+let curl: Curl
+let fd: number
+
+describe('Option WRITEDATA', () => {
+  beforeEach(() => {
+    curl = new Curl()
+    curl.setOpt('URL', url)
+
+    fd = fs.openSync(fileName, 'w+')
+  })
+
+  afterEach(() => {
+    curl.close()
+
+    fs.closeSync(fd)
+    fs.unlinkSync(fileName)
+  })
+
+  before(done => {
+    app.get('/', (_req, res) => {
+      res.send(responseData)
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    app._router.stack.pop()
+    server.close()
+  })
+
+  it('should write the body to the file descriptor', done => {
+    let dataEventsCount = 0
+
+    curl.setOpt('WRITEDATA', fd)
+
+    curl.on('data', () => {
+      dataEventsCount += 1
+    })
+
+    curl.on('end', (status, data) => {
+      status.should.be.equal(200)
+      dataEventsCount.should.be.equal(0)
+      data.should.have.property('length', 0)
+
+      fs.readFileSync(fileName)
+        .equals(responseData)
+        .should.be.true()
+
+      done()
+    })
+
+    curl.on('error', done)
+
+    curl.perform()
+  })
+
+  it('should write the body starting at the given offset', done => {
+    const prefix = Buffer.from('prefix')
+    const multi = new Multi()
+    const easy = new Easy()
+
+    fs.writeSync(fd, prefix, 0, prefix.length, 0)
+
+    easy.setOpt('URL', url)
+    easy.setOpt('WRITEDATA', fd)
+    easy.setWriteDataOffset(prefix.length)
+
+    multi.onMessage((error, handle) => {
+      multi.removeHandle(handle)
+      handle.close()
+      multi.close()
+
+      if (error) {
+        done(error)
+        return
+      }
+
+      fs.readFileSync(fileName)
+        .equals(Buffer.concat([prefix, responseData]))
+        .should.be.true()
+
+      done()
+    })
+
+    multi.addHandle(easy)
+  })
+
+  it('should not call onMessage after the multi handle is closed', done => {
+    const multi = new Multi()
+    const easy = new Easy()
+
+    easy.setOpt('URL', url)
+    easy.setOpt('WRITEDATA', fd)
+
+    multi.onMessage(() => {
+      done(new Error('onMessage called after close'))
+    })
+
+    multi.addHandle(easy)
+
+    // writes to the file can still be running when it's closed
+    setTimeout(() => {
+      multi.close()
+
+      easy.isInsideMultiHandle.should.be.false()
+
+      setTimeout(() => {
+        easy.close()
+        done()
+      }, 200)
+    }, 20)
+  })
+})
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) Jonathan Cardoso Machado. All Rights Reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+import 'should'
+
+import crypto from 'crypto'
+import { Worker } from 'worker_threads'
+
+import { app, host, port, server } from '../helper/server'
+import { Easy, EasyWriteRingIndex, Multi } from '../../lib'
+
+const url = `http://${host}:${port}/`
+
+// a lot bigger than the ring, so the transfer is paused multiple times
+const responseData = crypto.randomBytes(2 * 1024 * 1024)
+const ringSize = 64 * 1024
+const headerSize = 16
+
+// reads everything from the ring until the transfer finishes
+const consumerCode = `
+const { parentPort, workerData } = require('worker_threads')
+
+const header = new Int32Array(workerData, 0, 4)
+const ring = new Uint8Array(workerData, 16)
+const chunks = []
+
+for (;;) {
+  const head = Atomics.load(header, 0)
+  const tail = Atomics.load(header, 1)
+  const used = (head - tail) >>> 0
+
+  if (used === 0) {
+    if (Atomics.load(header, 2) !== 0) break
+
+    Atomics.store(header, 3, 1)
+    if (Atomics.load(header, 0) === head && Atomics.load(header, 2) === 0) {
+      Atomics.wait(header, 0, head, 100)
+    }
+    Atomics.store(header, 3, 0)
+    continue
+  }
+
+  const position = tail & (ring.length - 1)
+  const first = Math.min(used, ring.length - position)
+
+  chunks.push(Buffer.from(ring.slice(position, position + first)))
+  chunks.push(Buffer.from(ring.slice(0, used - first)))
+
+  Atomics.store(header, 1, (tail + used) | 0)
+}
+
+parentPort.postMessage(Buffer.concat(chunks))
+`
+
+// never reads anything, waits without a timeout until the transfer stops, reporting its state
+const waiterCode = `
+const { parentPort, workerData } = require('worker_threads')
+
+const header = new Int32Array(workerData, 0, 4)
+
+parentPort.postMessage('waiting')
+
+for (;;) {
+  const head = Atomics.load(header, 0)
+
+  Atomics.store(header, 3, 1)
+  if (Atomics.load(header, 2) !== 0) break
+  Atomics.wait(header, 0, head)
+  Atomics.store(header, 3, 0)
+}
+
+parentPort.postMessage(Atomics.load(header, 2))
+`
+
+let multi: Multi
+let easy: Easy
+
+describe('Easy.setWriteRing', () => {
+  beforeEach(() => {
+    multi = new Multi()
+    easy = new Easy()
+    easy.setOpt('URL', url)
+  })
+
+  afterEach(() => {
+    easy.close()
+    multi.close()
+  })
+
+  before(done => {
+    app.get('/', (_req, res) => {
+      res.send(responseData)
+    })
+
+    server.listen(port, host, done)
+  })
+
+  after(() => {
+    app._router.stack.pop()
+    server.close()
+  })
+
+  it('should not accept a ring with an invalid size', () => {
+    ;(() => {
+      easy.setWriteRing(new SharedArrayBuffer(headerSize + 1000))
+    }).should.throw()
+    ;(() => {
+      easy.setWriteRing(new SharedArrayBuffer(headerSize))
+    }).should.throw()
+  })
+
+  it('should write the body to the ring while it is consumed on the same thread', done => {
+    const sharedArrayBuffer = new SharedArrayBuffer(headerSize + ringSize)
+    const header = new Int32Array(sharedArrayBuffer, 0, 4)
+    const ring = Buffer.from(sharedArrayBuffer, headerSize)
+    const chunks: Buffer[] = []
+
+    const consume = () => {
+      const head = Atomics.load(header, EasyWriteRingIndex.Head)
+      const tail = Atomics.load(header, EasyWriteRingIndex.Tail)
+      const used = (head - tail) >>> 0
+      const position = tail & (ringSize - 1)
+      const first = Math.min(used, ringSize - position)
+
+      chunks.push(Buffer.from(ring.slice(position, position + first)))
+      chunks.push(Buffer.from(ring.slice(0, used - first)))
+
+      Atomics.store(header, EasyWriteRingIndex.Tail, (tail + used) | 0)
+      easy.writeRingConsumed()
+    }
+
+    const interval = setInterval(consume, 1)
+
+    easy.setWriteRing(sharedArrayBuffer)
+
+    multi.onMessage((error, handle) => {
+      clearInterval(interval)
+      multi.removeHandle(handle)
+
+      if (error) {
+        done(error)
+        return
+      }
+
+      consume()
+
+      Atomics.load(header, EasyWriteRingIndex.State).should.be.equal(1)
+      Buffer.concat(chunks)
+        .equals(responseData)
+        .should.be.true()
+
+      done()
+    })
+
+    multi.addHandle(easy)
+  })
+
+  it('should write the body to the ring while it is consumed by a worker', done => {
+    const sharedArrayBuffer = new SharedArrayBuffer(headerSize + ringSize)
+    let isTransferDone = false
+    let result: Buffer | null = null
+
+    const finish = () => {
+      if (!isTransferDone || !result) return
+
+      result.equals(responseData).should.be.true()
+      done()
+    }
+
+    const worker = new Worker(consumerCode, {
+      eval: true,
+      workerData: sharedArrayBuffer,
+    })
+
+    worker.on('message', (data: Uint8Array) => {
+      result = Buffer.from(data)
+      finish()
+    })
+    worker.on('error', done)
+
+    easy.setWriteRing(sharedArrayBuffer)
+
+    multi.onMessage((error, handle) => {
+      multi.removeHandle(handle)
+
+      if (error) {
+        worker.terminate()
+        done(error)
+        return
+      }
+
+      isTransferDone = true
+      finish()
+    })
+
+    multi.addHandle(easy)
+  })
+
+  const stopWithWaitingConsumer = (
+    stop: () => void,
+    done: (error?: Error) => void,
+  ) => {
+    const sharedArrayBuffer = new SharedArrayBuffer(headerSize + ringSize)
+
+    const worker = new Worker(waiterCode, {
+      eval: true,
+      workerData: sharedArrayBuffer,
+    })
+
+    worker.on('message', (message: string | number) => {
+      // the ring is full and the transfer paused by then
+      if (message === 'waiting') {
+        setTimeout(stop, 100)
+        return
+      }
+
+      message.should.be.equal(2)
+      done()
+    })
+    worker.on('error', done)
+
+    easy.setWriteRing(sharedArrayBuffer)
+
+    multi.onMessage(() => {
+      done(new Error('The transfer should not have finished.'))
+    })
+
+    multi.addHandle(easy)
+  }
+
+  it('should notify a waiting consumer when the handle is removed mid-transfer', done => {
+    stopWithWaitingConsumer(() => multi.removeHandle(easy), done)
+  })
+
+  it('should notify a waiting consumer when the handle is closed mid-transfer', done => {
+    stopWithWaitingConsumer(() => {
+      easy.close()
+      // closed by afterEach
+      easy = new Easy()
+    }, done)
+  })
+})